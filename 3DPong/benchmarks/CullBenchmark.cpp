@@ -0,0 +1,86 @@
+//culls 1M bounding spheres with the CPU frustum cull and reports how long it takes
+
+#include <3DPong/Renderer/FrustumCulling.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <random>
+
+//how many spheres to cull and how many times
+static constexpr size_t BENCHMARK_SPHERE_COUNT = 1000000;
+static constexpr size_t BENCHMARK_ITERATIONS = 100;
+
+//extracts the frustum planes the same way the renderer does
+static void GenerateFrustumPlanes(const glm::mat4& m, glm::vec4* planes)
+{
+	const glm::vec4 row0 = { m[0][0], m[1][0], m[2][0], m[3][0] };
+	const glm::vec4 row1 = { m[0][1], m[1][1], m[2][1], m[3][1] };
+	const glm::vec4 row2 = { m[0][2], m[1][2], m[2][2], m[3][2] };
+	const glm::vec4 row3 = { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+	planes[0] = row3 + row0; planes[1] = row3 - row0;
+	planes[2] = row3 + row1; planes[3] = row3 - row1;
+	planes[4] = row2; planes[5] = row3 - row2;
+	for (size_t i = 0; i < 6; ++i)
+		planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+//entry point
+int main()
+{
+#if defined(PONG3D_CULLING_AVX)
+	fmt::print("Culling path: AVX (8 spheres at a time)\n");
+#elif defined(PONG3D_CULLING_SSE)
+	fmt::print("Culling path: SSE (4 spheres at a time)\n");
+#else
+	fmt::print("Culling path: scalar\n");
+#endif
+
+	//spheres scattered around the camera
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f), radius(0.5f, 5.0f);
+	Pong3D::Renderer::BoundingSphereSoA spheres;
+	spheres.Resize(BENCHMARK_SPHERE_COUNT);
+	for (size_t i = 0; i < BENCHMARK_SPHERE_COUNT; ++i)
+		spheres.Set(i, glm::vec3(position(random), position(random), position(random)), radius(random));
+	std::vector<uint8_t> visibility(BENCHMARK_SPHERE_COUNT);
+
+	//a camera at the origin looking down +Z
+	const glm::vec3 cameraPosition = glm::vec3(0.0f);
+	const glm::mat4 projectionView = glm::perspective(glm::radians(70.0f), 1700.0f / 900.0f, 0.1f, 200.0f) *
+		glm::lookAt(cameraPosition, glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::vec4 planes[6];
+	GenerateFrustumPlanes(projectionView, planes);
+
+	Pong3D::Renderer::CullSettings settings;
+	settings.frustumPlanes = planes;
+	settings.cameraPosition = cameraPosition;
+	settings.maxDistance = 150.0f;
+
+	//checks the SIMD path against the scalar one before timing it
+	size_t visibleCount = Pong3D::Renderer::CullSpheres(settings, spheres, visibility.data());
+	for (size_t i = 0; i < BENCHMARK_SPHERE_COUNT; ++i)
+	{
+		const bool isVisible = Pong3D::Renderer::CullSphere_Scalar(settings, spheres.x[i], spheres.y[i], spheres.z[i], spheres.radius[i]);
+		if (isVisible != (visibility[i] != 0))
+		{
+			fmt::print("Sphere {} does not match the scalar cull!\n", i);
+			return -1;
+		}
+	}
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+		visibleCount = Pong3D::Renderer::CullSpheres(settings, spheres, visibility.data());
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	const double totalMS = std::chrono::duration<double, std::milli>(end - start).count();
+	fmt::print("{} spheres, {} visible, {} culled\n", BENCHMARK_SPHERE_COUNT, visibleCount, BENCHMARK_SPHERE_COUNT - visibleCount);
+	fmt::print("{:.3f} ms per cull ({:.2f} ns per sphere)\n", totalMS / BENCHMARK_ITERATIONS, (totalMS * 1000000.0) / (BENCHMARK_ITERATIONS * BENCHMARK_SPHERE_COUNT));
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+//walks 100k renderable entities through the ECS query and through the renderable archetype and reports how long each takes
+//both do the work of the render gather (read the transform and mesh) and the transform sync (generate the model matrix)
+
+#include <3DPong/ECS/Archetype.hpp>
+
+#include <BTDSTD/ECS/ECSManager.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <vector>
+
+//how many entities to walk and how many times
+static constexpr size_t BENCHMARK_ENTITY_COUNT = 100000;
+static constexpr size_t BENCHMARK_ITERATIONS = 20;
+
+//defines what a walk produced, so the work isn't optimized out and both paths can be checked against each other
+struct WalkResult
+{
+	double positionSum = 0.0;
+	uint64_t meshIDSum = 0;
+	double matrixSum = 0.0;
+};
+
+//walks the entities through the ECS, a query for the IDs then a lookup per component per entity
+static WalkResult Walk_ECSQuery(bool generateMatrices)
+{
+	WalkResult result;
+	auto entities = BTD::ECS::queryEntities<Smok::ECS::Comp::Transform, Smok::ECS::Comp::MeshRender>();
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		Smok::ECS::Comp::Transform transform = *BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(entities[i]);
+		const Smok::ECS::Comp::MeshRender meshRender = *BTD::ECS::getComponent<Smok::ECS::Comp::MeshRender>(entities[i]);
+
+		result.positionSum += transform.position.x + transform.position.y + transform.position.z;
+		result.meshIDSum += meshRender.staticMeshID;
+		if (generateMatrices)
+			result.matrixSum += transform.ModelMatrix()[3][0];
+	}
+
+	return result;
+}
+
+//walks the entities through the archetype's chunks
+static WalkResult Walk_Archetype(const Pong3D::ECS::RenderableArchetype& archetype, bool generateMatrices)
+{
+	WalkResult result;
+	for (size_t c = 0; c < archetype.chunksInUse; ++c)
+	{
+		const Pong3D::ECS::RenderableChunk* chunk = archetype.chunks[c].get();
+		for (uint32_t i = 0; i < chunk->count; ++i)
+		{
+			result.positionSum += chunk->positions[i].x + chunk->positions[i].y + chunk->positions[i].z;
+			result.meshIDSum += chunk->staticMeshIDs[i];
+			if (generateMatrices)
+				result.matrixSum += chunk->ModelMatrix(i)[3][0];
+		}
+	}
+
+	return result;
+}
+
+//times a walk, returns the milliseconds per walk
+template<typename Walk>
+static double TimeWalk(Walk walk, WalkResult& result)
+{
+	result = walk(); //warms the caches
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+		result = walk();
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count() / BENCHMARK_ITERATIONS;
+}
+
+//entry point
+int main()
+{
+	//the same entities in both, a grid like the game's benchmark scene
+	Pong3D::ECS::EntityPool entityPool;
+	Pong3D::ECS::RenderableArchetype archetype;
+	Smok::ECS::Comp::Transform transform;
+	Smok::ECS::Comp::MeshRender meshRender;
+	for (size_t i = 0; i < BENCHMARK_ENTITY_COUNT; ++i)
+	{
+		transform.position = { (float)(i % 100) * 3.0f - 150.0f, (float)((i / 100) % 100) * 3.0f - 150.0f, 20.0f + (float)(i / 10000) * 5.0f };
+		meshRender.staticMeshID = i % 4;
+
+		const uint64_t ID = entityPool.Create(Pong3D::ECS::EntityFlag::Paddle).ID;
+		BTD::ECS::addComponent(ID, transform);
+		BTD::ECS::addComponent(ID, meshRender);
+		archetype.Add(ID, transform, meshRender);
+	}
+
+	const char* walkNames[2] = { "Gather", "Gather + Model Matrix" };
+	for (size_t w = 0; w < 2; ++w)
+	{
+		const bool generateMatrices = (w == 1);
+		WalkResult queryResult, archetypeResult;
+		const double queryMS = TimeWalk([&]() { return Walk_ECSQuery(generateMatrices); }, queryResult);
+		const double archetypeMS = TimeWalk([&]() { return Walk_Archetype(archetype, generateMatrices); }, archetypeResult);
+
+		//both walks have to see the same entities
+		if (queryResult.meshIDSum != archetypeResult.meshIDSum)
+		{
+			fmt::print("{}: the archetype does not match the ECS query!\n", walkNames[w]);
+			return -1;
+		}
+
+		fmt::print("{} ({} entities)\n", walkNames[w], BENCHMARK_ENTITY_COUNT);
+		fmt::print("    ECS Query: {:.3f} ms per walk ({:.2f} ns per entity)\n", queryMS, (queryMS * 1000000.0) / BENCHMARK_ENTITY_COUNT);
+		fmt::print("    Archetype: {:.3f} ms per walk ({:.2f} ns per entity)\n", archetypeMS, (archetypeMS * 1000000.0) / BENCHMARK_ENTITY_COUNT);
+		fmt::print("    Speedup: {:.2f}x\n", (archetypeMS > 0.0 ? queryMS / archetypeMS : 0.0));
+	}
+
+	return 0;
+}
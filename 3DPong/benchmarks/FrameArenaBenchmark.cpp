@@ -0,0 +1,137 @@
+//runs the renderer's per frame scratch work (the draw list sort, the cull's visibility and the worker stats) with heap vectors and with the frame arena
+//reports how long each takes and how much the arena grew. The heap allocations of the real frame path are counted by RenderBenchmark
+
+#include <3DPong/Memory/FrameArena.hpp>
+#include <3DPong/Renderer/FrustumCulling.hpp>
+#include <3DPong/Renderer/RenderSortKey.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <random>
+
+//how many draws a frame has and how many frames to run
+static constexpr size_t BENCHMARK_DRAW_COUNT = 100000;
+static constexpr size_t BENCHMARK_FRAMES = 200;
+static constexpr size_t BENCHMARK_WARMUP_FRAMES = 4; //the arenas grow to fit in these
+static constexpr uint32_t BENCHMARK_FRAMES_IN_FLIGHT = 2;
+static constexpr size_t BENCHMARK_WORKER_COUNT = 8;
+
+//defines the stats a worker records, the same size as the renderer's
+struct WorkerStats
+{
+	uint64_t drawCalls = 0, pipelineBinds = 0, vertexBufferBinds = 0, indexBufferBinds = 0;
+};
+
+//the scene every frame works on
+struct BenchmarkScene
+{
+	std::vector<Pong3D::Renderer::SortedDrawItem> drawList;
+	Pong3D::Renderer::BoundingSphereSoA spheres;
+	glm::vec4 frustumPlanes[6];
+	uint64_t checksum = 0; //keeps the work from being optimized out
+};
+
+//a frame using vectors that are made and freed every frame
+static void RunFrame_Heap(BenchmarkScene& scene)
+{
+	std::vector<Pong3D::Renderer::SortedDrawItem> scratch(scene.drawList.size());
+	Pong3D::Renderer::RadixSort_DrawItems(scene.drawList, scratch.data());
+
+	Pong3D::Renderer::CullSettings settings;
+	settings.frustumPlanes = scene.frustumPlanes;
+	std::vector<uint8_t> visibility(scene.spheres.Size());
+	scene.checksum += Pong3D::Renderer::CullSpheres(settings, scene.spheres, visibility.data());
+
+	std::vector<WorkerStats> workerStats(BENCHMARK_WORKER_COUNT);
+	for (size_t w = 0; w < workerStats.size(); ++w)
+		scene.checksum += (workerStats[w].drawCalls += w);
+}
+
+//the same frame with its scratch data in the frame arena
+static void RunFrame_Arena(BenchmarkScene& scene, Pong3D::Memory::FrameArena& arena)
+{
+	arena.Reset();
+
+	Pong3D::Renderer::RadixSort_DrawItems(scene.drawList, arena.AllocateArray<Pong3D::Renderer::SortedDrawItem>(scene.drawList.size()));
+
+	Pong3D::Renderer::CullSettings settings;
+	settings.frustumPlanes = scene.frustumPlanes;
+	uint8_t* visibility = arena.AllocateArray<uint8_t>(scene.spheres.Size());
+	scene.checksum += Pong3D::Renderer::CullSpheres(settings, scene.spheres, visibility);
+
+	Pong3D::Memory::FrameVector<WorkerStats> workerStats = Pong3D::Memory::FrameVector_Create<WorkerStats>(&arena);
+	workerStats.resize(BENCHMARK_WORKER_COUNT);
+	for (size_t w = 0; w < workerStats.size(); ++w)
+		scene.checksum += (workerStats[w].drawCalls += w);
+}
+
+//entry point
+int main()
+{
+	BenchmarkScene scene;
+	std::mt19937 random(7);
+	std::uniform_int_distribution<uint64_t> key;
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+	scene.drawList.resize(BENCHMARK_DRAW_COUNT);
+	scene.spheres.Resize(BENCHMARK_DRAW_COUNT);
+	for (size_t i = 0; i < BENCHMARK_DRAW_COUNT; ++i)
+	{
+		scene.drawList[i].key = key(random);
+		scene.drawList[i].drawIndex = (uint32_t)i;
+		scene.spheres.Set(i, glm::vec3(position(random), position(random), position(random)), 1.0f);
+	}
+
+	//a box frustum around the middle of the scene
+	scene.frustumPlanes[0] = glm::vec4(1.0f, 0.0f, 0.0f, 50.0f); scene.frustumPlanes[1] = glm::vec4(-1.0f, 0.0f, 0.0f, 50.0f);
+	scene.frustumPlanes[2] = glm::vec4(0.0f, 1.0f, 0.0f, 50.0f); scene.frustumPlanes[3] = glm::vec4(0.0f, -1.0f, 0.0f, 50.0f);
+	scene.frustumPlanes[4] = glm::vec4(0.0f, 0.0f, 1.0f, 50.0f); scene.frustumPlanes[5] = glm::vec4(0.0f, 0.0f, -1.0f, 50.0f);
+
+	//heap
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t f = 0; f < BENCHMARK_FRAMES; ++f)
+		RunFrame_Heap(scene);
+	const double heapMS = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / BENCHMARK_FRAMES;
+
+	//arena, one per frame in flight like the render manager. Small to start with so the growing is tested
+	Pong3D::Memory::FrameArena arenas[BENCHMARK_FRAMES_IN_FLIGHT];
+	for (uint32_t i = 0; i < BENCHMARK_FRAMES_IN_FLIGHT; ++i)
+		arenas[i].Create(64 * 1024);
+
+	uint64_t warmupGrowCount = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t f = 0; f < BENCHMARK_WARMUP_FRAMES + BENCHMARK_FRAMES; ++f)
+	{
+		if (f == BENCHMARK_WARMUP_FRAMES)
+		{
+			start = std::chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < BENCHMARK_FRAMES_IN_FLIGHT; ++i)
+				warmupGrowCount += arenas[i].stats.growCount;
+		}
+
+		RunFrame_Arena(scene, arenas[f % BENCHMARK_FRAMES_IN_FLIGHT]);
+	}
+	const double arenaMS = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / BENCHMARK_FRAMES;
+
+	fmt::print("{} draws, {} frames\n", BENCHMARK_DRAW_COUNT, BENCHMARK_FRAMES);
+	uint64_t growCount = 0;
+	for (uint32_t i = 0; i < BENCHMARK_FRAMES_IN_FLIGHT; ++i)
+		growCount += arenas[i].stats.growCount;
+
+	fmt::print("Heap: {:.3f} ms per frame\n", heapMS);
+	fmt::print("Arena: {:.3f} ms per frame ({} bytes a frame, grown {} times while warming up, {} after)\n", arenaMS,
+		arenas[0].stats.highWaterBytes, warmupGrowCount, growCount - warmupGrowCount);
+	fmt::print("Checksum: {}\n", scene.checksum);
+
+	for (uint32_t i = 0; i < BENCHMARK_FRAMES_IN_FLIGHT; ++i)
+		arenas[i].Destroy();
+
+	if (growCount > warmupGrowCount)
+	{
+		fmt::print("The arenas grew after warming up!\n");
+		return -1;
+	}
+
+	return 0;
+}
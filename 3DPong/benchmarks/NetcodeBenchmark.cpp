@@ -0,0 +1,179 @@
+//plays two rollback sessions against each other on loopback through a bad connection and checks they end on the same world
+//then times saving and loading the world and simulating 8 ticks again, the rollback has to fit in a frame
+
+#include <3DPong/Network/RollbackSession.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <random>
+
+//the loopback game
+static constexpr uint32_t LOOPBACK_TICKS = 3000;
+static constexpr uint32_t LOOPBACK_BALL_COUNT = 64;
+static constexpr float LOOPBACK_LATENCY_MS = 50.0f;
+static constexpr float LOOPBACK_JITTER_MS = 15.0f;
+static constexpr float LOOPBACK_LOSS_PERCENT = 10.0f;
+
+//the rollback timing
+static constexpr size_t BENCHMARK_BALL_COUNTS[] = { 1, 1000, 10000, 100000 };
+static constexpr uint32_t BENCHMARK_ROLLBACK_TICKS = 8;
+static constexpr size_t BENCHMARK_ITERATIONS = 50;
+static constexpr float BENCHMARK_FRAME_MS = 1000.0f / 60.0f;
+static constexpr float BENCHMARK_STEP_TIME = 1.0f / 60.0f;
+
+//makes the same world on both peers
+static void CreateWorld(Pong3D::Physics::PhysicsWorld& world, size_t ballCount)
+{
+	world.Create();
+	world.paddles.Add(0, glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 1.0f, 0.25f));
+	world.paddles.Add(1, glm::vec3(0.0f, 0.0f, 13.0f), glm::vec3(1.0f, 1.0f, 0.25f));
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> x(-9.0f, 9.0f), y(-7.0f, 7.0f), z(1.0f, 13.0f), velocity(-8.0f, 8.0f);
+	world.balls.Reserve(ballCount);
+	for (size_t i = 0; i < ballCount; ++i)
+		world.balls.Add(i + 2, glm::vec3(x(random), y(random), z(random)), glm::vec3(velocity(random), velocity(random), velocity(random)), 0.5f);
+}
+
+//the scripted input of a player, each holds a direction for a while then changes
+static float GetScriptedDirection(uint32_t player, uint32_t tick)
+{
+	return (float)((tick / (23 + player * 14) + player) % 3) - 1.0f;
+}
+
+//sends and receives without simulating, rolling back if a late input needs it
+static void Pump(Pong3D::Network::RollbackSession& session, Pong3D::Physics::PhysicsWorld& world, double nowMS)
+{
+	session.conditioner.Flush(nowMS);
+	session.ReceivePackets();
+	if (session.rollbackFromTick < session.currentTick)
+		session.Rollback(world);
+	session.SendInputs(nowMS);
+}
+
+//plays the loopback game, returns false if the peers don't agree at the end
+static bool RunLoopback()
+{
+	Pong3D::Physics::PhysicsWorld worlds[2];
+	Pong3D::Network::RollbackSession sessions[2];
+	for (uint32_t p = 0; p < 2; ++p)
+	{
+		CreateWorld(worlds[p], LOOPBACK_BALL_COUNT);
+
+		Pong3D::Network::RollbackSession_CreateInfo info;
+		info.localPlayer = p;
+		info.fixedDeltaTime = BENCHMARK_STEP_TIME;
+		info.conditioner.latencyMS = LOOPBACK_LATENCY_MS;
+		info.conditioner.jitterMS = LOOPBACK_JITTER_MS;
+		info.conditioner.lossPercent = LOOPBACK_LOSS_PERCENT;
+		info.conditioner.seed = 100 + p;
+		if (!sessions[p].Create(info))
+			return false;
+		sessions[p].ReserveStates(worlds[p]);
+	}
+
+	//the OS picked the ports, each peer is pointed at the other
+	sessions[0].remoteAddress = Pong3D::Network::NetAddress::FromString("127.0.0.1", sessions[1].socket.port);
+	sessions[1].remoteAddress = Pong3D::Network::NetAddress::FromString("127.0.0.1", sessions[0].socket.port);
+
+	//a tick of time passes each iteration, the conditioner runs on this clock rather than the real one so the run is the same every time
+	uint32_t iteration = 0;
+	while (sessions[0].currentTick < LOOPBACK_TICKS || sessions[1].currentTick < LOOPBACK_TICKS)
+	{
+		const double nowMS = iteration * (double)BENCHMARK_FRAME_MS;
+		for (uint32_t p = 0; p < 2; ++p)
+		{
+			if (sessions[p].currentTick < LOOPBACK_TICKS)
+				sessions[p].AdvanceTick(worlds[p], GetScriptedDirection(p, sessions[p].currentTick), nowMS);
+			else
+				Pump(sessions[p], worlds[p], nowMS);
+		}
+
+		if (++iteration > LOOPBACK_TICKS * 10)
+		{
+			fmt::print("The loopback game got stuck at ticks {} and {}!\n", sessions[0].currentTick, sessions[1].currentTick);
+			return false;
+		}
+	}
+
+	//waits for the last inputs to arrive, so both peers have simulated every tick with the real inputs
+	while (sessions[0].remoteInputEnd < LOOPBACK_TICKS || sessions[1].remoteInputEnd < LOOPBACK_TICKS)
+	{
+		const double nowMS = iteration++ * (double)BENCHMARK_FRAME_MS;
+		Pump(sessions[0], worlds[0], nowMS);
+		Pump(sessions[1], worlds[1], nowMS);
+	}
+
+	for (uint32_t p = 0; p < 2; ++p)
+	{
+		const Pong3D::Network::RollbackStats& stats = sessions[p].stats;
+		fmt::print("Player {}: {} rollbacks ({} ticks simulated again, worst {:.3f} ms), {} stalls, {} packets sent, {} received, {} dropped by the conditioner\n",
+			p + 1, stats.rollbacks, stats.resimulatedTicks, stats.maxRollbackMS, stats.stalls, stats.packetsSent, stats.packetsReceived,
+			sessions[p].conditioner.stats.packetsDropped);
+	}
+
+	const uint64_t checksums[2] = { worlds[0].Checksum(), worlds[1].Checksum() };
+	sessions[0].Destroy();
+	sessions[1].Destroy();
+	if (checksums[0] != checksums[1])
+	{
+		fmt::print("The peers ended on different worlds ({:016x} and {:016x})!\n", checksums[0], checksums[1]);
+		return false;
+	}
+
+	fmt::print("Both peers ended on world {:016x} after {} ticks\n", checksums[0], LOOPBACK_TICKS);
+	return true;
+}
+
+//times saving and loading the world and simulating ticks again at a ball count
+static void TimeRollback(size_t ballCount)
+{
+	Pong3D::Physics::PhysicsWorld world;
+	CreateWorld(world, ballCount);
+
+	Pong3D::Network::RollbackSession session;
+	session.fixedDeltaTime = BENCHMARK_STEP_TIME;
+	session.ReserveStates(world);
+
+	//fills the ring, the remote inputs are all guessed
+	for (uint32_t tick = 0; tick < Pong3D::Network::ROLLBACK_RING_SIZE; ++tick)
+	{
+		session.localInputs[tick] = Pong3D::Network::RollbackInput_FromDirection(GetScriptedDirection(0, tick));
+		session.SimulateTick(world, tick);
+	}
+	session.currentTick = Pong3D::Network::ROLLBACK_RING_SIZE;
+
+	double saveMS = 0.0, loadMS = 0.0, rollbackMS = 0.0;
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		world.SaveState(session.states[i % Pong3D::Network::ROLLBACK_RING_SIZE]);
+		saveMS += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		start = std::chrono::high_resolution_clock::now();
+		world.LoadState(session.states[i % Pong3D::Network::ROLLBACK_RING_SIZE]);
+		loadMS += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		session.rollbackFromTick = session.currentTick - BENCHMARK_ROLLBACK_TICKS;
+		session.Rollback(world);
+		rollbackMS += session.stats.lastRollbackMS;
+	}
+
+	saveMS /= BENCHMARK_ITERATIONS; loadMS /= BENCHMARK_ITERATIONS; rollbackMS /= BENCHMARK_ITERATIONS;
+	fmt::print("{} balls: save {:.4f} ms, load {:.4f} ms, {} tick rollback {:.3f} ms ({:.1f}% of a 60 Hz frame)\n",
+		ballCount, saveMS, loadMS, BENCHMARK_ROLLBACK_TICKS, rollbackMS, rollbackMS * 100.0 / BENCHMARK_FRAME_MS);
+}
+
+//entry point
+int main()
+{
+	fmt::print("Loopback: {} ms latency, {} ms jitter, {}% loss\n", LOOPBACK_LATENCY_MS, LOOPBACK_JITTER_MS, LOOPBACK_LOSS_PERCENT);
+	if (!RunLoopback())
+		return -1;
+
+	for (size_t c = 0; c < sizeof(BENCHMARK_BALL_COUNTS) / sizeof(BENCHMARK_BALL_COUNTS[0]); ++c)
+		TimeRollback(BENCHMARK_BALL_COUNTS[c]);
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+//steps the Pong physics with more and more balls and reports how many steps a second it can run
+
+#include <3DPong/Physics/PongPhysics.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <random>
+
+//the ball counts to run and how many steps each
+static constexpr size_t BENCHMARK_BALL_COUNTS[] = { 1000, 10000, 50000, 100000, 250000 };
+static constexpr size_t BENCHMARK_STEPS = 600;
+static constexpr float BENCHMARK_STEP_TIME = 1.0f / 60.0f;
+
+//checks the SIMD integration against the scalar one, the scalar one runs when the count is under a register
+static bool CheckIntegration()
+{
+	std::mt19937 random(99);
+	std::uniform_real_distribution<float> position(-12.0f, 12.0f), velocity(-40.0f, 40.0f);
+
+	const size_t count = 1003;
+	std::vector<float> simdPosition(count), simdVelocity(count), radius(count, 0.25f);
+	for (size_t i = 0; i < count; ++i)
+	{
+		simdPosition[i] = position(random);
+		simdVelocity[i] = velocity(random);
+	}
+	std::vector<float> scalarPosition = simdPosition, scalarVelocity = simdVelocity;
+
+	const uint64_t simdBounces = Pong3D::Physics::PhysicsWorld::IntegrateAxis(simdPosition.data(), simdVelocity.data(), radius.data(), count, BENCHMARK_STEP_TIME, -10.0f, 10.0f, 1.0f);
+	uint64_t scalarBounces = 0;
+	for (size_t i = 0; i < count; ++i)
+		scalarBounces += Pong3D::Physics::PhysicsWorld::IntegrateAxis(&scalarPosition[i], &scalarVelocity[i], &radius[i], 1, BENCHMARK_STEP_TIME, -10.0f, 10.0f, 1.0f);
+
+	if (simdBounces != scalarBounces)
+	{
+		fmt::print("The SIMD integration bounced {} balls, the scalar one {}!\n", simdBounces, scalarBounces);
+		return false;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (std::abs(simdPosition[i] - scalarPosition[i]) > 1e-4f || simdVelocity[i] != scalarVelocity[i])
+		{
+			fmt::print("Ball {} does not match the scalar integration!\n", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//entry point
+int main()
+{
+#if defined(PONG3D_PHYSICS_AVX)
+	fmt::print("Physics path: AVX (8 balls at a time)\n");
+#elif defined(PONG3D_PHYSICS_SSE)
+	fmt::print("Physics path: SSE (4 balls at a time)\n");
+#else
+	fmt::print("Physics path: scalar\n");
+#endif
+
+	if (!CheckIntegration())
+		return -1;
+
+	for (size_t c = 0; c < sizeof(BENCHMARK_BALL_COUNTS) / sizeof(BENCHMARK_BALL_COUNTS[0]); ++c)
+	{
+		const size_t ballCount = BENCHMARK_BALL_COUNTS[c];
+
+		//a big arena so the balls spread out, with a paddle at each end moving up and down
+		Pong3D::Physics::PhysicsWorld_CreateInfo info;
+		info.arenaMin = glm::vec3(-50.0f, -30.0f, 0.0f); info.arenaMax = glm::vec3(50.0f, 30.0f, 40.0f);
+		Pong3D::Physics::PhysicsWorld world;
+		world.Create(info);
+		world.paddles.Add(0, glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(6.0f, 6.0f, 0.5f));
+		world.paddles.Add(1, glm::vec3(0.0f, 0.0f, 38.0f), glm::vec3(6.0f, 6.0f, 0.5f));
+		world.paddles.SetVelocity(0, glm::vec3(0.0f, 10.0f, 0.0f));
+		world.paddles.SetVelocity(1, glm::vec3(0.0f, -10.0f, 0.0f));
+
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> x(-49.0f, 49.0f), y(-29.0f, 29.0f), z(1.0f, 39.0f), velocity(-20.0f, 20.0f);
+		world.balls.Reserve(ballCount);
+		for (size_t i = 0; i < ballCount; ++i)
+			world.balls.Add(i + 2, glm::vec3(x(random), y(random), z(random)), glm::vec3(velocity(random), velocity(random), velocity(random)), 0.25f);
+
+		world.Step(BENCHMARK_STEP_TIME); //warms the caches and sizes the grid
+
+		uint64_t paddleHits = 0, wallBounces = 0;
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (size_t s = 0; s < BENCHMARK_STEPS; ++s)
+		{
+			world.Step(BENCHMARK_STEP_TIME);
+			paddleHits += world.stats.paddleHits;
+			wallBounces += world.stats.wallBounces;
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		const double stepMS = std::chrono::duration<double, std::milli>(end - start).count() / BENCHMARK_STEPS;
+		fmt::print("{} balls: {:.3f} ms per step, {:.0f} steps per second ({:.1f}% of a 60 Hz step), {} paddle hits, {} wall bounces\n",
+			ballCount, stepMS, (stepMS > 0.0 ? 1000.0 / stepMS : 0.0), stepMS * 100.0 / (1000.0 / 60.0), paddleHits, wallBounces);
+	}
+
+	return 0;
+}
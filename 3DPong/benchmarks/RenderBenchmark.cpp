@@ -0,0 +1,342 @@
+//renders a grid of Guitars headless for a fixed number of frames and reports the frame times as JSON
+//runs without a display, pass --software to pick a CPU Vulkan driver like lavapipe
+//counts the heap allocations of the frame path (the prepare, the recording and the submit), the measured frames should make none
+
+#include <3DPong/Engine.hpp>
+#include <3DPong/Memory/AllocationCounter.hpp>
+#include <3DPong/Renderer/FrameManager.hpp>
+#include <3DPong/Renderer/MeshRenderer.hpp>
+#include <3DPong/Renderer/TransformSync.hpp>
+#include <3DPong/Renderer/BatchRecorder.hpp>
+#include <3DPong/Renderer/MeshPool.hpp>
+#include <3DPong/Renderer/MeshPipeline.hpp>
+#include <3DPong/ECS/Scene.hpp>
+#include <3DPong/Assets/BinaryMesh.hpp>
+#include <3DPong/Platform/MappedFile.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <Smok/Assets/AssetManager.hpp>
+#include <Smok/Components/Transform.hpp>
+#include <Smok/Components/Camera.hpp>
+#include <Smok/Components/MeshComponent.hpp>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+PONG3D_DEFINE_ALLOCATION_COUNTER()
+
+//defines the settings of a run, set from the command line
+struct RenderBenchmarkSettings
+{
+	uint32_t instanceCount = 10000;
+	uint32_t frameCount = 1000;
+	uint32_t warmupFrameCount = 100; //not measured, lets the driver and caches settle
+
+	VkExtent2D size = { 1700, 900 };
+	uint32_t framesInFlight = 2;
+
+	bool preferSoftwareDevice = false;
+	bool parallelRecording = false;
+	uint32_t workerCount = 0; //the recording workers with --parallel, 0 uses the worker pool's default. Run with 1, 2, 4... to see how recording scales
+	bool GPUDriven = false;
+	bool CPUCulling = true;
+	bool requireNoAllocations = false; //fails the run if a measured frame allocated on the heap
+
+	std::string outputFilepath; //the JSON is also written here if it's set
+	std::string CPUTraceFilepath; //the CPU profiler's trace is written here if it's set
+};
+
+//defines the samples of one timing
+struct TimingSamples
+{
+	std::vector<double> samples;
+
+	//gets a percentile by nearest rank
+	inline double Percentile(double percent) const
+	{
+		if (samples.empty())
+			return 0.0;
+
+		std::vector<double> sorted = samples;
+		const size_t rank = (size_t)(percent / 100.0 * (double)(sorted.size() - 1) + 0.5);
+		std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+		return sorted[rank];
+	}
+
+	//writes the distribution as a JSON object
+	inline std::string ToJSON() const
+	{
+		double sum = 0.0, min = (samples.empty() ? 0.0 : samples[0]), max = min;
+		for (size_t i = 0; i < samples.size(); ++i)
+		{
+			sum += samples[i];
+			min = std::min(min, samples[i]);
+			max = std::max(max, samples[i]);
+		}
+
+		return fmt::format("{{ \"avg\": {:.4f}, \"min\": {:.4f}, \"p50\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f} }}",
+			(samples.empty() ? 0.0 : sum / (double)samples.size()), min, Percentile(50.0), Percentile(99.0), max);
+	}
+};
+
+//parses the command line, returns false if it's invalid
+static bool ParseArguments(int argc, char** argv, RenderBenchmarkSettings& settings)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const bool hasValue = (i + 1 < argc);
+
+		if (!strcmp(arg, "--instances") && hasValue) settings.instanceCount = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--frames") && hasValue) settings.frameCount = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--warmup") && hasValue) settings.warmupFrameCount = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--width") && hasValue) settings.size.width = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--height") && hasValue) settings.size.height = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--frames-in-flight") && hasValue) settings.framesInFlight = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--workers") && hasValue) settings.workerCount = (uint32_t)std::stoul(argv[++i]);
+		else if (!strcmp(arg, "--out") && hasValue) settings.outputFilepath = argv[++i];
+		else if (!strcmp(arg, "--cpu-trace") && hasValue) settings.CPUTraceFilepath = argv[++i];
+		else if (!strcmp(arg, "--software")) settings.preferSoftwareDevice = true;
+		else if (!strcmp(arg, "--parallel")) settings.parallelRecording = true;
+		else if (!strcmp(arg, "--gpu-driven")) settings.GPUDriven = true;
+		else if (!strcmp(arg, "--no-cull")) settings.CPUCulling = false;
+		else if (!strcmp(arg, "--require-no-allocations")) settings.requireNoAllocations = true;
+		else
+		{
+			fmt::print("Unknown argument \"{}\"\n", arg);
+			fmt::print("Usage: RenderBenchmark [--instances N] [--frames N] [--warmup N] [--width N] [--height N] [--frames-in-flight N]\n"
+				"                       [--software] [--parallel] [--workers N] [--gpu-driven] [--no-cull] [--require-no-allocations] [--out file.json] [--cpu-trace file.json]\n");
+			return false;
+		}
+	}
+
+	return settings.frameCount > 0;
+}
+
+//entry point
+int main(int argc, char** argv)
+{
+	RenderBenchmarkSettings settings;
+	if (!ParseArguments(argc, argv, settings))
+		return -1;
+
+	//--init
+
+	Pong3D::Core::Engine_CreateInfo engineInfo;
+	engineInfo.size = settings.size;
+	engineInfo.isDebug = false; //validation would dominate the timings
+	engineInfo.isHeadless = true;
+	engineInfo.preferSoftwareDevice = settings.preferSoftwareDevice;
+
+	Pong3D::Core::Engine engine;
+	if (!engine.Init(engineInfo))
+	{
+		engine.Shutdown();
+		return -1;
+	}
+
+	Pong3D::Renderer::FrameRenderManager renderManager;
+	renderManager.Init(&engine, settings.framesInFlight, (settings.parallelRecording ? Pong3D::Renderer::FrameRecordMode::ParallelSecondary : Pong3D::Renderer::FrameRecordMode::Inline),
+		settings.workerCount);
+	renderManager.EnableGPUProfiling();
+
+	//registers assets, the same ones the game uses
+	Pong3D::Renderer::PipelineSourceFiles meshPipelineFiles;
+	meshPipelineFiles.settings = "Pipelines/meshSettings." + Wireframe::Pipeline::Serilize::GetPipelineSettingExtentionStr();
+	meshPipelineFiles.pushConstant = "Pipelines/meshPushConstant." + Wireframe::Pipeline::PushConstant::GetExtentionStr();
+	meshPipelineFiles.vertexShader = "shaders/mesh_vertex." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr();
+	meshPipelineFiles.fragmentShader = "shaders/mesh_fragment." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr();
+
+	Smok::Asset::AssetManager::AssetManager AM;
+	const uint64_t meshPipelineAssetID = AM.RegisterAsset_GraphicsPipeline("meshPipeline_Default",
+		BTD::IO::FileInfo(meshPipelineFiles.settings),
+		BTD::IO::FileInfo(meshPipelineFiles.vertexShader),
+		BTD::IO::FileInfo(meshPipelineFiles.fragmentShader));
+	const uint64_t meshPipelineLayoutAssetID = AM.RegisterAsset_PipelineLayout("meshPipelineLayout_Default",
+		BTD::IO::FileInfo(meshPipelineFiles.pushConstant));
+
+	Pong3D::Renderer::PipelineRegistry pipelineRegistry;
+	const Pong3D::Renderer::PipelineState meshPipeline = Pong3D::Renderer::InitMeshPipeline(AM.pipelineLayouts[meshPipelineLayoutAssetID], AM.pipelines[meshPipelineAssetID],
+		meshPipelineFiles, pipelineRegistry, renderManager.renderpass, &engine);
+
+	//loads the Guitar up front, the benchmark measures rendering not streaming
+	Pong3D::Renderer::MeshPool meshPool;
+	meshPool.Create(engine._allocator, (uint32_t)Pong3D::Asset::SMESH_VERTEX_STRIDE, 1024 * 1024, 4 * 1024 * 1024, VK_INDEX_TYPE_UINT16);
+	Pong3D::Renderer::MeshUploadBatcher meshUploadBatcher;
+	meshUploadBatcher.Init(&engine.GPU, engine._allocator);
+
+	Pong3D::Renderer::PooledMesh* guitarMesh = nullptr;
+	{
+		Pong3D::Platform::MappedFile binary; Pong3D::Asset::BinaryMeshView binaryView;
+		if (binary.Open("assets/Guitar." + Pong3D::Asset::BinaryMesh_GetExtensionStr()) &&
+			Pong3D::Asset::BinaryMesh_Read(binary.data, binary.size, binaryView))
+			guitarMesh = meshUploadBatcher.QueueMesh(&meshPool, binaryView);
+	}
+	meshUploadBatcher.Submit();
+	if (!guitarMesh || !meshPipeline.pipeline)
+	{
+		fmt::print("Failed to load the Guitar or its pipeline, run the benchmark from the game's directory.\n");
+		return -1;
+	}
+
+	//----scene, a grid of Guitars in front of the camera like the game's benchmark scene
+	Pong3D::Scene::Scene scene;
+
+	Smok::ECS::Comp::Transform transform; Smok::ECS::Comp::Camera cameraSettings;
+	transform.position = { 0.f, 0.f, -10.f };
+	Pong3D::Scene::Entity camera = scene.Camera_Create("Main Camera", transform, cameraSettings, &engine);
+
+	Smok::ECS::Comp::MeshRender meshRenderComp;
+	meshRenderComp.pipelineID = meshPipelineAssetID;
+	meshRenderComp.pipelineLayoutID = meshPipelineLayoutAssetID;
+
+	std::deque<Pong3D::Renderer::RenderOperationBatch> renderOperationBatchs;
+	Pong3D::Renderer::RenderOperationBatch* batch = &renderOperationBatchs.emplace_back(Pong3D::Renderer::RenderOperationBatch());
+	batch->InitInstanceBuffers(engine._allocator, renderManager.framesInFlightCount);
+
+	Pong3D::Renderer::GPUCullingPass gpuCullingPass;
+	if (settings.GPUDriven)
+	{
+		Wireframe::Shader::Serilize::ShaderSerilizeData cullShader;
+		Wireframe::Shader::Serilize::LoadShaderDataFromFile(BTD::IO::FileInfo("shaders/cull_compute." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr()),
+			cullShader, false);
+		if (gpuCullingPass.Create(&engine.GPU, engine._allocator, cullShader.binaryFilepath))
+			batch->EnableGPUCulling(&gpuCullingPass);
+	}
+	if (settings.CPUCulling)
+		batch->EnableCPUCulling(500.0f);
+
+	for (uint32_t i = 0; i < settings.instanceCount; ++i)
+	{
+		transform.position = { (float)(i % 100) * 3.0f - 150.0f, (float)((i / 100) % 100) * 3.0f - 150.0f, 20.0f + (float)(i / 10000) * 5.0f };
+		Pong3D::Scene::Entity guitar = scene.CreateEntity_Paddle("Benchmark Guitar " + std::to_string(i), transform, meshRenderComp, &engine);
+		batch->AddStaticMesh(meshPipeline.layout, meshPipeline.pipeline, guitarMesh, guitar.ID, transform);
+	}
+
+	Smok::ECS::Comp::Transform* camTrans = BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(camera.ID);
+	Smok::ECS::Comp::Camera* cam = BTD::ECS::getComponent<Smok::ECS::Comp::Camera>(camera.ID);
+	cam->renderSize = { (float)settings.size.width, (float)settings.size.height };
+
+	Pong3D::Renderer::ViewFrameConstants viewConstants;
+	Pong3D::Renderer::BatchRecorder batchRecorder;
+
+	//--frames
+	TimingSamples frameTimes, recordTimes, submitTimes, fenceWaitTimes, GPUFrameTimes;
+	frameTimes.samples.reserve(settings.frameCount); recordTimes.samples.reserve(settings.frameCount);
+	submitTimes.samples.reserve(settings.frameCount); fenceWaitTimes.samples.reserve(settings.frameCount);
+
+	typedef std::chrono::high_resolution_clock Clock;
+	auto ElapsedMS = [](Clock::time_point start, Clock::time_point end) { return std::chrono::duration<double, std::milli>(end - start).count(); };
+
+	Clock::time_point measureStart;
+	uint64_t frameAllocations = 0, maxFrameAllocations = 0;
+	for (uint32_t f = 0; f < settings.warmupFrameCount + settings.frameCount; ++f)
+	{
+		if (f == settings.warmupFrameCount)
+			measureStart = Clock::now();
+
+		const Clock::time_point frameStart = Clock::now();
+		Pong3D::Renderer::SyncDirtyTransforms(scene, renderOperationBatchs);
+		viewConstants.Generate(camTrans, cam);
+
+		//only the frame path is counted, the transform sync goes through the ECS
+		const uint64_t allocationsBefore = Pong3D::Memory::AllocationCounter_Get();
+		Pong3D::Renderer::Frame frame = renderManager.StartFrame([&](Pong3D::Renderer::Frame& startedFrame) {
+			batchRecorder.Prepare(startedFrame, renderOperationBatchs, viewConstants);
+			});
+		batchRecorder.Record(renderManager, frame, renderOperationBatchs, viewConstants);
+		const Clock::time_point recordEnd = Clock::now();
+
+		renderManager.SubmitFrame(frame);
+		const Clock::time_point submitEnd = Clock::now();
+		const uint64_t allocations = Pong3D::Memory::AllocationCounter_Get() - allocationsBefore;
+
+		if (f < settings.warmupFrameCount)
+			continue;
+
+		frameAllocations += allocations;
+		maxFrameAllocations = std::max(maxFrameAllocations, allocations);
+
+		//the record time is the CPU work of the frame, the wait for a free frame slot is reported on its own
+		const double fenceWaitMS = renderManager.pacingStats.lastFenceWaitMS;
+		frameTimes.samples.emplace_back(ElapsedMS(frameStart, submitEnd));
+		recordTimes.samples.emplace_back(ElapsedMS(frameStart, recordEnd) - fenceWaitMS);
+		submitTimes.samples.emplace_back(ElapsedMS(recordEnd, submitEnd));
+		fenceWaitTimes.samples.emplace_back(fenceWaitMS);
+
+		//the GPU results are frames in flight late, only the measured frames are kept
+		const Pong3D::Renderer::GPUProfileFrameResults& GPUResults = renderManager.gpuProfiler.lastResults;
+		if (GPUResults.isValid && GPUResults.frameNumber >= settings.warmupFrameCount)
+			GPUFrameTimes.samples.emplace_back(GPUResults.frameMS);
+	}
+	vkDeviceWaitIdle(engine.GPU.device);
+	const double totalMS = ElapsedMS(measureStart, Clock::now());
+
+	//--report
+	//what a empty zone costs, zero when the zones are compiled out
+	double zoneOverheadNS = 0.0;
+#if PONG3D_PROFILING
+	zoneOverheadNS = Pong3D::Profiling::CPUProfiler_MeasureZoneOverhead();
+#endif
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(engine.GPU.chosenGPU, &properties);
+
+	const Pong3D::Renderer::RenderOperationBatchStats& stats = batch->stats;
+	const std::string json = fmt::format(
+		"{{\n"
+		"  \"benchmark\": \"RenderBenchmark\",\n"
+		"  \"device\": \"{}\",\n"
+		"  \"width\": {}, \"height\": {},\n"
+		"  \"instances\": {}, \"frames\": {}, \"warmupFrames\": {}, \"framesInFlight\": {},\n"
+		"  \"recordMode\": \"{}\", \"workers\": {}, \"culling\": \"{}\",\n"
+		"  \"drawCalls\": {}, \"visibleInstances\": {},\n"
+		"  \"averageFPS\": {:.2f},\n"
+		"  \"frameTimeMS\": {},\n"
+		"  \"cpuRecordMS\": {},\n"
+		"  \"submitMS\": {},\n"
+		"  \"fenceWaitMS\": {},\n"
+		"  \"gpuFrameMS\": {},\n"
+		"  \"heapAllocationsPerFrame\": {{ \"avg\": {:.2f}, \"max\": {} }},\n"
+		"  \"cpuZoneOverheadNS\": {:.1f}\n"
+		"}}\n",
+		properties.deviceName, settings.size.width, settings.size.height,
+		settings.instanceCount, settings.frameCount, settings.warmupFrameCount, renderManager.framesInFlightCount,
+		(settings.parallelRecording ? "ParallelSecondary" : "Inline"), (settings.parallelRecording ? renderManager.workerPool.GetWorkerCount() : 1), (batch->IsGPUCullingEnabled() ? "GPU" : batch->IsCPUCullingActive() ? "CPU" : "None"),
+		stats.drawCalls, (batch->IsCPUCullingActive() ? stats.visibleInstances : stats.instances),
+		(totalMS > 0.0 ? settings.frameCount * 1000.0 / totalMS : 0.0),
+		frameTimes.ToJSON(), recordTimes.ToJSON(), submitTimes.ToJSON(), fenceWaitTimes.ToJSON(), GPUFrameTimes.ToJSON(),
+		(double)frameAllocations / (double)settings.frameCount, maxFrameAllocations, zoneOverheadNS);
+
+	fmt::print("{}", json);
+	if (!settings.outputFilepath.empty())
+	{
+		std::ofstream file(settings.outputFilepath, std::ios::trunc);
+		file << json;
+	}
+	if (!settings.CPUTraceFilepath.empty())
+		PONG3D_PROFILE_WRITE_TRACE(settings.CPUTraceFilepath);
+
+	const bool allocatedOnTheHeap = (frameAllocations > 0);
+	if (allocatedOnTheHeap)
+		fmt::print("The measured frames made {} heap allocations, the frame path should only use the frame arena once it has grown!\n", frameAllocations);
+
+	//--clean up
+	for (size_t i = 0; i < renderOperationBatchs.size(); ++i)
+		renderOperationBatchs[i].DestroyInstanceBuffers();
+	if (gpuCullingPass.isCreated)
+		gpuCullingPass.Destroy();
+	meshUploadBatcher.Destroy();
+	meshPool.Destroy(engine._allocator);
+	AM.Destroy(engine._allocator, &engine.GPU);
+	renderManager.Shutdown();
+	engine.Shutdown();
+
+	return (settings.requireNoAllocations && allocatedOnTheHeap ? -1 : 0);
+}
@@ -0,0 +1,174 @@
+//replicates a scene of 10k entities from a server to a client in process through a lossy link and checks the client ends up with the server's snapshots
+//reports the bytes each entity costs a tick, with and without a baseline, and how fast the snapshots encode and decode
+
+#include <3DPong/Network/SnapshotReplication.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <random>
+
+static constexpr size_t BENCHMARK_ENTITY_COUNT = 10000;
+static constexpr uint32_t BENCHMARK_TICKS = 600;
+static constexpr float BENCHMARK_STEP_TIME = 1.0f / 60.0f;
+static constexpr float BENCHMARK_MOVING_PERCENT = 20.0f; //the rest sit still, like the walls and the balls that have settled
+static constexpr float BENCHMARK_LOSS_PERCENT = 5.0f; //of the snapshot packets and the acks
+static constexpr uint32_t BENCHMARK_RESPAWN_INTERVAL = 30; //a entity is destroyed and a new one takes its slot every this many ticks
+
+//defines a entity of the benchmark's world
+struct BenchmarkEntity
+{
+	uint64_t entityID = 0;
+	glm::vec3 position = glm::vec3(0.0f), velocity = glm::vec3(0.0f);
+	glm::vec3 rotation = glm::vec3(0.0f), spin = glm::vec3(0.0f);
+	glm::vec3 scale = glm::vec3(1.0f);
+};
+
+//checks the client's snapshot is the server's
+static bool Snapshot_IsEqual(const Pong3D::Network::ReplicationSnapshot& a, const Pong3D::Network::ReplicationSnapshot& b)
+{
+	if (a.sequence != b.sequence || a.entities.size() != b.entities.size())
+		return false;
+
+	for (size_t i = 0; i < a.entities.size(); ++i)
+	{
+		if (a.entities[i].entityID != b.entities[i].entityID || a.entities[i].position != b.entities[i].position ||
+			a.entities[i].rotation != b.entities[i].rotation || a.entities[i].scale != b.entities[i].scale)
+			return false;
+	}
+
+	return true;
+}
+
+//entry point
+int main()
+{
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> coordinate(-60.0f, 60.0f), speed(-8.0f, 8.0f), angle(0.0f, 360.0f), spin(-180.0f, 180.0f), percent(0.0f, 100.0f);
+
+	//makes the world, the moving entities are spread through it
+	std::vector<BenchmarkEntity> entities(BENCHMARK_ENTITY_COUNT);
+	const auto spawn = [&](BenchmarkEntity& entity, uint32_t index, uint32_t generation) {
+		entity.entityID = Pong3D::ECS::Entity_PackID(index, generation);
+		entity.position = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+		entity.rotation = glm::vec3(angle(random), angle(random), angle(random));
+		const bool isMoving = (percent(random) < BENCHMARK_MOVING_PERCENT);
+		entity.velocity = (isMoving ? glm::vec3(speed(random), speed(random), speed(random)) : glm::vec3(0.0f));
+		entity.spin = (isMoving ? glm::vec3(0.0f, spin(random), 0.0f) : glm::vec3(0.0f));
+		};
+	for (uint32_t i = 0; i < BENCHMARK_ENTITY_COUNT; ++i)
+		spawn(entities[i], i, 0);
+
+	Pong3D::Network::SnapshotEncoder encoder;
+	Pong3D::Network::SnapshotDecoder decoder;
+	Pong3D::Network::ReplicationClient client;
+
+	double encodeMS = 0.0, decodeMS = 0.0;
+	uint64_t deltaBytes = 0, deltaTicks = 0, packetsSent = 0, packetsLost = 0, acksLost = 0, completedSnapshots = 0;
+	uint64_t maxPacketSize = 0;
+	for (uint32_t tick = 0; tick < BENCHMARK_TICKS; ++tick)
+	{
+		//moves the world, bouncing off the bounds
+		for (BenchmarkEntity& entity : entities)
+		{
+			entity.position += entity.velocity * BENCHMARK_STEP_TIME;
+			entity.rotation += entity.spin * BENCHMARK_STEP_TIME;
+			for (uint32_t a = 0; a < 3; ++a)
+			{
+				if (entity.position[a] < -60.0f || entity.position[a] > 60.0f)
+					entity.velocity[a] = -entity.velocity[a];
+			}
+		}
+		if (tick > 0 && tick % BENCHMARK_RESPAWN_INTERVAL == 0)
+		{
+			const uint32_t index = random() % BENCHMARK_ENTITY_COUNT;
+			spawn(entities[index], index, Pong3D::ECS::Entity_GetGeneration(entities[index].entityID) + 1);
+		}
+
+		//the server takes the snapshot and encodes it against what the client acked
+		auto start = std::chrono::high_resolution_clock::now();
+		Pong3D::Network::ReplicationSnapshot& snapshot = encoder.BeginSnapshot();
+		snapshot.entities.reserve(entities.size());
+		for (const BenchmarkEntity& entity : entities)
+			snapshot.Add(entity.entityID, entity.position, entity.rotation, entity.scale, encoder.quantization);
+		encoder.EndSnapshot();
+		const size_t packetCount = encoder.EncodeForClient(client);
+		encodeMS += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		if (encoder.GetSnapshot(client.ackedSequence))
+		{
+			deltaBytes += encoder.stats.bytes;
+			deltaTicks++;
+		}
+
+		//the client gets what the link lets through, in reverse order to show the order doesn't matter
+		start = std::chrono::high_resolution_clock::now();
+		bool isComplete = false;
+		for (size_t p = packetCount; p-- > 0;)
+		{
+			packetsSent++;
+			maxPacketSize = std::max<uint64_t>(maxPacketSize, encoder.packets[p].size);
+			if (percent(random) < BENCHMARK_LOSS_PERCENT)
+			{
+				packetsLost++;
+				continue;
+			}
+			isComplete |= decoder.ReadPacket(encoder.packets[p].data.data(), encoder.packets[p].size);
+		}
+		decodeMS += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		//the client must have exactly what the server sent
+		if (isComplete)
+		{
+			completedSnapshots++;
+			if (!Snapshot_IsEqual(*decoder.GetLatest(), *encoder.GetSnapshot(decoder.latestSequence)))
+			{
+				fmt::print("The client's snapshot {} is not the server's!\n", decoder.latestSequence);
+				return -1;
+			}
+		}
+
+		//the client acks its latest snapshot every tick, back through the same link
+		if (decoder.GetLatest())
+		{
+			if (percent(random) < BENCHMARK_LOSS_PERCENT)
+				acksLost++;
+			else
+				client.Ack(decoder.latestSequence);
+		}
+	}
+
+	if (decoder.packetsRejected > 0)
+	{
+		fmt::print("The client rejected {} packets!\n", decoder.packetsRejected);
+		return -1;
+	}
+
+	//the cost without a baseline, what a client that just joined or lost too many acks is sent
+	Pong3D::Network::ReplicationClient newClient;
+	Pong3D::Network::ReplicationEncodeStats fullStats;
+	double fullEncodeMS = 0.0;
+	for (uint32_t i = 0; i < 20; ++i)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		encoder.EncodeForClient(newClient);
+		fullEncodeMS += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		fullStats = encoder.stats;
+	}
+	fullEncodeMS /= 20;
+
+	const double rawBytes = (double)sizeof(glm::vec3) * 3 + sizeof(uint64_t);
+	const double deltaBytesPerEntity = (double)deltaBytes / (double)deltaTicks / (double)BENCHMARK_ENTITY_COUNT;
+	const double fullBytesPerEntity = (double)fullStats.bytes / (double)BENCHMARK_ENTITY_COUNT;
+	fmt::print("{} entities, {}% moving, {} ticks, {}% loss\n", BENCHMARK_ENTITY_COUNT, BENCHMARK_MOVING_PERCENT, BENCHMARK_TICKS, BENCHMARK_LOSS_PERCENT);
+	fmt::print("Raw transform: {:.1f} bytes per entity\n", rawBytes);
+	fmt::print("Full snapshot: {:.2f} bytes per entity, {} packets, encoded in {:.3f} ms\n", fullBytesPerEntity, fullStats.packets, fullEncodeMS);
+	fmt::print("Delta snapshot: {:.2f} bytes per entity per tick ({:.1f} KB a tick, {:.1f} KB/s at 60 Hz)\n", deltaBytesPerEntity,
+		deltaBytesPerEntity * BENCHMARK_ENTITY_COUNT / 1024.0, deltaBytesPerEntity * BENCHMARK_ENTITY_COUNT * 60.0 / 1024.0);
+	fmt::print("Capture and encode: {:.3f} ms a tick ({:.1f} M entities/s), decode {:.3f} ms a tick\n", encodeMS / BENCHMARK_TICKS,
+		(double)BENCHMARK_ENTITY_COUNT * BENCHMARK_TICKS / (encodeMS * 1000.0), decodeMS / BENCHMARK_TICKS);
+	fmt::print("{} packets sent (largest {} bytes), {} lost, {} acks lost, {} of {} snapshots completed and matched the server's\n",
+		packetsSent, maxPacketSize, packetsLost, acksLost, completedSnapshots, BENCHMARK_TICKS);
+
+	return 0;
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+//defines asynchronous asset loading, requests hand back a handle right away and the asset is streamed in over the next frames
+//loader threads map, validate and decode the files, the frame loop stages what's ready and submits the upload without waiting on it
+
+#include <3DPong/Platform/MappedFile.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+#include <3DPong/Renderer/MeshPool.hpp>
+#include <3DPong/Renderer/PipelineRegistry.hpp>
+#include <3DPong/Threading/TaskQueue.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace Pong3D::Asset
+{
+	//defines where a load is at
+	enum class AssetLoadState : uint8_t
+	{
+		Queued = 0, //waiting for a loader thread
+		Loading, //being read and decoded on a loader thread
+		Decoded, //waiting to be staged by the frame loop
+		Uploading, //the upload is on the GPU
+		Ready,
+		Failed,
+
+		Count
+	};
+
+	//defines a mesh load, the mesh is handed out right away and is resident once the load is ready
+	struct MeshLoadRequest
+	{
+		std::string filepath;
+		std::atomic<AssetLoadState> state{ AssetLoadState::Queued };
+
+		Renderer::PooledMesh* mesh = nullptr; //reserved in the pool when requested, draws nothing until it's resident. Freed and cleared if the load fails
+		Renderer::MeshUploadProgress uploadProgress; //frame loop only, how much has been staged
+
+		//the decoded file, owned by the loader thread until the state is Decoded then by the frame loop
+		Platform::MappedFile file;
+		BinaryMeshView view;
+
+		inline bool IsReady() const { return state.load(std::memory_order_acquire) == AssetLoadState::Ready; }
+		inline bool IsFailed() const { return state.load(std::memory_order_acquire) == AssetLoadState::Failed; }
+	};
+	typedef std::shared_ptr<MeshLoadRequest> MeshHandle;
+
+	//defines a pipeline load, the pipeline state is valid once the load is ready
+	struct PipelineLoadRequest
+	{
+		std::atomic<AssetLoadState> state{ AssetLoadState::Queued };
+		Renderer::PipelineState pipelineState;
+
+		inline bool IsReady() const { return state.load(std::memory_order_acquire) == AssetLoadState::Ready; }
+		inline bool IsFailed() const { return state.load(std::memory_order_acquire) == AssetLoadState::Failed; }
+
+		//blocks until the pipeline is built, returns false if it failed. For startup, a frame should check IsReady instead
+		inline bool Wait() const
+		{
+			AssetLoadState current = state.load(std::memory_order_acquire);
+			while (current != AssetLoadState::Ready && current != AssetLoadState::Failed)
+			{
+				state.wait(current, std::memory_order_acquire);
+				current = state.load(std::memory_order_acquire);
+			}
+			return current == AssetLoadState::Ready;
+		}
+	};
+	typedef std::shared_ptr<PipelineLoadRequest> PipelineHandle;
+
+	//defines the stats of the streamer
+	struct AssetStreamerStats
+	{
+		uint64_t meshesRequested = 0, meshesReady = 0, meshesFailed = 0;
+		uint64_t pipelinesRequested = 0;
+		uint64_t uploadsSubmitted = 0;
+		uint64_t meshesWaitingForStaging = 0; //decoded but the staging buffer was busy or full this frame
+	};
+
+	//defines the asset streamer
+	struct AssetStreamer
+	{
+		Threading::TaskQueue loaders;
+
+		Renderer::MeshPool* meshPool = nullptr;
+		Renderer::MeshUploadBatcher* meshUploader = nullptr;
+		bool verifyChecksums = BINARY_MESH_VERIFY_CHECKSUM_DEFAULT; //hashes every file as it loads, on in debug builds
+
+		//handed from the loader threads to the frame loop
+		std::mutex decodedMutex;
+		std::vector<MeshHandle> decodedMeshes;
+
+		//frame loop only
+		std::vector<MeshHandle> meshesToStage;
+		std::vector<MeshHandle> uploadingMeshes;
+
+		AssetStreamerStats stats;
+
+		//starts the loader threads, the pool and uploader are only used from the frame loop
+		inline bool Init(Renderer::MeshPool* _meshPool, Renderer::MeshUploadBatcher* _meshUploader, uint32_t loaderThreadCount = 2)
+		{
+			meshPool = _meshPool;
+			meshUploader = _meshUploader;
+			return loaders.Init(loaderThreadCount);
+		}
+
+		//stops the loader threads and waits for the upload in flight, loads that haven't started are dropped and marked failed
+		//the meshes of loads that never made it onto the GPU are freed back to the pool
+		inline void Shutdown()
+		{
+			loaders.Shutdown();
+			if (meshUploader)
+				meshUploader->FinishSubmit(true);
+
+			for (size_t i = 0; i < decodedMeshes.size(); ++i)
+				FailMesh(decodedMeshes[i]);
+			decodedMeshes.clear();
+			for (size_t i = 0; i < meshesToStage.size(); ++i)
+				FailMesh(meshesToStage[i]);
+			meshesToStage.clear();
+
+			for (size_t i = 0; i < uploadingMeshes.size(); ++i)
+				uploadingMeshes[i]->state.store(AssetLoadState::Ready, std::memory_order_release);
+			stats.meshesReady += uploadingMeshes.size();
+			uploadingMeshes.clear();
+		}
+
+		//marks a mesh load failed and frees its mesh, call from the frame loop
+		inline void FailMesh(const MeshHandle& handle)
+		{
+			handle->state.store(AssetLoadState::Failed, std::memory_order_release);
+			handle->file.Close();
+			handle->view = BinaryMeshView();
+			if (handle->mesh)
+			{
+				meshPool->Free(handle->mesh);
+				handle->mesh = nullptr;
+			}
+			stats.meshesFailed++;
+		}
+
+		//requests a binary mesh, call from the frame loop. The mesh in the handle can be given to batches right away
+		inline MeshHandle RequestMesh(const std::string& filepath)
+		{
+			MeshHandle handle = std::make_shared<MeshLoadRequest>();
+			handle->filepath = filepath;
+			handle->mesh = meshPool->ReserveMesh();
+			stats.meshesRequested++;
+
+			const bool verify = verifyChecksums;
+			loaders.Push([this, handle, verify]() {
+				PONG3D_PROFILE_ZONE("Load Mesh");
+				handle->state.store(AssetLoadState::Loading, std::memory_order_release);
+
+				//reads every page so the frame loop's copy into the staging buffer never waits on the disk
+				bool isValid = handle->file.Open(handle->filepath) &&
+					BinaryMesh_Read(handle->file.data, handle->file.size, handle->view, verify);
+				if (isValid && !verify)
+				{
+					uint8_t touch = 0;
+					for (size_t i = 0; i < handle->file.size; i += 4096)
+						touch ^= handle->file.data[i];
+
+					//the one volatile store keeps the reads from being optimized out
+					volatile uint8_t touched = touch;
+					(void)touched;
+				}
+
+				//failed loads are still handed over so the frame loop can count them
+				if (!isValid)
+					handle->file.Close();
+				handle->state.store((isValid ? AssetLoadState::Decoded : AssetLoadState::Failed), std::memory_order_release);
+
+				std::lock_guard<std::mutex> lock(decodedMutex);
+				decodedMeshes.emplace_back(handle);
+			}, [this, handle]() {
+				//dropped on the frame loop by Shutdown, or right away if the loaders aren't running
+				FailMesh(handle);
+			});
+
+			return handle;
+		}
+
+		//requests a pipeline, the build runs on a loader thread and has to be safe to run there
+		inline PipelineHandle RequestPipeline(std::function<Renderer::PipelineState()> build)
+		{
+			PipelineHandle handle = std::make_shared<PipelineLoadRequest>();
+			stats.pipelinesRequested++;
+
+			loaders.Push([handle, build]() {
+				PONG3D_PROFILE_ZONE("Build Pipeline");
+				handle->state.store(AssetLoadState::Loading, std::memory_order_release);
+				handle->pipelineState = build();
+				handle->state.store((handle->pipelineState.pipeline ? AssetLoadState::Ready : AssetLoadState::Failed), std::memory_order_release);
+				handle->state.notify_all();
+			}, [handle]() {
+				//the queue shut down first, anything waiting on the pipeline is let go
+				handle->state.store(AssetLoadState::Failed, std::memory_order_release);
+				handle->state.notify_all();
+			});
+
+			return handle;
+		}
+
+		//moves the loads along, call once a frame from the frame loop. Never waits on a loader thread or the GPU
+		inline void Update()
+		{
+			PONG3D_PROFILE_ZONE("Asset Streamer Update");
+
+			//the last upload finished, the batcher may have already waited on it if something else used it
+			//it's checked even with no mesh waiting on it, it may only hold part of one
+			if (meshUploader->FinishSubmit(false))
+			{
+				for (size_t i = 0; i < uploadingMeshes.size(); ++i)
+					uploadingMeshes[i]->state.store(AssetLoadState::Ready, std::memory_order_release);
+				stats.meshesReady += uploadingMeshes.size();
+				uploadingMeshes.clear();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(decodedMutex);
+				for (size_t i = 0; i < decodedMeshes.size(); ++i)
+				{
+					if (decodedMeshes[i]->IsFailed())
+					{
+						fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Asset Streamer || Update || Failed to load \"{}\"!\n", decodedMeshes[i]->filepath);
+						FailMesh(decodedMeshes[i]);
+					}
+					else
+						meshesToStage.emplace_back(decodedMeshes[i]);
+				}
+				decodedMeshes.clear();
+			}
+
+			//the staging buffer is in use until the upload in flight is done
+			stats.meshesWaitingForStaging = meshesToStage.size();
+			if (meshesToStage.empty() || meshUploader->IsSubmitInFlight())
+				return;
+
+			//stages as many as fit, the rest wait for the next upload
+			//a mesh bigger than the staging buffer fills what's left of it every upload until all of it is staged, so no frame waits on it
+			PONG3D_PROFILE_ZONE("Stage Meshes");
+			size_t staged = 0;
+			bool stagedAny = false;
+			for (; staged < meshesToStage.size(); ++staged)
+			{
+				MeshHandle& handle = meshesToStage[staged];
+				const VkDeviceSize stagingSize = Renderer::MeshUploadBatcher::GetStagingSize(meshPool, handle->view);
+				const bool fitsEmptyStaging = stagingSize <= meshUploader->stagingBuffer.capacity;
+				if (fitsEmptyStaging && !meshUploader->CanStage(stagingSize))
+					break;
+
+				if (!meshUploader->QueueMeshPart(meshPool, handle->mesh, handle->view, handle->uploadProgress))
+				{
+					FailMesh(handle);
+					continue;
+				}
+				stagedAny = true;
+
+				//the rest of it goes in the next upload
+				if (!handle->uploadProgress.isQueued)
+					break;
+
+				handle->state.store(AssetLoadState::Uploading, std::memory_order_release);
+				uploadingMeshes.emplace_back(handle);
+
+				//the data is in the staging buffer now
+				handle->file.Close();
+				handle->view = BinaryMeshView();
+			}
+			meshesToStage.erase(meshesToStage.begin(), meshesToStage.begin() + staged);
+			stats.meshesWaitingForStaging = meshesToStage.size();
+
+			if (stagedAny && meshUploader->SubmitAsync(meshPool))
+				stats.uploadsSubmitted++;
+		}
+	};
+}
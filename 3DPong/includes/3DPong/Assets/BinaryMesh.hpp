@@ -0,0 +1,303 @@
+#pragma once
+
+//defines the .pmesh binary mesh container, a single file that replaces the .smesh and .smeshdecl pair
+//it's read straight out of a memory mapped file, the vertex and index sections are aligned so they can be copied to the GPU as is
+//
+//layout:
+//	BinaryMeshHeader
+//	BinaryMeshSubMesh[subMeshCount]
+//	vertex data, aligned to BINARY_MESH_SECTION_ALIGNMENT
+//	index data (16 or 32 bit), aligned to BINARY_MESH_SECTION_ALIGNMENT
+
+#include <3DPong/Assets/MeshBounds.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace Pong3D::Asset
+{
+	//"PMSH"
+	static constexpr uint32_t BINARY_MESH_MAGIC = ((uint32_t)'P') | ((uint32_t)'M' << 8) | ((uint32_t)'S' << 16) | ((uint32_t)'H' << 24);
+	static constexpr uint32_t BINARY_MESH_VERSION = 1;
+
+	//the alignment of the data sections, covers any nonCoherentAtomSize and buffer offset alignment
+	static constexpr uint64_t BINARY_MESH_SECTION_ALIGNMENT = 256;
+
+	//the checksum hashes the whole file, so it's only checked by default in debug builds. The converter checks it after every write
+#if defined(BTD_DEBUG)
+	static constexpr bool BINARY_MESH_VERIFY_CHECKSUM_DEFAULT = true;
+#else
+	static constexpr bool BINARY_MESH_VERIFY_CHECKSUM_DEFAULT = false;
+#endif
+
+	//gets the file extension
+	inline std::string BinaryMesh_GetExtensionStr() { return "pmesh"; }
+
+	//defines the size of the indices
+	enum class BinaryMeshIndexType : uint32_t
+	{
+		UInt16 = 0,
+		UInt32,
+
+		Count
+	};
+
+	//defines the flags of a binary mesh
+	enum BinaryMeshFlags : uint32_t
+	{
+		BINARY_MESH_FLAG_NONE = 0,
+		BINARY_MESH_FLAG_HAS_CHECKSUM = 1 << 0
+	};
+
+	//defines the header, everything is little endian
+	struct BinaryMeshHeader
+	{
+		uint32_t magic = BINARY_MESH_MAGIC;
+		uint32_t version = BINARY_MESH_VERSION;
+		uint32_t flags = BINARY_MESH_FLAG_NONE;
+		BinaryMeshIndexType indexType = BinaryMeshIndexType::UInt32;
+
+		uint32_t vertexStride = 0;
+		uint32_t vertexCount = 0;
+		uint32_t subMeshCount = 0;
+		uint32_t totalIndexCount = 0;
+
+		uint64_t subMeshTableOffset = 0;
+		uint64_t vertexDataOffset = 0, vertexDataSize = 0;
+		uint64_t indexDataOffset = 0, indexDataSize = 0;
+
+		uint64_t checksum = 0; //FNV-1a of everything after the header, only set if BINARY_MESH_FLAG_HAS_CHECKSUM is
+
+		//the bounds of the whole mesh
+		float aabbMin[3] = { 0.0f, 0.0f, 0.0f }, aabbMax[3] = { 0.0f, 0.0f, 0.0f };
+		float sphere[4] = { 0.0f, 0.0f, 0.0f, -1.0f };
+
+		uint32_t reserved[2] = { 0, 0 };
+	};
+	static_assert(sizeof(BinaryMeshHeader) == 128, "the binary mesh header must stay 128 bytes");
+
+	//defines a entry in the sub mesh table, the indices are relative to the first vertex of the mesh
+	struct BinaryMeshSubMesh
+	{
+		uint32_t firstIndex = 0, indexCount = 0;
+
+		float aabbMin[3] = { 0.0f, 0.0f, 0.0f }, aabbMax[3] = { 0.0f, 0.0f, 0.0f };
+		float sphere[4] = { 0.0f, 0.0f, 0.0f, -1.0f };
+	};
+	static_assert(sizeof(BinaryMeshSubMesh) == 48, "the binary mesh sub mesh entry must stay 48 bytes");
+
+	//defines a view into a binary mesh, every pointer is into the mapped file
+	struct BinaryMeshView
+	{
+		const BinaryMeshHeader* header = nullptr;
+		const BinaryMeshSubMesh* subMeshes = nullptr;
+		const uint8_t* vertexData = nullptr;
+		const uint8_t* indexData = nullptr;
+
+		inline bool IsValid() const { return header != nullptr; }
+
+		//the size of a index in bytes
+		inline uint32_t IndexSize() const { return (header->indexType == BinaryMeshIndexType::UInt16 ? 2 : 4); }
+	};
+
+	//hashes data with 64 bit FNV-1a
+	inline uint64_t BinaryMesh_Checksum(const uint8_t* data, size_t size)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	//rounds a offset up to the section alignment
+	inline uint64_t BinaryMesh_AlignOffset(uint64_t offset)
+	{
+		return (offset + BINARY_MESH_SECTION_ALIGNMENT - 1) & ~(BINARY_MESH_SECTION_ALIGNMENT - 1);
+	}
+
+	//is a section inside the data, without the offset and size overflowing
+	inline bool BinaryMesh_SectionFits(uint64_t offset, uint64_t sectionSize, size_t size)
+	{
+		return offset <= size && sectionSize <= size - offset;
+	}
+
+	//reads a binary mesh out of memory, nothing is copied or parsed so the memory has to outlive the view
+	//the header, its sections and the sub mesh table are checked against the data, the indices are checked once by the converter when it writes the file
+	//the optional checksum catches corruption after that
+	inline bool BinaryMesh_Read(const uint8_t* data, size_t size, BinaryMeshView& view, bool verifyChecksum = BINARY_MESH_VERIFY_CHECKSUM_DEFAULT)
+	{
+		view = BinaryMeshView();
+		if (!data || size < sizeof(BinaryMeshHeader))
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || The data is too small to be a binary mesh!\n");
+			return false;
+		}
+
+		const BinaryMeshHeader* header = (const BinaryMeshHeader*)data;
+		if (header->magic != BINARY_MESH_MAGIC)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || The data is not a binary mesh!\n");
+			return false;
+		}
+		if (header->version != BINARY_MESH_VERSION)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || Version {} is not supported, expected {}. Re-run the mesh converter!\n",
+				header->version, BINARY_MESH_VERSION);
+			return false;
+		}
+		if (header->indexType >= BinaryMeshIndexType::Count)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || Unknown index type {}!\n", (uint32_t)header->indexType);
+			return false;
+		}
+
+		//every section has to be inside the data
+		const uint64_t indexSize = (header->indexType == BinaryMeshIndexType::UInt16 ? 2 : 4);
+		const bool sectionsFit =
+			BinaryMesh_SectionFits(header->subMeshTableOffset, (uint64_t)header->subMeshCount * sizeof(BinaryMeshSubMesh), size) &&
+			BinaryMesh_SectionFits(header->vertexDataOffset, header->vertexDataSize, size) &&
+			BinaryMesh_SectionFits(header->indexDataOffset, header->indexDataSize, size) &&
+			header->subMeshTableOffset % alignof(BinaryMeshSubMesh) == 0 &&
+			header->indexDataOffset % indexSize == 0 &&
+			header->vertexDataSize == (uint64_t)header->vertexCount * header->vertexStride &&
+			header->indexDataSize == (uint64_t)header->totalIndexCount * indexSize;
+		if (!sectionsFit)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || The sections don't fit the data, the file is truncated or corrupt!\n");
+			return false;
+		}
+
+		if (verifyChecksum && (header->flags & BINARY_MESH_FLAG_HAS_CHECKSUM) &&
+			BinaryMesh_Checksum(data + sizeof(BinaryMeshHeader), size - sizeof(BinaryMeshHeader)) != header->checksum)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || The checksum does not match, the file is corrupt!\n");
+			return false;
+		}
+
+		//every sub mesh has to be inside the index data
+		const BinaryMeshSubMesh* subMeshes = (const BinaryMeshSubMesh*)(data + header->subMeshTableOffset);
+		for (uint32_t i = 0; i < header->subMeshCount; ++i)
+		{
+			if ((uint64_t)subMeshes[i].firstIndex + subMeshes[i].indexCount > header->totalIndexCount)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Read || Sub mesh {} reads indices {} to {} but there are only {}!\n",
+					i, subMeshes[i].firstIndex, (uint64_t)subMeshes[i].firstIndex + subMeshes[i].indexCount, header->totalIndexCount);
+				return false;
+			}
+		}
+
+		view.header = header;
+		view.subMeshes = subMeshes;
+		view.vertexData = data + header->vertexDataOffset;
+		view.indexData = data + header->indexDataOffset;
+		return true;
+	}
+
+	//gets the bounds stored in a binary mesh, they're computed by the converter so nothing is walked at load
+	inline void BinaryMesh_GetBounds(const BinaryMeshView& view, StaticMeshBounds& bounds)
+	{
+		auto toBounds = [](const float* aabbMin, const float* aabbMax, const float* sphere) {
+			MeshBounds b;
+			b.aabb.min = glm::vec3(aabbMin[0], aabbMin[1], aabbMin[2]);
+			b.aabb.max = glm::vec3(aabbMax[0], aabbMax[1], aabbMax[2]);
+			b.sphere.center = glm::vec3(sphere[0], sphere[1], sphere[2]);
+			b.sphere.radius = sphere[3];
+			return b;
+		};
+
+		bounds.mesh = toBounds(view.header->aabbMin, view.header->aabbMax, view.header->sphere);
+		bounds.subMeshes.resize(view.header->subMeshCount);
+		for (uint32_t i = 0; i < view.header->subMeshCount; ++i)
+			bounds.subMeshes[i] = toBounds(view.subMeshes[i].aabbMin, view.subMeshes[i].aabbMax, view.subMeshes[i].sphere);
+	}
+
+	//writes a binary mesh, the sub meshes are packed into one index section in order
+	//16 bit indices are used when every vertex can be reached with them, unless forceIndex32 is set
+	inline bool BinaryMesh_Write(const std::string& filepath, const uint8_t* vertices, uint32_t vertexStride, uint32_t vertexCount,
+		const std::vector<std::vector<uint32_t>>& subMeshIndices, bool writeChecksum = true, bool forceIndex32 = false)
+	{
+		BinaryMeshHeader header;
+		header.indexType = (!forceIndex32 && vertexCount <= UINT16_MAX ? BinaryMeshIndexType::UInt16 : BinaryMeshIndexType::UInt32);
+		header.vertexStride = vertexStride;
+		header.vertexCount = vertexCount;
+		header.subMeshCount = (uint32_t)subMeshIndices.size();
+
+		//the sub mesh table and bounds
+		std::vector<BinaryMeshSubMesh> subMeshes(subMeshIndices.size());
+		std::vector<MeshBounds> subMeshBounds(subMeshIndices.size());
+		for (size_t i = 0; i < subMeshIndices.size(); ++i)
+		{
+			subMeshes[i].firstIndex = header.totalIndexCount;
+			subMeshes[i].indexCount = (uint32_t)subMeshIndices[i].size();
+			header.totalIndexCount += subMeshes[i].indexCount;
+
+			for (size_t j = 0; j < subMeshIndices[i].size(); ++j)
+			{
+				if (subMeshIndices[i][j] >= vertexCount)
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Write || Sub mesh {} indexes vertex {} but there are only {}!\n",
+						i, subMeshIndices[i][j], vertexCount);
+					return false;
+				}
+			}
+
+			subMeshBounds[i] = MeshBounds_Compute(vertices, vertexCount, subMeshIndices[i].data(), subMeshIndices[i].size());
+			memcpy(subMeshes[i].aabbMin, &subMeshBounds[i].aabb.min, sizeof(float) * 3);
+			memcpy(subMeshes[i].aabbMax, &subMeshBounds[i].aabb.max, sizeof(float) * 3);
+			memcpy(subMeshes[i].sphere, &subMeshBounds[i].sphere.center, sizeof(float) * 3);
+			subMeshes[i].sphere[3] = subMeshBounds[i].sphere.radius;
+		}
+
+		const MeshBounds meshBounds = MeshBounds_Merge(subMeshBounds);
+		memcpy(header.aabbMin, &meshBounds.aabb.min, sizeof(float) * 3);
+		memcpy(header.aabbMax, &meshBounds.aabb.max, sizeof(float) * 3);
+		memcpy(header.sphere, &meshBounds.sphere.center, sizeof(float) * 3);
+		header.sphere[3] = meshBounds.sphere.radius;
+
+		//lays out the sections
+		const uint64_t indexSize = (header.indexType == BinaryMeshIndexType::UInt16 ? 2 : 4);
+		header.subMeshTableOffset = sizeof(BinaryMeshHeader);
+		header.vertexDataOffset = BinaryMesh_AlignOffset(header.subMeshTableOffset + subMeshes.size() * sizeof(BinaryMeshSubMesh));
+		header.vertexDataSize = (uint64_t)vertexCount * vertexStride;
+		header.indexDataOffset = BinaryMesh_AlignOffset(header.vertexDataOffset + header.vertexDataSize);
+		header.indexDataSize = (uint64_t)header.totalIndexCount * indexSize;
+
+		std::vector<uint8_t> file(header.indexDataOffset + header.indexDataSize, 0);
+		if (!subMeshes.empty())
+			memcpy(file.data() + header.subMeshTableOffset, subMeshes.data(), subMeshes.size() * sizeof(BinaryMeshSubMesh));
+		memcpy(file.data() + header.vertexDataOffset, vertices, header.vertexDataSize);
+
+		uint8_t* indexData = file.data() + header.indexDataOffset;
+		size_t writtenIndices = 0;
+		for (size_t i = 0; i < subMeshIndices.size(); ++i)
+		{
+			for (size_t j = 0; j < subMeshIndices[i].size(); ++j, ++writtenIndices)
+			{
+				if (header.indexType == BinaryMeshIndexType::UInt16)
+					((uint16_t*)indexData)[writtenIndices] = (uint16_t)subMeshIndices[i][j];
+				else
+					((uint32_t*)indexData)[writtenIndices] = subMeshIndices[i][j];
+			}
+		}
+
+		if (writeChecksum)
+		{
+			header.flags |= BINARY_MESH_FLAG_HAS_CHECKSUM;
+			header.checksum = BinaryMesh_Checksum(file.data() + sizeof(BinaryMeshHeader), file.size() - sizeof(BinaryMeshHeader));
+		}
+		memcpy(file.data(), &header, sizeof(BinaryMeshHeader));
+
+		std::ofstream output(filepath, std::ios::binary | std::ios::trunc);
+		if (!output.is_open())
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ASSET ERROR: Binary Mesh || BinaryMesh_Write || Failed to open \"{}\" for writing!\n", filepath);
+			return false;
+		}
+		output.write((const char*)file.data(), (std::streamsize)file.size());
+		return output.good();
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+//defines the bounds of a static mesh, computed from the vertex and index data by the mesh converter and stored in the .pmesh
+
+#include <Smok/Assets/Mesh.hpp>
+
+#include <fmt/color.h>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <cfloat>
+#include <vector>
+
+namespace Pong3D::Asset
+{
+	//defines a axis aligned bounding box
+	struct AABB
+	{
+		glm::vec3 min = glm::vec3(FLT_MAX);
+		glm::vec3 max = glm::vec3(-FLT_MAX);
+
+		//grows the box to hold the point
+		inline void Expand(const glm::vec3& point)
+		{
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+
+		//is anything in the box
+		inline bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+		inline glm::vec3 Center() const { return (min + max) * 0.5f; }
+	};
+
+	//defines a bounding sphere, a negative radius means there are no bounds
+	struct BoundingSphere
+	{
+		glm::vec3 center = glm::vec3(0.0f);
+		float radius = -1.0f;
+	};
+
+	//defines the bounds of a mesh or sub mesh
+	struct MeshBounds
+	{
+		AABB aabb;
+		BoundingSphere sphere;
+	};
+
+	//defines the bounds of a static mesh and each of its sub meshes
+	struct StaticMeshBounds
+	{
+		MeshBounds mesh;
+		std::vector<MeshBounds> subMeshes;
+	};
+
+	//the size of a vertex in a .smesh, the position is the first thing in it
+	static constexpr size_t SMESH_VERTEX_STRIDE = sizeof(Smok::Asset::Mesh::Vertex);
+
+	//gets the position of a vertex
+	inline glm::vec3 MeshBounds_GetPosition(const uint8_t* vertices, size_t vertexIndex)
+	{
+		const float* position = (const float*)(vertices + vertexIndex * SMESH_VERTEX_STRIDE);
+		return glm::vec3(position[0], position[1], position[2]);
+	}
+
+	//computes the bounds of the vertices the indices use, the sphere is centered on the box and holds every vertex
+	inline MeshBounds MeshBounds_Compute(const uint8_t* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+	{
+		MeshBounds bounds;
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			if (indices[i] < vertexCount)
+				bounds.aabb.Expand(MeshBounds_GetPosition(vertices, indices[i]));
+		}
+		if (!bounds.aabb.IsValid())
+			return bounds;
+
+		bounds.sphere.center = bounds.aabb.Center();
+		float radiusSquared = 0.0f;
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			if (indices[i] >= vertexCount)
+				continue;
+
+			const glm::vec3 offset = MeshBounds_GetPosition(vertices, indices[i]) - bounds.sphere.center;
+			const float distanceSquared = glm::dot(offset, offset);
+			if (distanceSquared > radiusSquared)
+				radiusSquared = distanceSquared;
+		}
+		bounds.sphere.radius = sqrtf(radiusSquared);
+
+		return bounds;
+	}
+
+	//merges the bounds of the sub meshes into the bounds of the whole mesh
+	inline MeshBounds MeshBounds_Merge(const std::vector<MeshBounds>& subMeshes)
+	{
+		MeshBounds bounds;
+		for (size_t i = 0; i < subMeshes.size(); ++i)
+		{
+			if (!subMeshes[i].aabb.IsValid())
+				continue;
+			bounds.aabb.Expand(subMeshes[i].aabb.min);
+			bounds.aabb.Expand(subMeshes[i].aabb.max);
+		}
+		if (!bounds.aabb.IsValid())
+			return bounds;
+
+		//the sphere that holds every sub mesh's sphere
+		bounds.sphere.center = bounds.aabb.Center();
+		bounds.sphere.radius = 0.0f;
+		for (size_t i = 0; i < subMeshes.size(); ++i)
+		{
+			if (subMeshes[i].sphere.radius < 0.0f)
+				continue;
+
+			const float reach = glm::length(subMeshes[i].sphere.center - bounds.sphere.center) + subMeshes[i].sphere.radius;
+			if (reach > bounds.sphere.radius)
+				bounds.sphere.radius = reach;
+		}
+
+		return bounds;
+	}
+}
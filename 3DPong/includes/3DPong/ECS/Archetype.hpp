@@ -0,0 +1,222 @@
+#pragma once
+
+//defines the archetype storage for renderable entities, every entity with a transform and a mesh is packed into fixed size chunks
+//each chunk keeps its components as parallel arrays so the systems walk them linearly instead of looking up each entity
+
+#include <3DPong/ECS/EntityPool.hpp>
+
+//the dedicated server links neither Smok nor BTDSTD, PONG3D_SERVER swaps their components for plain structs with the fields the simulation uses
+#if !defined(PONG3D_SERVER)
+#include <Smok/Components/MeshComponent.hpp>
+#include <Smok/Components/Transform.hpp>
+#endif
+
+#include <fmt/color.h>
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Pong3D::ECS
+{
+#if !defined(PONG3D_SERVER)
+	using TransformComponent = Smok::ECS::Comp::Transform;
+	using MeshRenderComponent = Smok::ECS::Comp::MeshRender;
+#else
+	//defines the transform of a renderable on the server
+	struct TransformComponent
+	{
+		glm::vec3 position = glm::vec3(0.0f), rotation = glm::vec3(0.0f), scale = glm::vec3(1.0f);
+		bool isDirty = false;
+	};
+
+	//defines the mesh of a renderable on the server, it's only replicated
+	struct MeshRenderComponent
+	{
+		uint64_t staticMeshID = 0, pipelineID = 0, pipelineLayoutID = 0;
+	};
+#endif
+
+	//how many entities fit in a chunk
+	static constexpr uint32_t RENDERABLE_CHUNK_CAPACITY = 1024;
+
+	//defines a chunk of renderables, the first count slots are in use
+	struct RenderableChunk
+	{
+		uint32_t count = 0;
+		uint32_t dirtyCount = 0; //how many slots have a changed transform, the transform sync skips chunks with none
+
+		std::array<uint64_t, RENDERABLE_CHUNK_CAPACITY> entityIDs;
+
+		//transform
+		std::array<glm::vec3, RENDERABLE_CHUNK_CAPACITY> positions;
+		std::array<glm::vec3, RENDERABLE_CHUNK_CAPACITY> rotations;
+		std::array<glm::vec3, RENDERABLE_CHUNK_CAPACITY> scales;
+		std::array<uint8_t, RENDERABLE_CHUNK_CAPACITY> isDirty;
+
+		//mesh render
+		std::array<uint64_t, RENDERABLE_CHUNK_CAPACITY> staticMeshIDs;
+		std::array<uint64_t, RENDERABLE_CHUNK_CAPACITY> pipelineIDs;
+		std::array<uint64_t, RENDERABLE_CHUNK_CAPACITY> pipelineLayoutIDs;
+
+#if !defined(PONG3D_SERVER)
+		//generates the model matrix of a slot the same way the transform component does
+		inline glm::mat4 ModelMatrix(uint32_t index) const
+		{
+			TransformComponent transform;
+			transform.position = positions[index];
+			transform.rotation = rotations[index];
+			transform.scale = scales[index];
+			return transform.ModelMatrix();
+		}
+#endif
+	};
+
+	//defines a reference to a renderable's slot, only valid until a renderable is removed from the archetype
+	struct RenderableRef
+	{
+		RenderableChunk* chunk = nullptr;
+		uint32_t index = 0;
+
+		inline bool IsValid() const { return chunk != nullptr; }
+
+		inline uint64_t EntityID() const { return chunk->entityIDs[index]; }
+		inline glm::vec3& Position() const { return chunk->positions[index]; }
+		inline glm::vec3& Rotation() const { return chunk->rotations[index]; }
+		inline glm::vec3& Scale() const { return chunk->scales[index]; }
+	};
+
+	//defines the renderable archetype
+	struct RenderableArchetype
+	{
+		//only the last chunk in use has free slots, the chunks never move once made
+		//one empty chunk is kept past it so spawning and despawning around a chunk's edge doesn't allocate
+		std::vector<std::unique_ptr<RenderableChunk>> chunks;
+		size_t chunksInUse = 0;
+
+		//where each entity is, by its entity pool slot. Only for adding, removing and marking, the systems walk the chunks
+		std::vector<RenderableRef> entityLookup;
+
+		size_t count = 0;
+
+		//reserves the lookup for a number of entity slots
+		inline void Reserve(size_t entitySlotCount) { entityLookup.reserve(entitySlotCount); }
+
+		//gets how many renderables there are
+		inline size_t GetCount() const { return count; }
+
+		//adds a renderable, returns a invalid reference if the entity is already in the archetype
+		inline RenderableRef Add(uint64_t entityID, const TransformComponent& transform, const MeshRenderComponent& meshRenderer)
+		{
+			if (Find(entityID).IsValid())
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE ECS WARNING: Renderable Archetype || Add || Entity {} is already a renderable!\n", entityID);
+				return RenderableRef();
+			}
+
+			if (chunksInUse == 0 || chunks[chunksInUse - 1]->count == RENDERABLE_CHUNK_CAPACITY)
+			{
+				if (chunksInUse == chunks.size())
+					chunks.emplace_back(std::make_unique<RenderableChunk>());
+				chunksInUse++;
+			}
+
+			RenderableRef ref;
+			ref.chunk = chunks[chunksInUse - 1].get();
+			ref.index = ref.chunk->count++;
+
+			ref.chunk->entityIDs[ref.index] = entityID;
+			ref.chunk->positions[ref.index] = transform.position;
+			ref.chunk->rotations[ref.index] = transform.rotation;
+			ref.chunk->scales[ref.index] = transform.scale;
+			ref.chunk->isDirty[ref.index] = 0; //the renderer reads the starting transform when the draw is added
+			ref.chunk->staticMeshIDs[ref.index] = meshRenderer.staticMeshID;
+			ref.chunk->pipelineIDs[ref.index] = meshRenderer.pipelineID;
+			ref.chunk->pipelineLayoutIDs[ref.index] = meshRenderer.pipelineLayoutID;
+
+			const uint32_t slot = Entity_GetIndex(entityID);
+			if (slot >= entityLookup.size())
+				entityLookup.resize((size_t)slot + 1);
+			entityLookup[slot] = ref;
+
+			count++;
+			return ref;
+		}
+
+		//removes a renderable, the last renderable is moved into its slot so the chunks stay packed
+		inline bool Remove(uint64_t entityID)
+		{
+			const RenderableRef removed = Find(entityID);
+			if (!removed.IsValid())
+				return false;
+			entityLookup[Entity_GetIndex(entityID)] = RenderableRef();
+
+			RenderableChunk* lastChunk = chunks[chunksInUse - 1].get();
+			const uint32_t lastIndex = lastChunk->count - 1;
+			if (removed.chunk->isDirty[removed.index])
+				removed.chunk->dirtyCount--;
+
+			if (removed.chunk != lastChunk || removed.index != lastIndex)
+			{
+				RenderableChunk* dst = removed.chunk; const uint32_t d = removed.index;
+				dst->entityIDs[d] = lastChunk->entityIDs[lastIndex];
+				dst->positions[d] = lastChunk->positions[lastIndex];
+				dst->rotations[d] = lastChunk->rotations[lastIndex];
+				dst->scales[d] = lastChunk->scales[lastIndex];
+				dst->isDirty[d] = lastChunk->isDirty[lastIndex];
+				dst->staticMeshIDs[d] = lastChunk->staticMeshIDs[lastIndex];
+				dst->pipelineIDs[d] = lastChunk->pipelineIDs[lastIndex];
+				dst->pipelineLayoutIDs[d] = lastChunk->pipelineLayoutIDs[lastIndex];
+
+				//the dirty count follows the slot
+				if (lastChunk->isDirty[lastIndex])
+				{
+					lastChunk->dirtyCount--;
+					dst->dirtyCount++;
+				}
+
+				entityLookup[Entity_GetIndex(dst->entityIDs[d])] = removed;
+			}
+
+			//a chunk that empties becomes the spare, a spare that was already there is freed
+			lastChunk->count--;
+			if (lastChunk->count == 0)
+			{
+				chunksInUse--;
+				if (chunks.size() > chunksInUse + 1)
+					chunks.pop_back();
+			}
+
+			count--;
+			return true;
+		}
+
+		//gets a renderable, returns a invalid reference if the entity isn't in the archetype
+		inline RenderableRef Find(uint64_t entityID) const
+		{
+			const uint32_t slot = Entity_GetIndex(entityID);
+			if (slot >= entityLookup.size())
+				return RenderableRef();
+
+			//the slot may have been reused by a newer entity
+			const RenderableRef ref = entityLookup[slot];
+			return (ref.IsValid() && ref.chunk->entityIDs[ref.index] == entityID ? ref : RenderableRef());
+		}
+
+		//marks a renderable's transform as changed so the transform sync picks it up, returns the renderable to be changed
+		inline RenderableRef MarkDirty(uint64_t entityID)
+		{
+			RenderableRef ref = Find(entityID);
+			if (ref.IsValid() && !ref.chunk->isDirty[ref.index])
+			{
+				ref.chunk->isDirty[ref.index] = 1;
+				ref.chunk->dirtyCount++;
+			}
+
+			return ref;
+		}
+	};
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+//defines the entity pool, entities are a 32 bit slot index and a 32 bit generation packed into the 64 bit ID the ECS uses
+//a destroyed entity's slot goes on a free list and is reused with the next generation, so old IDs never match the new entity
+
+#include <fmt/color.h>
+
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Pong3D::ECS
+{
+	//defines a flag for differant entity types
+	enum class EntityFlag : uint8_t
+	{
+		Camera = 0x00, //defines a camera
+
+		Paddle, //defines a paddle bar, the thing the player controls
+
+		Ball, //defines a ball
+
+		Count
+	};
+
+	//packs a entity's slot index and generation into its ID, generations start at 1 so a ID is never 0
+	inline uint64_t Entity_PackID(uint32_t index, uint32_t generation) { return ((uint64_t)generation << 32) | (uint64_t)index; }
+
+	//gets the slot index of a entity ID
+	inline uint32_t Entity_GetIndex(uint64_t ID) { return (uint32_t)(ID & 0xFFFFFFFF); }
+
+	//gets the generation of a entity ID
+	inline uint32_t Entity_GetGeneration(uint64_t ID) { return (uint32_t)(ID >> 32); }
+
+	//defines a entity
+	struct Entity
+	{
+		uint64_t ID = 0; //the ID associated with this entity, 0 is never a live entity
+
+		EntityFlag flag = EntityFlag::Count; //defines the flag for entity type
+	};
+
+	//defines a entity pool
+	struct EntityPool
+	{
+		//per slot, the generation is bumped when the slot's entity is destroyed
+		std::vector<uint32_t> generations;
+		std::vector<EntityFlag> flags;
+		std::vector<uint32_t> liveIndices; //where the slot's entity is in its flag's live list
+
+		std::vector<uint32_t> freeSlots; //destroyed slots, reused last in first out so the memory is warm
+
+		//the live entity IDs of each flag, packed so they can be walked without a check per slot
+		std::vector<uint64_t> liveEntities[(size_t)EntityFlag::Count];
+
+		std::unordered_map<uint32_t, std::string> names; //by slot, only the entities given a name are in here
+
+		//reserves the slots and live lists for a number of entities, so spawning up to it never allocates
+		inline void Reserve(size_t entityCount)
+		{
+			generations.reserve(entityCount); flags.reserve(entityCount); liveIndices.reserve(entityCount);
+			freeSlots.reserve(entityCount);
+			for (size_t i = 0; i < (size_t)EntityFlag::Count; ++i)
+				liveEntities[i].reserve(entityCount);
+		}
+
+		//creates a entity, the name is optional and only kept for debugging and lookup by name
+		inline Entity Create(EntityFlag flag, const std::string& name = "")
+		{
+			if (flag == EntityFlag::Count)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE ECS ERROR: Entity Pool || Create || EntityFlag::Count is not a entity type!\n");
+				return Entity();
+			}
+
+			uint32_t index = 0;
+			if (!freeSlots.empty())
+			{
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				index = (uint32_t)generations.size();
+				generations.emplace_back(1);
+				flags.emplace_back(EntityFlag::Count);
+				liveIndices.emplace_back(0);
+			}
+
+			Entity entity;
+			entity.ID = Entity_PackID(index, generations[index]);
+			entity.flag = flag;
+
+			std::vector<uint64_t>& live = liveEntities[(size_t)flag];
+			flags[index] = flag;
+			liveIndices[index] = (uint32_t)live.size();
+			live.emplace_back(entity.ID);
+
+			if (!name.empty())
+				names[index] = name;
+
+			return entity;
+		}
+
+		//destroys a entity, returns false if it was already destroyed
+		inline bool Destroy(uint64_t ID)
+		{
+			if (!IsAlive(ID))
+				return false;
+
+			const uint32_t index = Entity_GetIndex(ID);
+
+			//moves the last live entity of the flag into the hole
+			std::vector<uint64_t>& live = liveEntities[(size_t)flags[index]];
+			const uint32_t liveIndex = liveIndices[index];
+			live[liveIndex] = live.back();
+			liveIndices[Entity_GetIndex(live[liveIndex])] = liveIndex;
+			live.pop_back();
+
+			//a slot that has used every generation is retired instead of wrapping back to a old ID
+			flags[index] = EntityFlag::Count;
+			if (++generations[index] != 0)
+				freeSlots.emplace_back(index);
+
+			if (!names.empty())
+				names.erase(index);
+
+			return true;
+		}
+
+		//checks if a entity is alive
+		inline bool IsAlive(uint64_t ID) const
+		{
+			const uint32_t index = Entity_GetIndex(ID);
+			return index < generations.size() && generations[index] == Entity_GetGeneration(ID) && flags[index] != EntityFlag::Count;
+		}
+
+		//gets the flag of a entity, EntityFlag::Count if it isn't alive
+		inline EntityFlag GetFlag(uint64_t ID) const { return (IsAlive(ID) ? flags[Entity_GetIndex(ID)] : EntityFlag::Count); }
+
+		//gets the name of a entity, empty if it wasn't given one or isn't alive
+		inline std::string GetName(uint64_t ID) const
+		{
+			if (!IsAlive(ID))
+				return std::string();
+
+			auto it = names.find(Entity_GetIndex(ID));
+			return (it == names.end() ? std::string() : it->second);
+		}
+
+		//finds a live entity by name, slow since it walks every name. Returns 0 if there isn't one
+		inline uint64_t FindByName(const std::string& name) const
+		{
+			for (auto it = names.begin(); it != names.end(); ++it)
+			{
+				if (it->second == name)
+					return Entity_PackID(it->first, generations[it->first]);
+			}
+
+			return 0;
+		}
+
+		//gets the live entities of a flag without copying them, the view is only valid until a entity of the flag is created or destroyed
+		inline std::span<const uint64_t> GetLive(EntityFlag flag) const
+		{
+			if (flag == EntityFlag::Count)
+				return std::span<const uint64_t>();
+
+			return std::span<const uint64_t>(liveEntities[(size_t)flag]);
+		}
+
+		//gets how many entities are alive
+		inline size_t GetLiveCount() const
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < (size_t)EntityFlag::Count; ++i)
+				count += liveEntities[i].size();
+			return count;
+		}
+	};
+}
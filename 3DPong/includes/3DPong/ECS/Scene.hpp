@@ -2,98 +2,150 @@
 
 //defines a scene since scenes are not structures in Smok, every game will define their own that generates the render data
 
-#include <BTDSTD/Maps/StringIDRegistery.hpp>
-
+//the dedicated server has no engine, PONG3D_SERVER compiles out everything that needs a GPU, Smok or the BTDSTD ECS
+#if !defined(PONG3D_SERVER)
 #include <3DPong/Engine.hpp>
+#else
+namespace Pong3D::Core { struct Engine; }
+#endif
+#include <3DPong/ECS/Archetype.hpp>
+#include <3DPong/ECS/EntityPool.hpp>
 
+#if !defined(PONG3D_SERVER)
 #include <Smok/Components/MeshComponent.hpp>
 #include <Smok/Components/Transform.hpp>
+#endif
 
 namespace Pong3D::Scene
 {
-	//defines a flag for differant entity types
-	enum class EntityFlag : uint8_t
-	{
-		Camera = 0x00, //defines a camera
-
-		Paddle, //defines a paddle bar, the thing the player controls
-
-		Ball, //defines a ball
-
-		Count
-	};
-
-	//defines a entity
-	struct Entity
-	{
-		uint64_t ID = 0; //the ID associated with this entity
-	
-		EntityFlag flag = EntityFlag::Count; //defines the flag for entity type
-	};
+	//the entities are made by the scene's entity pool
+	using EntityFlag = ECS::EntityFlag;
+	using Entity = ECS::Entity;
 
 	//defines a scene
 	struct Scene
 	{
 		bool isDirty = true; //has the scene itself changed
 
-		BTD::Map::IDStringRegistery registery; //the entity register, mapping a string name to a entity ID
+		ECS::EntityPool entityPool; //makes and recycles the entity IDs, names are optional and kept off to the side
 
-		std::vector<Entity> cameras; //the cameras, normally only one, but others are kept for the other riders for hot swapping perspectives
+		std::vector<uint64_t> dirtyTransforms; //the entities whose transform changed since the last transform sync
 
-		std::vector<Entity> entities; //the entities
-
-		Scene()
-		{
-			cameras.reserve(2);
-			entities.reserve(10);
-		}
+		//the renderable entities' transforms and meshes, the archetype owns them so they aren't in the ECS
+		ECS::RenderableArchetype renderables;
 
+#if !defined(PONG3D_SERVER)
 		//creates a camera
 		inline Entity Camera_Create(const std::string& name, const Smok::ECS::Comp::Transform& transform, const Smok::ECS::Comp::Camera& cameraSettings, Core::Engine* engine)
 		{
 			//creates ID
-			Entity cam;
-			cam.ID = registery.GenerateID(name);
-			cam.flag = EntityFlag::Camera;
-		
+			Entity cam = entityPool.Create(EntityFlag::Camera, name);
+
 			//creates components
 			BTD::ECS::addComponent(cam.ID, transform);
 			BTD::ECS::addComponent(cam.ID, cameraSettings);
 
 			//adds to world
 			isDirty = true;
-			return cameras.emplace_back(cam);
+			return cam;
 		}
+#endif
 
-		//deletes the main camera
-
-		//gets the main camera
+		//gets the main camera, the first one made that's still alive
+		inline Entity Camera_GetMain() const
+		{
+			const std::span<const uint64_t> cameras = entityPool.GetLive(EntityFlag::Camera);
+			Entity cam;
+			if (!cameras.empty())
+			{
+				cam.ID = cameras[0];
+				cam.flag = EntityFlag::Camera;
+			}
+			return cam;
+		}
 
 		//creates a renderable entity paddle
-		inline Entity CreateEntity_Paddle(const std::string& name, const Smok::ECS::Comp::Transform& transform, const Smok::ECS::Comp::MeshRender& meshRenderer, Core::Engine* engine)
+		inline Entity CreateEntity_Paddle(const std::string& name, const ECS::TransformComponent& transform, const ECS::MeshRenderComponent& meshRenderer, Core::Engine* engine)
+		{
+			return CreateEntity_Renderable(EntityFlag::Paddle, name, transform, meshRenderer);
+		}
+
+		//creates a renderable entity ball, the name is optional so spawning many doesn't build strings
+		inline Entity CreateEntity_Ball(const ECS::TransformComponent& transform, const ECS::MeshRenderComponent& meshRenderer, const std::string& name = "")
+		{
+			return CreateEntity_Renderable(EntityFlag::Ball, name, transform, meshRenderer);
+		}
+
+		//creates a renderable entity of any type
+		inline Entity CreateEntity_Renderable(EntityFlag flag, const std::string& name, const ECS::TransformComponent& transform, const ECS::MeshRenderComponent& meshRenderer)
 		{
 			//creates ID
-			Entity rider;
-			rider.ID = registery.GenerateID(name);
-			rider.flag = EntityFlag::Paddle;
+			Entity entity = entityPool.Create(flag, name);
+			if (!entity.ID)
+				return entity;
 
-			//creates components
-			BTD::ECS::addComponent(rider.ID, transform);
-			BTD::ECS::addComponent(rider.ID, meshRenderer);
+			//packs the transform and mesh with the other renderables
+			//the renderer reads the starting transform when the draw is added, only later changes need syncing
+			renderables.Add(entity.ID, transform, meshRenderer);
 
 			//adds to world
 			isDirty = true;
-			return entities.emplace_back(rider);
+			return entity;
 		}
 
-		//returns all the IDs of entities
-		inline std::vector<uint64_t> GetEntitiesAsIDs()
+		//destroys a entity, its ID is never reused. The render batches have to drop its draw with RenderOperationBatch::RemoveStaticMesh
+		//components the game added to the ECS itself are the game's to remove, cameras keep theirs in the ECS so they can't be destroyed yet
+		inline bool DestroyEntity(uint64_t entityID)
 		{
-			std::vector<uint64_t> entityIDs; const size_t entityCount = entities.size(); entityIDs.resize(entityCount);
-			for (size_t i = 0; i < entityCount; ++i)
-				entityIDs[i] = entities[i].ID;
+			const EntityFlag flag = entityPool.GetFlag(entityID);
+			if (flag == EntityFlag::Count)
+				return false;
+
+			if (flag == EntityFlag::Camera)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE SCENE WARNING: Scene || DestroyEntity || Cameras can not be destroyed!\n");
+				return false;
+			}
+
+			renderables.Remove(entityID);
+			entityPool.Destroy(entityID);
+			isDirty = true;
+			return true;
+		}
 
-			return entityIDs;
+		//checks if a entity is still alive
+		inline bool IsAlive(uint64_t entityID) const { return entityPool.IsAlive(entityID); }
+
+#if !defined(PONG3D_SERVER)
+		//marks a entity's transform as changed so the transform sync picks it up, returns the transform to be changed
+		//renderables keep their transform in the archetype, use Renderable_MarkDirty for them
+		inline Smok::ECS::Comp::Transform* Transform_MarkDirty(uint64_t entityID)
+		{
+			Smok::ECS::Comp::Transform* transform = BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(entityID);
+			if (!transform)
+				return nullptr;
+
+			//only queue it once until it's synced
+			if (!transform->isDirty)
+			{
+				transform->isDirty = true;
+				dirtyTransforms.emplace_back(entityID);
+			}
+
+			return transform;
+		}
+#endif
+
+		//marks a renderable's transform as changed so the transform sync picks it up, returns the renderable to be changed
+		inline ECS::RenderableRef Renderable_MarkDirty(uint64_t entityID)
+		{
+			return renderables.MarkDirty(entityID);
+		}
+
+		//gets the live entities of a type without copying them, only valid until a entity of that type is created or destroyed
+		inline std::span<const uint64_t> GetEntities(EntityFlag flag) const
+		{
+			return entityPool.GetLive(flag);
 		}
 	};
 }
\ No newline at end of file
@@ -2,13 +2,36 @@
 
 //defines a core engine
 
-#include <BTDSTD/Wireframe/Core/DesktopSwapchain.hpp>
+#include <3DPong/Platform/Headless.hpp>
+#include <3DPong/Platform/WindowSwapchain.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <BTDSTD/Wireframe/Core/DesktopWindow.hpp>
 #include <BTDSTD/ECS/ECSManager.hpp>
 
 #include <Smok/Memory/LifetimeDeleteQueue.hpp>
 
 namespace Pong3D::Core
 {
+	//the Vulkan version the engine asks for, the windowed and headless devices use the same one so they run the same paths
+	static constexpr uint32_t ENGINE_VULKAN_MAJOR_VERSION = 1, ENGINE_VULKAN_MINOR_VERSION = 3;
+
+	//defines the settings of the engine
+	struct Engine_CreateInfo
+	{
+		VkExtent2D size = { 1700, 900 };
+		const char* title = "Survial Game OwO";
+		bool isDebug = true;
+
+		//how the window's swapchain presents, it can be changed later through RecreateSwapchain
+		Platform::WindowSwapchain_CreateInfo swapchain;
+
+		//renders into offscreen images with no window, surface or present
+		bool isHeadless = false;
+		bool preferSoftwareDevice = false; //headless only, picks a CPU Vulkan driver
+		uint32_t headlessImageCount = 3;
+	};
+
 	//defines core engine
 	struct Engine
 	{
@@ -17,46 +40,78 @@ namespace Pong3D::Core
 		Wireframe::Window::DesktopWindow window;
 		Wireframe::Device::GPU GPU;
 		VmaAllocator _allocator;
-		Wireframe::Swapchain::DesktopSwapchain swapchain;
+		Platform::WindowSwapchain swapchain; //owned by the engine rather than Wireframe so it can be recreated and its present mode picked
+
+		//headless, the window and swapchain aren't created
+		bool isHeadless = false;
+		Platform::HeadlessDevice headlessDevice;
+		Platform::OffscreenSwapchain offscreenSwapchain;
 
 		//---ECS subsystem data for all components
 
 		//creates engine
-		inline bool Init()
+		inline bool Init(const Engine_CreateInfo& info = Engine_CreateInfo())
 		{
+			PONG3D_PROFILE_ZONE("Engine Init");
+			isHeadless = info.isHeadless;
+
 			//creates Window
-			Wireframe::Window::DesktopWindow_CreateInfo windowInfo;
-			windowInfo.size = { 1700 , 900 }; windowInfo.title = "Survial Game OwO";
-			if (!window.Create(windowInfo))
-				return false;
-			engineObjectDeleteQueue.push_function([&]() {
-				window.Destroy();
-				});
+			if (!isHeadless)
+			{
+				PONG3D_PROFILE_ZONE("Create Window");
+				Wireframe::Window::DesktopWindow_CreateInfo windowInfo;
+				windowInfo.size = { info.size.width, info.size.height }; windowInfo.title = info.title;
+				if (!window.Create(windowInfo))
+					return false;
+				engineObjectDeleteQueue.push_function([&]() {
+					window.Destroy();
+					});
+			}
 
 			//creates GPU
-			Wireframe::Device::GPU_CreateInfo GPUInfo;
-
-			GPUInfo.isDebug = true;
-
-			GPUInfo.vulkanMajorVersion = 1;
-			GPUInfo.vulkanMinorVersion = 3;
-
-			//vulkan 1.3 features
-			//GPUInfo.specific13FeaturesNeeded = true;
-			//GPUInfo.features13.dynamicRendering = true;
-			//GPUInfo.features13.synchronization2 = true;
-
-			//vulkan 1.2 features
-			GPUInfo.specific12FeaturesNeeded = true;
-			GPUInfo.features12.bufferDeviceAddress = true;
-			GPUInfo.features12.descriptorIndexing = true;
-
-			if (!GPU.Create(GPUInfo, &window))
-				return false;
-			engineObjectDeleteQueue.push_function([&]() {
-				window.DestroySurface(GPU.instance);
-				GPU.Destroy();
-				});
+			if (isHeadless)
+			{
+				PONG3D_PROFILE_ZONE("Create GPU");
+				Platform::HeadlessDevice_CreateInfo headlessInfo;
+				headlessInfo.isDebug = info.isDebug;
+				headlessInfo.preferSoftwareDevice = info.preferSoftwareDevice;
+				headlessInfo.vulkanMajorVersion = ENGINE_VULKAN_MAJOR_VERSION;
+				headlessInfo.vulkanMinorVersion = ENGINE_VULKAN_MINOR_VERSION;
+				headlessInfo.features12.bufferDeviceAddress = true;
+				headlessInfo.features12.descriptorIndexing = true;
+				if (!headlessDevice.Create(headlessInfo, &GPU))
+					return false;
+				engineObjectDeleteQueue.push_function([&]() {
+					headlessDevice.Destroy();
+					});
+			}
+			else
+			{
+				PONG3D_PROFILE_ZONE("Create GPU");
+				Wireframe::Device::GPU_CreateInfo GPUInfo;
+
+				GPUInfo.isDebug = info.isDebug;
+
+				GPUInfo.vulkanMajorVersion = ENGINE_VULKAN_MAJOR_VERSION;
+				GPUInfo.vulkanMinorVersion = ENGINE_VULKAN_MINOR_VERSION;
+
+				//vulkan 1.3 features
+				//GPUInfo.specific13FeaturesNeeded = true;
+				//GPUInfo.features13.dynamicRendering = true;
+				//GPUInfo.features13.synchronization2 = true;
+
+				//vulkan 1.2 features
+				GPUInfo.specific12FeaturesNeeded = true;
+				GPUInfo.features12.bufferDeviceAddress = true;
+				GPUInfo.features12.descriptorIndexing = true;
+
+				if (!GPU.Create(GPUInfo, &window))
+					return false;
+				engineObjectDeleteQueue.push_function([&]() {
+					window.DestroySurface(GPU.instance);
+					GPU.Destroy();
+					});
+			}
 
 			//initialize the memory allocator
 			VmaAllocatorCreateInfo allocatorInfo = {};
@@ -90,23 +145,68 @@ namespace Pong3D::Core
 				VMFuncs.vkGetPhysicalDeviceMemoryProperties2KHR = vkGetPhysicalDeviceMemoryProperties2,
 				allocatorInfo.pVulkanFunctions = &VMFuncs;
 
-			vmaCreateAllocator(&allocatorInfo, &_allocator);
+			{
+				PONG3D_PROFILE_ZONE("Create Allocator");
+				vmaCreateAllocator(&allocatorInfo, &_allocator);
+			}
 			engineObjectDeleteQueue.push_function([&]() {
 				vmaDestroyAllocator(_allocator);
 				});
 
 
-			//creates swapchain
-			Wireframe::Swapchain::DesktopSwapchain_CreateInfo info;
-			if (!swapchain.Create(info, &GPU, &window, _allocator))
+			//creates swapchain, or the images that stand in for it
+			if (isHeadless)
+			{
+				PONG3D_PROFILE_ZONE("Create Swapchain");
+				if (!offscreenSwapchain.Create(&GPU, _allocator, info.size, info.headlessImageCount))
+					return false;
+				engineObjectDeleteQueue.push_function([&]() {
+					offscreenSwapchain.Destroy(&GPU, _allocator);
+					});
+			}
+			else
+			{
+				PONG3D_PROFILE_ZONE("Create Swapchain");
+				if (!swapchain.Create(info.swapchain, &GPU, window._surface, _allocator, window._windowExtent))
+					return false;
+				window._windowExtent = swapchain.extent;
+				engineObjectDeleteQueue.push_function([&]() {
+					swapchain.Destroy(&GPU, _allocator);
+					});
+			}
+
+			return true;
+		}
+
+		//recreates the window's swapchain at the surface's current size, the GPU must be done with every frame using it
+		//returns false without touching it while the window is minimized, there's nothing to present to
+		inline bool RecreateSwapchain(const Platform::WindowSwapchain_CreateInfo& info)
+		{
+			if (isHeadless)
+				return false;
+
+			const VkExtent2D extent = swapchain.GetSurfaceExtent(&GPU, window._windowExtent);
+			if (extent.width == 0 || extent.height == 0)
 				return false;
-			engineObjectDeleteQueue.push_function([&]() {
-				swapchain.Destroy(&GPU, _allocator);
-				});
 
+			if (!swapchain.Recreate(info, &GPU, _allocator, extent))
+				return false;
+			window._windowExtent = swapchain.extent;
 			return true;
 		}
 
+		//gets the size frames are rendered at
+		inline VkExtent2D GetRenderExtent() const { return (isHeadless ? offscreenSwapchain.extent : window._windowExtent); }
+
+		//gets the format of the images frames are rendered into
+		inline VkFormat GetColorFormat() const { return (isHeadless ? offscreenSwapchain._swapchainImageFormat : swapchain._swapchainImageFormat); }
+		inline VkFormat GetDepthFormat() const { return (isHeadless ? offscreenSwapchain._depthFormat : swapchain._depthFormat); }
+
+		//gets the images frames are rendered into
+		inline size_t GetColorImageCount() const { return (isHeadless ? offscreenSwapchain.colorImageViews.size() : swapchain._swapchainImages.size()); }
+		inline VkImageView* GetColorImageViews() { return (isHeadless ? offscreenSwapchain.colorImageViews.data() : swapchain._swapchainImageViews.data()); }
+		inline VkImageView GetDepthImageView() const { return (isHeadless ? offscreenSwapchain.depthImage.view : swapchain.depthImage.view); }
+
 		//shutdown
 		inline void Shutdown()
 		{
@@ -0,0 +1,228 @@
+#pragma once
+
+//defines sampling the keyboard and game controllers from SDL's events, each is stamped with when it was pumped and queued for the simulation thread
+//SDL only lets the thread that made the window pump its events, so the main thread samples at the start of a frame and again right before recording
+
+#include <3DPong/Input/InputState.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <SDL.h>
+
+#include <fmt/color.h>
+
+namespace Pong3D::Input
+{
+	//defines the input sampler
+	struct InputSampler
+	{
+		InputQueue* simulationQueue = nullptr; //the events are pushed here as they're sampled, optional
+		InputState state; //the main thread's own copy, for the camera
+
+		//the open controllers by slot, and their SDL instance IDs to find the slot of a event
+		std::array<SDL_GameController*, INPUT_MAX_CONTROLLERS> controllers = {};
+		std::array<SDL_JoystickID, INPUT_MAX_CONTROLLERS> controllerIDs = {};
+
+		//the newest key or button press since the last TakeNewestPress, for the input to photon estimate
+		//it's the time of the sample before the one that pumped it, the press came in some time after that so the estimate is the worst case
+		std::chrono::steady_clock::time_point newestPressTime;
+		bool hasNewPress = false;
+
+		std::chrono::steady_clock::time_point lastSampleTime; //when the last Sample pumped
+
+		uint64_t sampledEvents = 0, droppedEvents = 0;
+		bool hasControllers = false; //the controller subsystem started, the keyboard works without it
+		bool isCreated = false;
+
+		//starts the controller subsystem and opens the controllers already plugged in
+		inline void Create(InputQueue* _simulationQueue = nullptr)
+		{
+			if (isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE INPUT WARNING: Input Sampler || Create || The sampler is already created!\n");
+				return;
+			}
+
+			simulationQueue = _simulationQueue;
+			controllerIDs.fill(-1);
+			isCreated = true;
+
+			hasControllers = (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) == 0);
+			if (!hasControllers)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE INPUT WARNING: Input Sampler || Create || Failed to start the game controllers, only the keyboard will work: {}\n", SDL_GetError());
+				return;
+			}
+
+			//plugged in controllers also come in as added events, opening them here just means they work on the first frame
+			for (int i = 0; i < SDL_NumJoysticks(); ++i)
+				OpenController(i);
+		}
+
+		//closes the controllers
+		inline void Destroy()
+		{
+			if (!isCreated)
+				return;
+
+			for (uint32_t c = 0; c < INPUT_MAX_CONTROLLERS; ++c)
+			{
+				if (controllers[c])
+					SDL_GameControllerClose(controllers[c]);
+			}
+			controllers.fill(nullptr);
+			if (hasControllers)
+				SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+			hasControllers = false;
+			isCreated = false;
+		}
+
+		//opens a controller by its joystick index into the first free slot, returns the slot or -1
+		inline int32_t OpenController(int joystickIndex)
+		{
+			if (!SDL_IsGameController(joystickIndex))
+				return -1;
+
+			//added events also come for the controllers opened in Create
+			const SDL_JoystickID ID = SDL_JoystickGetDeviceInstanceID(joystickIndex);
+			for (uint32_t c = 0; c < INPUT_MAX_CONTROLLERS; ++c)
+			{
+				if (controllers[c] && controllerIDs[c] == ID)
+					return (int32_t)c;
+			}
+
+			for (uint32_t c = 0; c < INPUT_MAX_CONTROLLERS; ++c)
+			{
+				if (controllers[c])
+					continue;
+
+				controllers[c] = SDL_GameControllerOpen(joystickIndex);
+				if (!controllers[c])
+					return -1;
+				controllerIDs[c] = ID;
+				return (int32_t)c;
+			}
+
+			fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE INPUT WARNING: Input Sampler || OpenController || Only {} controllers are supported!\n", INPUT_MAX_CONTROLLERS);
+			return -1;
+		}
+
+		//gets the slot of a controller by its SDL instance ID, -1 if it isn't open
+		inline int32_t GetControllerSlot(SDL_JoystickID ID) const
+		{
+			for (uint32_t c = 0; c < INPUT_MAX_CONTROLLERS; ++c)
+			{
+				if (controllers[c] && controllerIDs[c] == ID)
+					return (int32_t)c;
+			}
+			return -1;
+		}
+
+		//turns a SDL event into a input event, returns false if it isn't input
+		inline bool ToInputEvent(const SDL_Event& e, InputEvent& event)
+		{
+			switch (e.type)
+			{
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+				if (e.key.repeat)
+					return false;
+				event.type = (e.type == SDL_KEYDOWN ? InputEventType::KeyDown : InputEventType::KeyUp);
+				event.controller = 0;
+				event.code = (uint16_t)e.key.keysym.scancode;
+				return true;
+
+			case SDL_CONTROLLERBUTTONDOWN:
+			case SDL_CONTROLLERBUTTONUP:
+			{
+				const int32_t slot = GetControllerSlot(e.cbutton.which);
+				if (slot < 0)
+					return false;
+				event.type = (e.type == SDL_CONTROLLERBUTTONDOWN ? InputEventType::ButtonDown : InputEventType::ButtonUp);
+				event.controller = (uint8_t)slot;
+				event.code = (uint16_t)e.cbutton.button;
+				return true;
+			}
+
+			case SDL_CONTROLLERAXISMOTION:
+			{
+				const int32_t slot = GetControllerSlot(e.caxis.which);
+				if (slot < 0)
+					return false;
+				event.type = InputEventType::Axis;
+				event.controller = (uint8_t)slot;
+				event.code = (uint16_t)e.caxis.axis;
+				event.value = (e.caxis.value < -32767 ? -1.0f : (float)e.caxis.value / 32767.0f);
+				return true;
+			}
+
+			case SDL_CONTROLLERDEVICEADDED:
+				OpenController(e.cdevice.which);
+				return false;
+
+			case SDL_CONTROLLERDEVICEREMOVED:
+			{
+				const int32_t slot = GetControllerSlot(e.cdevice.which);
+				if (slot < 0)
+					return false;
+				SDL_GameControllerClose(controllers[slot]);
+				controllers[slot] = nullptr;
+				controllerIDs[slot] = -1;
+				event.type = InputEventType::ControllerRemoved;
+				event.controller = (uint8_t)slot;
+				return true;
+			}
+
+			default:
+				return false;
+			}
+		}
+
+		//pumps SDL's events, the input is applied to the state and queued for the simulation thread
+		//every event, input or not, is handed to onEvent after, the window and widgets still need them
+		template<typename EventHandler>
+		inline void Sample(EventHandler&& onEvent)
+		{
+			PONG3D_PROFILE_ZONE("Input Sample");
+
+			//SDL2 stamps a event when the pump below queues it, not when the OS got it, so SDL's timestamp can't tell how long it waited
+			//the events are stamped with the pump's time, a press is only known to have come in since the last sample
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			const std::chrono::steady_clock::time_point pressTime = (lastSampleTime == std::chrono::steady_clock::time_point() ? now : lastSampleTime);
+			lastSampleTime = now;
+
+			SDL_Event e;
+			while (SDL_PollEvent(&e) != 0)
+			{
+				InputEvent event;
+				if (ToInputEvent(e, event))
+				{
+					event.time = now;
+
+					state.Apply(event);
+					if (simulationQueue && !simulationQueue->Push(event))
+						droppedEvents++;
+					sampledEvents++;
+
+					if (event.type == InputEventType::KeyDown || event.type == InputEventType::ButtonDown)
+					{
+						newestPressTime = pressTime;
+						hasNewPress = true;
+					}
+				}
+
+				onEvent(e);
+			}
+		}
+
+		//takes the time of the newest press since the last call, returns false if there wasn't one
+		inline bool TakeNewestPress(std::chrono::steady_clock::time_point& pressTime)
+		{
+			if (!hasNewPress)
+				return false;
+
+			pressTime = newestPressTime;
+			hasNewPress = false;
+			return true;
+		}
+	};
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+//defines the input events the sampler timestamps and queues, and the state of the keys and controllers built back up from them
+//nothing here needs SDL so the simulation thread can read the input, the codes are SDL's scancodes and game controller buttons and axes
+
+#include <3DPong/Threading/SPSCQueue.hpp>
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <vector>
+
+namespace Pong3D::Input
+{
+	//the limits of the input state
+	static constexpr size_t INPUT_KEY_COUNT = 512; //SDL_NUM_SCANCODES
+	static constexpr uint32_t INPUT_MAX_CONTROLLERS = 4;
+	static constexpr size_t INPUT_CONTROLLER_BUTTON_COUNT = 32; //past SDL_CONTROLLER_BUTTON_MAX
+	static constexpr size_t INPUT_CONTROLLER_AXIS_COUNT = 6; //SDL_CONTROLLER_AXIS_MAX
+
+	//how many events can wait for the simulation thread, a few seconds of a controller's stick at its fastest
+	static constexpr size_t INPUT_QUEUE_CAPACITY = 4096;
+
+	//defines the type of a input event
+	enum class InputEventType : uint8_t
+	{
+		KeyDown = 0,
+		KeyUp,
+		ButtonDown,
+		ButtonUp,
+		Axis, //value is -1 to 1
+		ControllerRemoved, //everything the controller held is let go
+
+		Count
+	};
+
+	//defines a input event, stamped with when the sampler pumped it
+	struct InputEvent
+	{
+		std::chrono::steady_clock::time_point time;
+		InputEventType type = InputEventType::KeyDown;
+		uint8_t controller = 0; //the controller's slot, keys are 0
+		uint16_t code = 0; //the scancode, button or axis
+		float value = 0.0f;
+	};
+
+	//the queue the sampler hands the events to another thread through
+	using InputQueue = Threading::SPSCQueue<InputEvent, INPUT_QUEUE_CAPACITY>;
+
+	//defines the state of the keys and controllers, built up by applying the events in order
+	struct InputState
+	{
+		std::bitset<INPUT_KEY_COUNT> keys;
+		std::array<std::bitset<INPUT_CONTROLLER_BUTTON_COUNT>, INPUT_MAX_CONTROLLERS> buttons;
+		std::array<std::array<float, INPUT_CONTROLLER_AXIS_COUNT>, INPUT_MAX_CONTROLLERS> axes = {};
+
+		//applies a event
+		inline void Apply(const InputEvent& event)
+		{
+			switch (event.type)
+			{
+			case InputEventType::KeyDown:
+			case InputEventType::KeyUp:
+				if (event.code < INPUT_KEY_COUNT)
+					keys[event.code] = (event.type == InputEventType::KeyDown);
+				break;
+
+			case InputEventType::ButtonDown:
+			case InputEventType::ButtonUp:
+				if (event.controller < INPUT_MAX_CONTROLLERS && event.code < INPUT_CONTROLLER_BUTTON_COUNT)
+					buttons[event.controller][event.code] = (event.type == InputEventType::ButtonDown);
+				break;
+
+			case InputEventType::Axis:
+				if (event.controller < INPUT_MAX_CONTROLLERS && event.code < INPUT_CONTROLLER_AXIS_COUNT)
+					axes[event.controller][event.code] = event.value;
+				break;
+
+			case InputEventType::ControllerRemoved:
+				if (event.controller < INPUT_MAX_CONTROLLERS)
+				{
+					buttons[event.controller].reset();
+					axes[event.controller].fill(0.0f);
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		//checks if a key is held, 0 is never held
+		inline bool IsKeyHeld(uint16_t scancode) const { return scancode != 0 && scancode < INPUT_KEY_COUNT && keys[scancode]; }
+
+		//checks if a controller's button is held
+		inline bool IsButtonHeld(uint32_t controller, uint16_t button) const
+		{
+			return controller < INPUT_MAX_CONTROLLERS && button < INPUT_CONTROLLER_BUTTON_COUNT && buttons[controller][button];
+		}
+
+		//gets a controller's axis, -1 to 1, inside the dead zone is 0
+		inline float GetAxis(uint32_t controller, uint16_t axis, float deadZone = 0.0f) const
+		{
+			if (controller >= INPUT_MAX_CONTROLLERS || axis >= INPUT_CONTROLLER_AXIS_COUNT)
+				return 0.0f;
+			const float value = axes[controller][axis];
+			return (value > deadZone || value < -deadZone ? value : 0.0f);
+		}
+	};
+
+	//defines what moves a paddle, a pair of keys and a game controller's stick or d-pad. Several can be bound for local players
+	struct PaddleBinding
+	{
+		uint32_t paddleIndex = 0; //the paddle in the physics world it moves
+
+		uint16_t upKey = 0, downKey = 0; //scancodes, 0 for none
+
+		int32_t controller = -1; //the controller's slot, -1 for none
+		uint16_t axis = 1; //SDL_CONTROLLER_AXIS_LEFTY, up is negative
+		uint16_t upButton = 11, downButton = 12; //SDL_CONTROLLER_BUTTON_DPAD_UP and DPAD_DOWN
+		float deadZone = 0.25f;
+
+		//gets the direction the input is pushing the paddle, -1 down, 1 up
+		inline float GetDirection(const InputState& state) const
+		{
+			float direction = (state.IsKeyHeld(upKey) ? 1.0f : 0.0f) - (state.IsKeyHeld(downKey) ? 1.0f : 0.0f);
+			if (controller >= 0)
+			{
+				direction += (state.IsButtonHeld((uint32_t)controller, upButton) ? 1.0f : 0.0f) - (state.IsButtonHeld((uint32_t)controller, downButton) ? 1.0f : 0.0f);
+				direction -= state.GetAxis((uint32_t)controller, axis, deadZone);
+			}
+			return (direction > 1.0f ? 1.0f : direction < -1.0f ? -1.0f : direction);
+		}
+	};
+
+	//defines turning the queued events into each tick's actions, on the thread that steps the ticks
+	struct InputTickMapper
+	{
+		InputQueue* queue = nullptr;
+		InputState state;
+		std::vector<PaddleBinding> bindings;
+		uint64_t appliedEvents = 0;
+
+		//applies the events that happened by a tick's time, the later ones are left for the ticks after
+		inline void ConsumeUntil(std::chrono::steady_clock::time_point tickTime)
+		{
+			InputEvent event;
+			const InputEvent* next = nullptr;
+			while ((next = queue->Peek()) != nullptr && next->time <= tickTime)
+			{
+				queue->Pop(event);
+				state.Apply(event);
+				appliedEvents++;
+			}
+		}
+	};
+
+	//defines the input to photon estimate, from the sample before a press was pumped to the frame it changed being on the screen
+	struct InputLatencyStats
+	{
+		float lastMS = 0.0f, averageMS = 0.0f, maxMS = 0.0f;
+		uint64_t sampleCount = 0;
+
+		//adds a sample
+		inline void AddSample(float latencyMS)
+		{
+			lastMS = latencyMS;
+			if (latencyMS > maxMS)
+				maxMS = latencyMS;
+
+			//the first sample seeds the average, the rest are blended in
+			averageMS = (sampleCount == 0 ? latencyMS : averageMS + (latencyMS - averageMS) * 0.1f);
+			sampleCount++;
+		}
+	};
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+//defines a hook that counts the heap allocations, used to check that the steady state frames don't allocate
+//the counting operator new is only compiled into the program that uses PONG3D_DEFINE_ALLOCATION_COUNTER, once, outside of any namespace
+//it replaces every form of operator new and delete, the over aligned ones too, so no allocation pairs a replaced new with the library's delete
+
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+//allocations are counted when profiling, the dist builds use the normal operator new
+#ifndef PONG3D_ALLOCATION_COUNTING
+#define PONG3D_ALLOCATION_COUNTING PONG3D_PROFILING
+#endif
+
+namespace Pong3D::Memory
+{
+	//the number of heap allocations made by every thread
+	inline std::atomic<uint64_t> allocationCount{ 0 };
+
+	//counts a allocation
+	inline void AllocationCounter_Add() { allocationCount.fetch_add(1, std::memory_order_relaxed); }
+
+	//gets the number of allocations so far, take the difference of two calls to count the allocations of a stretch of code
+	//always 0 if counting is disabled
+	inline uint64_t AllocationCounter_Get() { return allocationCount.load(std::memory_order_relaxed); }
+
+	//allocates memory with a alignment above the default, for the aligned operator new
+	inline void* AllocationCounter_AlignedMalloc(std::size_t size, std::size_t alignment)
+	{
+#if defined(_MSC_VER)
+		return _aligned_malloc(size > 0 ? size : 1, alignment);
+#else
+		//aligned_alloc wants the size to be a multiple of the alignment
+		size = (size > 0 ? size : 1);
+		return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+	}
+
+	//frees memory from AllocationCounter_AlignedMalloc
+	inline void AllocationCounter_AlignedFree(void* pointer)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+#if PONG3D_ALLOCATION_COUNTING
+
+#define PONG3D_DEFINE_ALLOCATION_COUNTER() \
+	void* operator new(std::size_t size) \
+	{ \
+		Pong3D::Memory::AllocationCounter_Add(); \
+		if (void* pointer = std::malloc(size > 0 ? size : 1)) \
+			return pointer; \
+		throw std::bad_alloc(); \
+	} \
+	void* operator new[](std::size_t size) { return operator new(size); } \
+	void* operator new(std::size_t size, const std::nothrow_t&) noexcept \
+	{ \
+		Pong3D::Memory::AllocationCounter_Add(); \
+		return std::malloc(size > 0 ? size : 1); \
+	} \
+	void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); } \
+	void operator delete(void* pointer) noexcept { std::free(pointer); } \
+	void operator delete[](void* pointer) noexcept { std::free(pointer); } \
+	void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); } \
+	void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); } \
+	void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); } \
+	void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); } \
+	void* operator new(std::size_t size, std::align_val_t alignment) \
+	{ \
+		Pong3D::Memory::AllocationCounter_Add(); \
+		if (void* pointer = Pong3D::Memory::AllocationCounter_AlignedMalloc(size, (std::size_t)alignment)) \
+			return pointer; \
+		throw std::bad_alloc(); \
+	} \
+	void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); } \
+	void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept \
+	{ \
+		Pong3D::Memory::AllocationCounter_Add(); \
+		return Pong3D::Memory::AllocationCounter_AlignedMalloc(size, (std::size_t)alignment); \
+	} \
+	void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept { return operator new(size, alignment, tag); } \
+	void operator delete(void* pointer, std::align_val_t) noexcept { Pong3D::Memory::AllocationCounter_AlignedFree(pointer); } \
+	void operator delete[](void* pointer, std::align_val_t) noexcept { Pong3D::Memory::AllocationCounter_AlignedFree(pointer); } \
+	void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { Pong3D::Memory::AllocationCounter_AlignedFree(pointer); } \
+	void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { Pong3D::Memory::AllocationCounter_AlignedFree(pointer); } \
+	void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { Pong3D::Memory::AllocationCounter_AlignedFree(pointer); } \
+	void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { Pong3D::Memory::AllocationCounter_AlignedFree(pointer); }
+
+#else
+
+#define PONG3D_DEFINE_ALLOCATION_COUNTER()
+
+#endif
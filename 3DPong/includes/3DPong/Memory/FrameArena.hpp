@@ -0,0 +1,205 @@
+#pragma once
+
+//defines a frame arena, a bump allocator for the data that only lives for one frame
+//each frame slot owns one and resets it once the slot's fence has signaled, so nothing allocated from it is freed on its own
+
+#include <fmt/color.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Pong3D::Memory
+{
+	//the size of a frame arena when none is given
+	static constexpr size_t FRAME_ARENA_DEFAULT_SIZE = 1024 * 1024;
+
+	//the alignment every block starts at, a cache line
+	static constexpr size_t FRAME_ARENA_BLOCK_ALIGNMENT = 64;
+
+	//defines the stats of a frame arena
+	struct FrameArenaStats
+	{
+		size_t capacity = 0; //the size of the main block
+		size_t bytesUsed = 0; //used this frame, including the overflow blocks
+		size_t highWaterBytes = 0; //the most a frame has used
+		uint64_t overflowBlocks = 0; //how many extra blocks the frame needed, each one is a heap allocation
+		uint64_t growCount = 0; //how many times the main block has grown to fit a frame
+	};
+
+	//defines a frame arena
+	struct FrameArena
+	{
+		//defines a block of memory, the first is the main one. Extra blocks are only made when a frame overflows it
+		struct Block
+		{
+			std::unique_ptr<uint8_t[]> memory;
+			uint8_t* data = nullptr; //the memory aligned to FRAME_ARENA_BLOCK_ALIGNMENT
+			size_t size = 0, offset = 0;
+		};
+
+		std::vector<Block> blocks;
+		FrameArenaStats stats;
+		bool isCreated = false;
+
+		//allocates a block, it's aligned to a cache line
+		static inline Block AllocateBlock(size_t size)
+		{
+			Block block;
+			block.memory = std::make_unique<uint8_t[]>(size + FRAME_ARENA_BLOCK_ALIGNMENT);
+			const uintptr_t address = (uintptr_t)block.memory.get();
+			block.data = (uint8_t*)((address + FRAME_ARENA_BLOCK_ALIGNMENT - 1) & ~(uintptr_t)(FRAME_ARENA_BLOCK_ALIGNMENT - 1));
+			block.size = size;
+			return block;
+		}
+
+		//creates the arena
+		inline bool Create(size_t capacity = FRAME_ARENA_DEFAULT_SIZE)
+		{
+			if (isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE MEMORY WARNING: Frame Arena || Create || The arena is already created!\n");
+				return true;
+			}
+
+			if (capacity == 0)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE MEMORY ERROR: Frame Arena || Create || The capacity must be above 0!\n");
+				return false;
+			}
+
+			blocks.reserve(8);
+			blocks.emplace_back(AllocateBlock(capacity));
+			stats = FrameArenaStats();
+			stats.capacity = capacity;
+			isCreated = true;
+			return true;
+		}
+
+		//destroys the arena, anything allocated from it is gone
+		inline void Destroy()
+		{
+			blocks.clear();
+			stats = FrameArenaStats();
+			isCreated = false;
+		}
+
+		//frees everything allocated since the last reset
+		//a frame that overflowed grows the main block to fit it, so the next frames don't need the extra blocks
+		inline void Reset()
+		{
+			if (!isCreated)
+				return;
+
+			if (stats.bytesUsed > stats.highWaterBytes)
+				stats.highWaterBytes = stats.bytesUsed;
+
+			if (blocks.size() > 1)
+			{
+				const size_t capacity = stats.highWaterBytes + stats.highWaterBytes / 2;
+				blocks.clear();
+				blocks.emplace_back(AllocateBlock(capacity));
+				stats.capacity = capacity;
+				stats.growCount++;
+			}
+
+			blocks[0].offset = 0;
+			stats.bytesUsed = 0;
+			stats.overflowBlocks = 0;
+		}
+
+		//allocates memory for the frame, it does not need to be freed
+		//the arena must be created, the callers use the memory without checking it
+		inline void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			assert(isCreated && "the frame arena was not created");
+			if (!isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE MEMORY ERROR: Frame Arena || Allocate || The arena was not created!\n");
+				return nullptr;
+			}
+
+			if (size == 0)
+				size = 1;
+
+			//bumps the last block
+			Block* block = &blocks.back();
+			size_t offset = (block->offset + alignment - 1) & ~(alignment - 1);
+			if (offset + size > block->size)
+			{
+				//the frame has outgrown the main block, a extra one holds the rest of it until the next reset
+				blocks.emplace_back(AllocateBlock(std::max(size + alignment, blocks[0].size)));
+				stats.overflowBlocks++;
+				block = &blocks.back();
+				offset = 0;
+			}
+
+			stats.bytesUsed += (offset - block->offset) + size;
+			block->offset = offset + size;
+			return block->data + offset;
+		}
+
+		//allocates a array for the frame, the elements are not constructed so it's only for trivial types
+		template<typename T>
+		inline T* AllocateArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "the frame arena never runs destructors");
+			return (T*)Allocate(count * sizeof(T), alignof(T));
+		}
+	};
+
+	//defines a allocator for the standard containers that takes its memory from a frame arena
+	//without a arena it falls back to the heap, so a container can be default constructed and given a arena each frame
+	template<typename T>
+	struct FrameArenaAllocator
+	{
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		FrameArena* arena = nullptr;
+
+		FrameArenaAllocator() = default;
+		FrameArenaAllocator(FrameArena* _arena) : arena(_arena) {}
+		template<typename U>
+		FrameArenaAllocator(const FrameArenaAllocator<U>& other) : arena(other.arena) {}
+
+		inline T* allocate(size_t count)
+		{
+			if (arena)
+				return (T*)arena->Allocate(count * sizeof(T), alignof(T));
+			return std::allocator<T>().allocate(count);
+		}
+
+		//the arena frees everything at once on reset
+		inline void deallocate(T* pointer, size_t count)
+		{
+			if (!arena)
+				std::allocator<T>().deallocate(pointer, count);
+		}
+
+		template<typename U>
+		inline bool operator==(const FrameArenaAllocator<U>& other) const { return arena == other.arena; }
+		template<typename U>
+		inline bool operator!=(const FrameArenaAllocator<U>& other) const { return arena != other.arena; }
+	};
+
+	//defines a vector that lives for one frame, only valid until its arena is reset
+	template<typename T>
+	using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+
+	//makes a empty frame vector on a arena, reserving the count up front so it doesn't grow into the arena more than once
+	template<typename T>
+	inline FrameVector<T> FrameVector_Create(FrameArena* arena, size_t reserveCount = 0)
+	{
+		FrameVector<T> vector{ FrameArenaAllocator<T>(arena) };
+		if (reserveCount > 0)
+			vector.reserve(reserveCount);
+		return vector;
+	}
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+//defines writing and reading values a few bits at a time, used to pack the snapshots into as few bytes as they need
+//bits are packed from the least significant end of each byte, the same on every platform
+
+#include <cstdint>
+#include <cstring>
+
+namespace Pong3D::Network
+{
+	//defines a bit writer into a buffer it does not own
+	struct BitWriter
+	{
+		uint8_t* data = nullptr;
+		size_t capacityBits = 0;
+		size_t bitCount = 0; //written so far
+		bool hasOverflowed = false; //set if a write didn't fit, the rest are dropped
+
+		//starts writing into a buffer, it's cleared as it's written
+		inline void Start(uint8_t* _data, size_t capacityBytes)
+		{
+			data = _data;
+			capacityBits = capacityBytes * 8;
+			bitCount = 0;
+			hasOverflowed = false;
+		}
+
+		//gets how many bytes have been touched
+		inline size_t GetByteCount() const { return (bitCount + 7) / 8; }
+
+		//gets how many bits can still be written
+		inline size_t GetBitsLeft() const { return capacityBits - bitCount; }
+
+		//writes the low bits of a value, up to 32
+		inline void Write(uint32_t value, uint32_t bits)
+		{
+			if (bits == 0)
+				return;
+			if (bitCount + bits > capacityBits)
+			{
+				hasOverflowed = true;
+				return;
+			}
+
+			if (bits < 32)
+				value &= (1u << bits) - 1;
+
+			while (bits > 0)
+			{
+				const size_t byte = bitCount / 8;
+				const uint32_t bitInByte = (uint32_t)(bitCount % 8);
+				const uint32_t bitsInByte = (8 - bitInByte < bits ? 8 - bitInByte : bits);
+
+				if (bitInByte == 0)
+					data[byte] = 0;
+				data[byte] |= (uint8_t)((value & ((1u << bitsInByte) - 1)) << bitInByte);
+
+				value >>= bitsInByte;
+				bits -= bitsInByte;
+				bitCount += bitsInByte;
+			}
+		}
+
+		//writes a bool as a bit
+		inline void WriteBool(bool value) { Write(value ? 1 : 0, 1); }
+
+		//writes a float's bits
+		inline void WriteFloat(float value)
+		{
+			uint32_t bits = 0;
+			memcpy(&bits, &value, sizeof(bits));
+			Write(bits, 32);
+		}
+
+		//writes a value as its bit length then its bits, small values take few bits
+		inline void WriteVarBits(uint32_t value)
+		{
+			uint32_t length = 0;
+			while (length < 32 && (value >> length) != 0)
+				length++;
+			Write(length, 6);
+			Write(value, length);
+		}
+	};
+
+	//defines a bit reader over a buffer it does not own
+	struct BitReader
+	{
+		const uint8_t* data = nullptr;
+		size_t sizeBits = 0;
+		size_t bitCount = 0; //read so far
+		bool hasOverflowed = false; //set if a read went past the end, the reads after give 0
+
+		//starts reading a buffer
+		inline void Start(const uint8_t* _data, size_t sizeBytes)
+		{
+			data = _data;
+			sizeBits = sizeBytes * 8;
+			bitCount = 0;
+			hasOverflowed = false;
+		}
+
+		//reads a value of up to 32 bits
+		inline uint32_t Read(uint32_t bits)
+		{
+			if (bits == 0)
+				return 0;
+			if (bitCount + bits > sizeBits)
+			{
+				hasOverflowed = true;
+				bitCount = sizeBits;
+				return 0;
+			}
+
+			uint32_t value = 0, shift = 0;
+			while (bits > 0)
+			{
+				const size_t byte = bitCount / 8;
+				const uint32_t bitInByte = (uint32_t)(bitCount % 8);
+				const uint32_t bitsInByte = (8 - bitInByte < bits ? 8 - bitInByte : bits);
+
+				value |= (uint32_t)((data[byte] >> bitInByte) & ((1u << bitsInByte) - 1)) << shift;
+
+				shift += bitsInByte;
+				bits -= bitsInByte;
+				bitCount += bitsInByte;
+			}
+			return value;
+		}
+
+		//reads a bit as a bool
+		inline bool ReadBool() { return Read(1) != 0; }
+
+		//reads a float's bits
+		inline float ReadFloat()
+		{
+			const uint32_t bits = Read(32);
+			float value = 0.0f;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		//reads a value written with WriteVarBits
+		inline uint32_t ReadVarBits()
+		{
+			const uint32_t length = Read(6);
+			if (length > 32)
+			{
+				hasOverflowed = true;
+				return 0;
+			}
+			return Read(length);
+		}
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+//defines a network conditioner, it sits in front of a UDP socket and holds back or drops the packets it sends
+//used to try the netcode against a bad connection on loopback
+
+#include <3DPong/Network/UDPSocket.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace Pong3D::Network
+{
+	//defines the settings of the conditioner, all 0 sends every packet straight away
+	struct NetworkConditioner_CreateInfo
+	{
+		float latencyMS = 0.0f; //one way
+		float jitterMS = 0.0f; //added or taken off the latency at random, packets can arrive out of order
+		float lossPercent = 0.0f; //the chance a packet is dropped
+		uint32_t maxQueuedPackets = 256; //packets past this are dropped, so the queue never allocates
+		uint32_t seed = 1;
+	};
+
+	//defines the stats of a conditioner
+	struct NetworkConditionerStats
+	{
+		uint64_t packetsSent = 0, packetsDropped = 0, packetsOverflowed = 0;
+	};
+
+	//defines a network conditioner
+	struct NetworkConditioner
+	{
+		//defines a packet waiting for its time to be sent
+		struct DelayedPacket
+		{
+			double sendTimeMS = 0.0;
+			NetAddress to;
+			uint32_t size = 0;
+			std::array<uint8_t, MAX_PACKET_SIZE> data;
+		};
+
+		UDPSocket* socket = nullptr;
+		NetworkConditioner_CreateInfo settings;
+		NetworkConditionerStats stats;
+
+		std::vector<DelayedPacket> queue;
+		std::mt19937 random;
+		std::uniform_real_distribution<float> unitRandom{ 0.0f, 1.0f };
+
+		//sets up the conditioner in front of a socket
+		inline void Create(UDPSocket* _socket, const NetworkConditioner_CreateInfo& info = NetworkConditioner_CreateInfo())
+		{
+			socket = _socket;
+			settings = info;
+			stats = NetworkConditionerStats();
+			queue.clear();
+			queue.reserve(settings.maxQueuedPackets);
+			random.seed(settings.seed);
+		}
+
+		//is the conditioner doing anything, if not packets go straight to the socket
+		inline bool IsActive() const { return settings.latencyMS > 0.0f || settings.jitterMS > 0.0f || settings.lossPercent > 0.0f; }
+
+		//sends a packet after the latency, or drops it
+		inline void Send(const NetAddress& to, const void* data, size_t size, double nowMS)
+		{
+			if (settings.lossPercent > 0.0f && unitRandom(random) * 100.0f < settings.lossPercent)
+			{
+				stats.packetsDropped++;
+				return;
+			}
+
+			if (!IsActive())
+			{
+				stats.packetsSent += (socket->Send(to, data, size) ? 1 : 0);
+				return;
+			}
+
+			if (queue.size() >= settings.maxQueuedPackets || size > MAX_PACKET_SIZE)
+			{
+				stats.packetsOverflowed++;
+				return;
+			}
+
+			const float jitter = (settings.jitterMS > 0.0f ? (unitRandom(random) * 2.0f - 1.0f) * settings.jitterMS : 0.0f);
+			DelayedPacket* packet = &queue.emplace_back();
+			packet->sendTimeMS = nowMS + std::max(0.0f, settings.latencyMS + jitter);
+			packet->to = to;
+			packet->size = (uint32_t)size;
+			memcpy(packet->data.data(), data, size);
+		}
+
+		//sends the packets whose time has come, call every tick before receiving
+		inline void Flush(double nowMS)
+		{
+			for (size_t i = 0; i < queue.size();)
+			{
+				if (queue[i].sendTimeMS > nowMS)
+				{
+					++i;
+					continue;
+				}
+
+				stats.packetsSent += (socket->Send(queue[i].to, queue[i].data.data(), queue[i].size) ? 1 : 0);
+				queue[i] = queue.back();
+				queue.pop_back();
+			}
+		}
+	};
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+//defines the rollback netcode for two players, each peer runs the whole simulation at the fixed time step
+//only the inputs are sent. The remote input is predicted until it arrives, if the prediction was wrong the world is loaded back to that tick and simulated again
+
+#include <3DPong/Network/NetworkConditioner.hpp>
+#include <3DPong/Physics/PongPhysics.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <array>
+#include <chrono>
+
+namespace Pong3D::Network
+{
+	//the number of players in a session, one on each peer
+	static constexpr uint32_t ROLLBACK_MAX_PLAYERS = 2;
+
+	//how many ticks of inputs and states are kept, a power of two
+	static constexpr uint32_t ROLLBACK_RING_SIZE = 64;
+	static_assert((ROLLBACK_RING_SIZE & (ROLLBACK_RING_SIZE - 1)) == 0, "the rollback ring size must be a power of two");
+
+	//the packet layout, little endian
+	//magic (2) | type (1) | player (1) | ack tick (4) | first tick (4) | input count (1) | inputs (2 bits each)
+	static constexpr uint16_t ROLLBACK_PACKET_MAGIC = 0x3350; //"P3"
+	static constexpr uint8_t ROLLBACK_PACKET_TYPE_INPUT = 1;
+	static constexpr size_t ROLLBACK_PACKET_HEADER_SIZE = 13;
+	static constexpr uint32_t ROLLBACK_MAX_INPUTS_PER_PACKET = ROLLBACK_RING_SIZE;
+
+	//defines a player's input for a tick, it fits in 2 bits
+	enum class RollbackInput : uint8_t
+	{
+		None = 0,
+		Up,
+		Down,
+
+		Count
+	};
+
+	//gets the input of a paddle direction, -1 down, 1 up
+	inline RollbackInput RollbackInput_FromDirection(float direction)
+	{
+		return (direction > 0.0f ? RollbackInput::Up : direction < 0.0f ? RollbackInput::Down : RollbackInput::None);
+	}
+
+	//gets the paddle direction of a input
+	inline float RollbackInput_ToDirection(RollbackInput input)
+	{
+		return (input == RollbackInput::Up ? 1.0f : input == RollbackInput::Down ? -1.0f : 0.0f);
+	}
+
+	//writes and reads the little endian values of a packet
+	inline void Packet_WriteU16(uint8_t* data, uint16_t value) { data[0] = (uint8_t)value; data[1] = (uint8_t)(value >> 8); }
+	inline void Packet_WriteU32(uint8_t* data, uint32_t value) { for (uint32_t i = 0; i < 4; ++i) data[i] = (uint8_t)(value >> (i * 8)); }
+	inline uint16_t Packet_ReadU16(const uint8_t* data) { return (uint16_t)(data[0] | (data[1] << 8)); }
+	inline uint32_t Packet_ReadU32(const uint8_t* data) { return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24); }
+
+	//defines the settings of a session
+	struct RollbackSession_CreateInfo
+	{
+		uint32_t localPlayer = 0; //the paddle this peer moves, the remote peer moves the other one
+		uint16_t localPort = 0;
+		NetAddress remoteAddress;
+
+		uint32_t inputDelayTicks = 2; //the local input is used this many ticks late, so it usually reaches the remote peer in time and it doesn't have to roll back
+		uint32_t maxRollbackTicks = 12; //the simulation waits rather than run further ahead of the last remote input than this
+
+		float fixedDeltaTime = 1.0f / 60.0f;
+		float paddleSpeed = 10.0f;
+
+		NetworkConditioner_CreateInfo conditioner; //a bad connection to test with, off by default
+	};
+
+	//defines the stats of a session
+	struct RollbackStats
+	{
+		uint64_t rollbacks = 0; //how many times a prediction was wrong
+		uint64_t resimulatedTicks = 0;
+		uint32_t lastRollbackTicks = 0; //how many ticks the last rollback simulated again
+		float lastRollbackMS = 0.0f, maxRollbackMS = 0.0f;
+
+		uint64_t stalls = 0; //ticks the simulation waited on the remote peer
+		uint64_t packetsSent = 0, packetsReceived = 0, packetsRejected = 0;
+	};
+
+	//defines a rollback session
+	struct RollbackSession
+	{
+		UDPSocket socket;
+		NetworkConditioner conditioner;
+		NetAddress remoteAddress;
+		uint32_t localPlayer = 0, remotePlayer = 1;
+
+		uint32_t inputDelayTicks = 2, maxRollbackTicks = 12;
+		float fixedDeltaTime = 1.0f / 60.0f, paddleSpeed = 10.0f;
+
+		uint32_t currentTick = 0; //the next tick to simulate
+
+		//the inputs by tick, the local ones are known up to localInputEnd and the remote ones are confirmed up to remoteInputEnd
+		std::array<RollbackInput, ROLLBACK_RING_SIZE> localInputs = {}, remoteInputs = {};
+		uint32_t localInputEnd = 0, remoteInputEnd = 0;
+		std::array<RollbackInput, ROLLBACK_RING_SIZE> usedRemoteInputs = {}; //the remote input each tick was simulated with, real or predicted
+		uint32_t remoteAckTick = 0; //the remote peer has all the local inputs before this
+
+		//the world at the start of each tick
+		std::array<Physics::PhysicsState, ROLLBACK_RING_SIZE> states;
+		uint32_t rollbackFromTick = UINT32_MAX; //the first tick that was simulated with a wrong prediction
+
+		std::array<uint8_t, MAX_PACKET_SIZE> packetBuffer = {};
+		std::chrono::steady_clock::time_point startTime;
+
+		RollbackStats stats;
+		bool isCreated = false;
+
+		//opens the socket, the session starts once the remote peer's first inputs arrive
+		inline bool Create(const RollbackSession_CreateInfo& info)
+		{
+			if (isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE NETWORK WARNING: Rollback Session || Create || The session is already created!\n");
+				return true;
+			}
+
+			//the remote inputs can arrive up to both peers' input delay and rollback ahead, they all have to fit in the ring
+			if (info.localPlayer >= ROLLBACK_MAX_PLAYERS || info.maxRollbackTicks == 0 || (info.inputDelayTicks + info.maxRollbackTicks) * 2 >= ROLLBACK_RING_SIZE)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE NETWORK ERROR: Rollback Session || Create || The local player must be 0 or 1 and twice the input delay and rollback must fit in the {} tick ring!\n",
+					ROLLBACK_RING_SIZE);
+				return false;
+			}
+
+			if (!socket.Open(info.localPort))
+				return false;
+
+			conditioner.Create(&socket, info.conditioner);
+			remoteAddress = info.remoteAddress;
+			localPlayer = info.localPlayer;
+			remotePlayer = (localPlayer + 1) % ROLLBACK_MAX_PLAYERS;
+			inputDelayTicks = info.inputDelayTicks;
+			maxRollbackTicks = info.maxRollbackTicks;
+			fixedDeltaTime = info.fixedDeltaTime;
+			paddleSpeed = info.paddleSpeed;
+
+			currentTick = localInputEnd = remoteInputEnd = remoteAckTick = 0;
+			rollbackFromTick = UINT32_MAX;
+			stats = RollbackStats();
+			startTime = std::chrono::steady_clock::now();
+			isCreated = true;
+
+			fmt::print("Rollback session on port {} as player {}, playing with {}\n", socket.port, localPlayer + 1, remoteAddress.ToString());
+			return true;
+		}
+
+		//closes the socket
+		inline void Destroy()
+		{
+			socket.Close();
+			isCreated = false;
+		}
+
+		//gets the time since the session was made, used when no time is given
+		inline double GetTimeMS() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+		}
+
+		//sizes every saved state like the world, so saving a tick copies into memory that's already there
+		inline void ReserveStates(const Physics::PhysicsWorld& world)
+		{
+			for (size_t i = 0; i < states.size(); ++i)
+				world.SaveState(states[i]);
+		}
+
+		//gets the remote input a tick is simulated with, the confirmed one or the last confirmed one repeated
+		inline RollbackInput GetRemoteInput(uint32_t tick) const
+		{
+			if (tick < remoteInputEnd)
+				return remoteInputs[tick % ROLLBACK_RING_SIZE];
+			return (remoteInputEnd > 0 ? remoteInputs[(remoteInputEnd - 1) % ROLLBACK_RING_SIZE] : RollbackInput::None);
+		}
+
+		//is the simulation too far ahead of the remote peer to keep going
+		inline bool ShouldStall() const
+		{
+			return currentTick >= remoteInputEnd + maxRollbackTicks || localInputEnd - remoteAckTick >= ROLLBACK_RING_SIZE;
+		}
+
+		//sends the local inputs the remote peer hasn't confirmed, lost packets are covered by the next one
+		inline void SendInputs(double nowMS)
+		{
+			const uint32_t firstTick = remoteAckTick;
+			const uint32_t count = std::min(localInputEnd - firstTick, ROLLBACK_MAX_INPUTS_PER_PACKET);
+
+			uint8_t* data = packetBuffer.data();
+			Packet_WriteU16(data, ROLLBACK_PACKET_MAGIC);
+			data[2] = ROLLBACK_PACKET_TYPE_INPUT;
+			data[3] = (uint8_t)localPlayer;
+			Packet_WriteU32(data + 4, remoteInputEnd);
+			Packet_WriteU32(data + 8, firstTick);
+			data[12] = (uint8_t)count;
+
+			uint8_t* inputs = data + ROLLBACK_PACKET_HEADER_SIZE;
+			memset(inputs, 0, (count + 3) / 4);
+			for (uint32_t i = 0; i < count; ++i)
+				inputs[i / 4] |= (uint8_t)localInputs[(firstTick + i) % ROLLBACK_RING_SIZE] << ((i % 4) * 2);
+
+			conditioner.Send(remoteAddress, data, ROLLBACK_PACKET_HEADER_SIZE + (count + 3) / 4, nowMS);
+			stats.packetsSent++;
+		}
+
+		//reads a packet, the new remote inputs are checked against what was predicted for them
+		inline bool ReadPacket(const uint8_t* data, size_t size, const NetAddress& from)
+		{
+			if (from != remoteAddress || size < ROLLBACK_PACKET_HEADER_SIZE || Packet_ReadU16(data) != ROLLBACK_PACKET_MAGIC ||
+				data[2] != ROLLBACK_PACKET_TYPE_INPUT || data[3] != remotePlayer)
+				return false;
+
+			const uint32_t ackTick = Packet_ReadU32(data + 4);
+			const uint32_t firstTick = Packet_ReadU32(data + 8);
+			const uint32_t count = data[12];
+			if (count > ROLLBACK_MAX_INPUTS_PER_PACKET || size < ROLLBACK_PACKET_HEADER_SIZE + (count + 3) / 4 || ackTick > localInputEnd)
+				return false;
+
+			if (ackTick > remoteAckTick)
+				remoteAckTick = ackTick;
+
+			//only the next input needed is taken, anything past a gap is sent again once the gap is acked
+			const uint8_t* inputs = data + ROLLBACK_PACKET_HEADER_SIZE;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const uint32_t tick = firstTick + i;
+				if (tick < remoteInputEnd)
+					continue;
+				if (tick > remoteInputEnd)
+					break;
+
+				const RollbackInput input = (RollbackInput)((inputs[i / 4] >> ((i % 4) * 2)) & 0x3);
+				if (input >= RollbackInput::Count)
+					return false;
+
+				remoteInputs[tick % ROLLBACK_RING_SIZE] = input;
+				remoteInputEnd++;
+
+				//the tick has been simulated with a different guess
+				if (tick < currentTick && usedRemoteInputs[tick % ROLLBACK_RING_SIZE] != input && tick < rollbackFromTick)
+					rollbackFromTick = tick;
+			}
+
+			return true;
+		}
+
+		//receives every waiting packet
+		inline void ReceivePackets()
+		{
+			NetAddress from;
+			size_t size = 0;
+			while ((size = socket.Receive(packetBuffer.data(), packetBuffer.size(), from)) > 0)
+			{
+				if (ReadPacket(packetBuffer.data(), size, from))
+					stats.packetsReceived++;
+				else
+					stats.packetsRejected++;
+			}
+		}
+
+		//saves the world and simulates a tick with its inputs
+		inline void SimulateTick(Physics::PhysicsWorld& world, uint32_t tick)
+		{
+			world.SaveState(states[tick % ROLLBACK_RING_SIZE]);
+
+			const RollbackInput remoteInput = GetRemoteInput(tick);
+			usedRemoteInputs[tick % ROLLBACK_RING_SIZE] = remoteInput;
+
+			world.paddles.SetVelocity(localPlayer, glm::vec3(0.0f, RollbackInput_ToDirection(localInputs[tick % ROLLBACK_RING_SIZE]) * paddleSpeed, 0.0f));
+			world.paddles.SetVelocity(remotePlayer, glm::vec3(0.0f, RollbackInput_ToDirection(remoteInput) * paddleSpeed, 0.0f));
+			world.Step(fixedDeltaTime);
+		}
+
+		//loads the world back to the first mispredicted tick and simulates up to the current tick again
+		inline void Rollback(Physics::PhysicsWorld& world)
+		{
+			PONG3D_PROFILE_ZONE("Rollback");
+			const auto start = std::chrono::high_resolution_clock::now();
+
+			const uint32_t fromTick = rollbackFromTick;
+			rollbackFromTick = UINT32_MAX;
+
+			world.LoadState(states[fromTick % ROLLBACK_RING_SIZE]);
+			for (uint32_t tick = fromTick; tick < currentTick; ++tick)
+				SimulateTick(world, tick);
+
+			stats.rollbacks++;
+			stats.lastRollbackTicks = currentTick - fromTick;
+			stats.resimulatedTicks += stats.lastRollbackTicks;
+			stats.lastRollbackMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			stats.maxRollbackMS = std::max(stats.maxRollbackMS, stats.lastRollbackMS);
+		}
+
+		//advances the session a tick with the local player's paddle direction, call once per fixed step
+		//returns false if the tick was not simulated because the remote peer is too far behind, the world wasn't touched
+		inline bool AdvanceTick(Physics::PhysicsWorld& world, float localDirection, double nowMS)
+		{
+			PONG3D_PROFILE_ZONE("Rollback Tick");
+			conditioner.Flush(nowMS);
+			ReceivePackets();
+
+			//the inputs the remote peer sent may have been guessed wrong
+			if (rollbackFromTick < currentTick)
+				Rollback(world);
+
+			if (ShouldStall())
+			{
+				stats.stalls++;
+				SendInputs(nowMS);
+				return false;
+			}
+
+			//the local input lands inputDelayTicks in the future, the first ticks all get the first input
+			const RollbackInput localInput = RollbackInput_FromDirection(localDirection);
+			while (localInputEnd <= currentTick + inputDelayTicks)
+				localInputs[localInputEnd++ % ROLLBACK_RING_SIZE] = localInput;
+			SendInputs(nowMS);
+
+			SimulateTick(world, currentTick);
+			currentTick++;
+			return true;
+		}
+
+		//advances the session a tick using the time since it was made
+		inline bool AdvanceTick(Physics::PhysicsWorld& world, float localDirection) { return AdvanceTick(world, localDirection, GetTimeMS()); }
+	};
+}
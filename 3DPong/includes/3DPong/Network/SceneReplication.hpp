@@ -0,0 +1,54 @@
+#pragma once
+
+//defines taking the replication snapshots from the scene on the server and writing them back into the scene on a client
+//the client's scene is made the same way as the server's so the entity IDs line up, entities it doesn't have are skipped
+
+#include <3DPong/Network/SnapshotReplication.hpp>
+#include <3DPong/ECS/Scene.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+namespace Pong3D::Network
+{
+	//fills the encoder's next snapshot with every renderable's transform, returns how many were taken
+	inline uint64_t Replication_CaptureScene(const Scene::Scene& scene, SnapshotEncoder& encoder)
+	{
+		PONG3D_PROFILE_ZONE("Replication Capture Scene");
+		ReplicationSnapshot& snapshot = encoder.BeginSnapshot();
+		snapshot.entities.reserve(scene.renderables.count);
+
+		for (size_t c = 0; c < scene.renderables.chunksInUse; ++c)
+		{
+			const ECS::RenderableChunk* chunk = scene.renderables.chunks[c].get();
+			for (uint32_t i = 0; i < chunk->count; ++i)
+				snapshot.Add(chunk->entityIDs[i], chunk->positions[i], chunk->rotations[i], chunk->scales[i], encoder.quantization);
+		}
+
+		encoder.EndSnapshot();
+		return snapshot.entities.size();
+	}
+
+	//writes the decoder's latest snapshot into the renderables, they're marked for the transform sync
+	//returns how many were written
+	inline uint64_t Replication_WriteToScene(const SnapshotDecoder& decoder, Scene::Scene& scene)
+	{
+		PONG3D_PROFILE_ZONE("Replication Write To Scene");
+		const ReplicationSnapshot* snapshot = decoder.GetLatest();
+		if (!snapshot)
+			return 0;
+
+		uint64_t writtenCount = 0;
+		for (size_t i = 0; i < snapshot->entities.size(); ++i)
+		{
+			const ECS::RenderableRef ref = scene.Renderable_MarkDirty(snapshot->entities[i].entityID);
+			if (!ref.IsValid())
+				continue;
+
+			ref.Position() = snapshot->GetPosition(i, decoder.quantization);
+			ref.Rotation() = snapshot->GetRotation(i, decoder.quantization);
+			ref.Scale() = snapshot->entities[i].scale;
+			writtenCount++;
+		}
+
+		return writtenCount;
+	}
+}
@@ -0,0 +1,603 @@
+#pragma once
+
+//defines the snapshots a server replicates to its clients, the transforms of every entity quantized to fixed point
+//each client is sent the changes since the last snapshot it acked, bit packed into packets that fit the MTU
+
+#include <3DPong/Network/BitStream.hpp>
+#include <3DPong/Network/UDPSocket.hpp>
+#include <3DPong/ECS/EntityPool.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace Pong3D::Network
+{
+	//how many snapshots each end keeps to delta against, a client that falls further behind is sent everything
+	static constexpr uint32_t REPLICATION_HISTORY_SIZE = 32;
+	static constexpr uint32_t REPLICATION_NO_BASELINE = UINT32_MAX;
+
+	//the packet layout, bit packed
+	//magic (16) | type (8) | sequence (32) | baseline (32) | fragment (16) | fragment count (16) | entry count (16) | entries
+	static constexpr uint16_t REPLICATION_PACKET_MAGIC = 0x3350; //"P3"
+	static constexpr uint8_t REPLICATION_PACKET_TYPE_SNAPSHOT = 2;
+	static constexpr size_t REPLICATION_PACKET_HEADER_SIZE = 17;
+
+	//the most bits a entry can take, a packet is closed when there's less than this left
+	static constexpr size_t REPLICATION_MAX_ENTRY_BITS = (6 + 32) + 2 + (6 + 32) + 3 * (1 + 32) + 3 * (1 + 32) + 1 + 3 * 32;
+
+	//defines how a entry changed from the baseline
+	enum class ReplicationEntryKind : uint8_t
+	{
+		Changed = 0, //the same entity as the baseline, only the parts that changed are sent as deltas
+		New, //not in the baseline, everything is sent
+		Removed, //in the baseline but not any more
+
+		Count
+	};
+
+	//defines how the transforms are quantized, both ends must use the same
+	struct ReplicationQuantization
+	{
+		glm::vec3 positionMin = glm::vec3(-64.0f), positionMax = glm::vec3(64.0f); //positions are clamped into these
+		uint32_t positionBits = 16; //about 2 mm over 128 units
+		uint32_t positionDeltaBits = 10; //a change that fits in these is sent as a delta, otherwise the whole value
+
+		float rotationPeriod = 360.0f; //the euler angles are in degrees and wrap
+		uint32_t rotationBits = 12; //about 0.09 degrees
+		uint32_t rotationDeltaBits = 7;
+	};
+
+	//quantizes and dequantizes a position axis
+	inline uint32_t Quantize_Position(float value, float minimum, float maximum, uint32_t bits)
+	{
+		const float maxValue = (float)((1ull << bits) - 1);
+		const float t = std::clamp((value - minimum) / (maximum - minimum), 0.0f, 1.0f);
+		return (uint32_t)std::lround(t * maxValue);
+	}
+	inline float Dequantize_Position(uint32_t value, float minimum, float maximum, uint32_t bits)
+	{
+		return minimum + (float)value * (maximum - minimum) / (float)((1ull << bits) - 1);
+	}
+
+	//quantizes and dequantizes a rotation angle, it wraps at the period
+	inline uint32_t Quantize_Rotation(float angle, float period, uint32_t bits)
+	{
+		float t = angle / period;
+		t -= std::floor(t);
+		return (uint32_t)std::lround(t * (float)(1ull << bits)) & (uint32_t)((1ull << bits) - 1);
+	}
+	inline float Dequantize_Rotation(uint32_t value, float period, uint32_t bits)
+	{
+		return (float)value * period / (float)(1ull << bits);
+	}
+
+	//maps a signed value to a unsigned one so small values of both signs stay small
+	inline uint32_t ZigZag_Encode(int32_t value) { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+	inline int32_t ZigZag_Decode(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+	//defines a entity's transform in a snapshot, quantized
+	struct ReplicatedEntity
+	{
+		uint64_t entityID = 0;
+		std::array<uint32_t, 3> position = {}, rotation = {};
+		glm::vec3 scale = glm::vec3(1.0f); //rarely changes so it's sent whole when it does
+
+		inline uint32_t GetIndex() const { return ECS::Entity_GetIndex(entityID); }
+	};
+
+	//defines a snapshot, the entities are sorted by their index
+	struct ReplicationSnapshot
+	{
+		uint32_t sequence = 0;
+		std::vector<ReplicatedEntity> entities;
+
+		//adds a entity's transform, call Sort once they're all in
+		inline void Add(uint64_t entityID, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, const ReplicationQuantization& quantization)
+		{
+			ReplicatedEntity* entity = &entities.emplace_back();
+			entity->entityID = entityID;
+			for (uint32_t a = 0; a < 3; ++a)
+			{
+				entity->position[a] = Quantize_Position(position[a], quantization.positionMin[a], quantization.positionMax[a], quantization.positionBits);
+				entity->rotation[a] = Quantize_Rotation(rotation[a], quantization.rotationPeriod, quantization.rotationBits);
+			}
+			entity->scale = scale;
+		}
+
+		//sorts the entities by index, the encoder walks the snapshot and its baseline side by side
+		inline void Sort()
+		{
+			std::sort(entities.begin(), entities.end(), [](const ReplicatedEntity& a, const ReplicatedEntity& b) { return a.GetIndex() < b.GetIndex(); });
+		}
+
+		//gets a entity's position and rotation back out
+		inline glm::vec3 GetPosition(size_t i, const ReplicationQuantization& quantization) const
+		{
+			glm::vec3 position;
+			for (uint32_t a = 0; a < 3; ++a)
+				position[a] = Dequantize_Position(entities[i].position[a], quantization.positionMin[a], quantization.positionMax[a], quantization.positionBits);
+			return position;
+		}
+		inline glm::vec3 GetRotation(size_t i, const ReplicationQuantization& quantization) const
+		{
+			glm::vec3 rotation;
+			for (uint32_t a = 0; a < 3; ++a)
+				rotation[a] = Dequantize_Rotation(entities[i].rotation[a], quantization.rotationPeriod, quantization.rotationBits);
+			return rotation;
+		}
+
+		//finds a entity by index with a binary search, returns nullptr if it's not in the snapshot
+		inline const ReplicatedEntity* Find(uint32_t index) const
+		{
+			auto found = std::lower_bound(entities.begin(), entities.end(), index, [](const ReplicatedEntity& entity, uint32_t i) { return entity.GetIndex() < i; });
+			return (found != entities.end() && found->GetIndex() == index ? &*found : nullptr);
+		}
+	};
+
+	//defines a packet of a snapshot
+	struct ReplicationPacket
+	{
+		uint32_t size = 0;
+		std::array<uint8_t, MAX_PACKET_SIZE> data;
+	};
+
+	//defines the stats of a encode
+	struct ReplicationEncodeStats
+	{
+		uint64_t entities = 0, changed = 0, added = 0, removed = 0, unchanged = 0;
+		uint64_t bytes = 0, packets = 0;
+	};
+
+	//writes a quantized value as a delta from the baseline if it's small, the whole value otherwise
+	//the delta wraps at the value's bits so rotations going past the period stay small
+	inline void WriteQuantizedDelta(BitWriter& writer, uint32_t value, uint32_t baseline, uint32_t bits, uint32_t deltaBits)
+	{
+		const uint32_t mask = (uint32_t)((1ull << bits) - 1);
+		int32_t delta = (int32_t)((value - baseline) & mask);
+		if (delta > (int32_t)(mask >> 1))
+			delta -= (int32_t)(mask + 1);
+
+		const uint32_t zigZag = ZigZag_Encode(delta);
+		const bool isSmall = (zigZag < (1u << deltaBits));
+		writer.WriteBool(isSmall);
+		writer.Write(isSmall ? zigZag : value, isSmall ? deltaBits : bits);
+	}
+
+	//reads a value written by WriteQuantizedDelta
+	inline uint32_t ReadQuantizedDelta(BitReader& reader, uint32_t baseline, uint32_t bits, uint32_t deltaBits)
+	{
+		const uint32_t mask = (uint32_t)((1ull << bits) - 1);
+		if (!reader.ReadBool())
+			return reader.Read(bits);
+		return (baseline + (uint32_t)ZigZag_Decode(reader.Read(deltaBits))) & mask;
+	}
+
+	//writes a entry, the index is written as the gap from the last entry in the packet
+	inline void Snapshot_WriteEntry(BitWriter& writer, ReplicationEntryKind kind, uint32_t indexDelta, const ReplicatedEntity* entity, const ReplicatedEntity* baseline,
+		const ReplicationQuantization& quantization)
+	{
+		writer.WriteVarBits(indexDelta);
+		writer.Write((uint32_t)kind, 2);
+
+		if (kind == ReplicationEntryKind::New)
+		{
+			writer.WriteVarBits(ECS::Entity_GetGeneration(entity->entityID));
+			for (uint32_t a = 0; a < 3; ++a)
+				writer.Write(entity->position[a], quantization.positionBits);
+			for (uint32_t a = 0; a < 3; ++a)
+				writer.Write(entity->rotation[a], quantization.rotationBits);
+
+			//most entities are never scaled, so a unit scale is a single bit
+			const bool isUnitScale = (entity->scale == glm::vec3(1.0f));
+			writer.WriteBool(isUnitScale);
+			if (!isUnitScale)
+			{
+				for (uint32_t a = 0; a < 3; ++a)
+					writer.WriteFloat(entity->scale[a]);
+			}
+		}
+
+		else if (kind == ReplicationEntryKind::Changed)
+		{
+			const bool positionChanged = (entity->position != baseline->position);
+			const bool rotationChanged = (entity->rotation != baseline->rotation);
+			const bool scaleChanged = (entity->scale != baseline->scale);
+			writer.WriteBool(positionChanged);
+			writer.WriteBool(rotationChanged);
+			writer.WriteBool(scaleChanged);
+
+			if (positionChanged)
+			{
+				for (uint32_t a = 0; a < 3; ++a)
+					WriteQuantizedDelta(writer, entity->position[a], baseline->position[a], quantization.positionBits, quantization.positionDeltaBits);
+			}
+			if (rotationChanged)
+			{
+				for (uint32_t a = 0; a < 3; ++a)
+					WriteQuantizedDelta(writer, entity->rotation[a], baseline->rotation[a], quantization.rotationBits, quantization.rotationDeltaBits);
+			}
+			if (scaleChanged)
+			{
+				for (uint32_t a = 0; a < 3; ++a)
+					writer.WriteFloat(entity->scale[a]);
+			}
+		}
+	}
+
+	//encodes a snapshot as the changes from a baseline into packets, with no baseline every entity is sent
+	//the packets are reused between calls, returns how many were written
+	inline size_t Snapshot_Encode(const ReplicationSnapshot& current, const ReplicationSnapshot* baseline, const ReplicationQuantization& quantization,
+		std::vector<ReplicationPacket>& packets, ReplicationEncodeStats* stats = nullptr)
+	{
+		size_t packetCount = 0;
+		uint32_t entryCount = 0, lastIndex = 0;
+		BitWriter writer;
+
+		//closes the packet being written, its entry count goes in the header
+		const auto finishPacket = [&]() {
+			ReplicationPacket* packet = &packets[packetCount - 1];
+			packet->size = (uint32_t)writer.GetByteCount();
+			packet->data[15] = (uint8_t)entryCount;
+			packet->data[16] = (uint8_t)(entryCount >> 8);
+			};
+
+		//starts a packet, the fragment count is filled in at the end
+		const auto startPacket = [&]() {
+			if (packetCount > 0)
+				finishPacket();
+			if (packets.size() <= packetCount)
+				packets.emplace_back();
+
+			writer.Start(packets[packetCount].data.data(), MAX_PACKET_SIZE);
+			writer.Write(REPLICATION_PACKET_MAGIC, 16);
+			writer.Write(REPLICATION_PACKET_TYPE_SNAPSHOT, 8);
+			writer.Write(current.sequence, 32);
+			writer.Write(baseline ? baseline->sequence : REPLICATION_NO_BASELINE, 32);
+			writer.Write((uint32_t)packetCount, 16);
+			writer.Write(0, 16);
+			writer.Write(0, 16);
+
+			packetCount++;
+			entryCount = 0;
+			lastIndex = 0;
+			};
+
+		//writes a entry, moving on to a new packet if it might not fit
+		const auto writeEntry = [&](ReplicationEntryKind kind, uint32_t index, const ReplicatedEntity* entity, const ReplicatedEntity* baselineEntity) {
+			if (writer.GetBitsLeft() < REPLICATION_MAX_ENTRY_BITS || entryCount == UINT16_MAX)
+				startPacket();
+			Snapshot_WriteEntry(writer, kind, index - lastIndex, entity, baselineEntity, quantization);
+			lastIndex = index;
+			entryCount++;
+			};
+
+		startPacket();
+
+		//walks both snapshots in index order
+		const std::vector<ReplicatedEntity>& entities = current.entities;
+		const size_t baselineCount = (baseline ? baseline->entities.size() : 0);
+		size_t c = 0, b = 0;
+		ReplicationEncodeStats encodeStats;
+		encodeStats.entities = entities.size();
+		while (c < entities.size() || b < baselineCount)
+		{
+			const ReplicatedEntity* entity = (c < entities.size() ? &entities[c] : nullptr);
+			const ReplicatedEntity* baselineEntity = (b < baselineCount ? &baseline->entities[b] : nullptr);
+
+			//gone since the baseline
+			if (!entity || (baselineEntity && baselineEntity->GetIndex() < entity->GetIndex()))
+			{
+				writeEntry(ReplicationEntryKind::Removed, baselineEntity->GetIndex(), nullptr, nullptr);
+				encodeStats.removed++;
+				b++;
+				continue;
+			}
+
+			//new since the baseline, or a new entity in a old one's slot
+			if (!baselineEntity || entity->GetIndex() < baselineEntity->GetIndex() || entity->entityID != baselineEntity->entityID)
+			{
+				writeEntry(ReplicationEntryKind::New, entity->GetIndex(), entity, nullptr);
+				encodeStats.added++;
+				b += (baselineEntity && baselineEntity->GetIndex() == entity->GetIndex() ? 1 : 0);
+				c++;
+				continue;
+			}
+
+			//the same entity, unchanged ones aren't sent
+			if (entity->position != baselineEntity->position || entity->rotation != baselineEntity->rotation || entity->scale != baselineEntity->scale)
+			{
+				writeEntry(ReplicationEntryKind::Changed, entity->GetIndex(), entity, baselineEntity);
+				encodeStats.changed++;
+			}
+			else
+				encodeStats.unchanged++;
+			c++;
+			b++;
+		}
+
+		finishPacket();
+
+		//every packet knows how many make up the snapshot
+		for (size_t i = 0; i < packetCount; ++i)
+		{
+			packets[i].data[13] = (uint8_t)packetCount;
+			packets[i].data[14] = (uint8_t)(packetCount >> 8);
+			encodeStats.bytes += packets[i].size;
+		}
+		encodeStats.packets = packetCount;
+
+		if (stats)
+			*stats = encodeStats;
+		return packetCount;
+	}
+
+	//defines a client as the server sees it, what it has acked
+	struct ReplicationClient
+	{
+		uint32_t ackedSequence = REPLICATION_NO_BASELINE;
+		NetAddress address;
+
+		//the snapshot being sent whole while the client has no baseline. A whole snapshot takes many packets so the same one is sent
+		//until it's acked, the client keeps the packets it got from each send, otherwise one lost packet a send would mean it never gets one
+		uint32_t fullSequence = REPLICATION_NO_BASELINE;
+
+		//takes a ack from the client, old acks are ignored
+		inline void Ack(uint32_t sequence)
+		{
+			if (ackedSequence == REPLICATION_NO_BASELINE || sequence > ackedSequence)
+				ackedSequence = sequence;
+		}
+	};
+
+	//defines the server side, it keeps the last snapshots so each client can be sent the changes since the one it acked
+	struct SnapshotEncoder
+	{
+		ReplicationQuantization quantization;
+		std::array<ReplicationSnapshot, REPLICATION_HISTORY_SIZE> history;
+		uint32_t nextSequence = 0;
+
+		std::vector<ReplicationPacket> packets; //the packets of the last encode, reused
+		ReplicationEncodeStats stats; //the stats of the last encode
+
+		//starts the next snapshot, fill it then call EndSnapshot
+		inline ReplicationSnapshot& BeginSnapshot()
+		{
+			ReplicationSnapshot* snapshot = &history[nextSequence % REPLICATION_HISTORY_SIZE];
+			snapshot->sequence = nextSequence;
+			snapshot->entities.clear();
+			return *snapshot;
+		}
+
+		//sorts the snapshot and makes it the latest
+		inline void EndSnapshot()
+		{
+			history[nextSequence % REPLICATION_HISTORY_SIZE].Sort();
+			nextSequence++;
+		}
+
+		//gets a snapshot that's still kept, nullptr if it's too old or there is none
+		inline const ReplicationSnapshot* GetSnapshot(uint32_t sequence) const
+		{
+			if (sequence == REPLICATION_NO_BASELINE || sequence >= nextSequence || nextSequence - sequence > REPLICATION_HISTORY_SIZE)
+				return nullptr;
+			return &history[sequence % REPLICATION_HISTORY_SIZE];
+		}
+
+		//encodes the latest snapshot for a client against the one it acked, returns how many packets to send
+		//a client with no baseline kept is sent the same whole snapshot until it acks it or it's too old
+		inline size_t EncodeForClient(ReplicationClient& client)
+		{
+			if (nextSequence == 0)
+				return 0;
+
+			const ReplicationSnapshot* baseline = GetSnapshot(client.ackedSequence);
+			if (baseline)
+			{
+				client.fullSequence = REPLICATION_NO_BASELINE;
+				return Snapshot_Encode(*GetSnapshot(nextSequence - 1), baseline, quantization, packets, &stats);
+			}
+
+			if (!GetSnapshot(client.fullSequence))
+				client.fullSequence = nextSequence - 1;
+			return Snapshot_Encode(*GetSnapshot(client.fullSequence), nullptr, quantization, packets, &stats);
+		}
+	};
+
+	//defines the client side, it puts the packets of each snapshot back together on top of the baseline they were encoded against
+	struct SnapshotDecoder
+	{
+		//defines a entry read from a packet, the changed ones already have the baseline applied
+		struct DecodedEntry
+		{
+			ReplicationEntryKind kind = ReplicationEntryKind::Changed;
+			ReplicatedEntity entity;
+		};
+
+		ReplicationQuantization quantization;
+		std::array<ReplicationSnapshot, REPLICATION_HISTORY_SIZE> history;
+		uint32_t latestSequence = REPLICATION_NO_BASELINE; //the newest whole snapshot, the one to ack
+
+		//the snapshot being put together
+		uint32_t pendingSequence = REPLICATION_NO_BASELINE, pendingBaseline = REPLICATION_NO_BASELINE;
+		uint32_t pendingFragmentCount = 0, pendingFragmentsReceived = 0;
+		std::vector<uint8_t> pendingFragments;
+		std::vector<DecodedEntry> pendingEntries;
+
+		uint64_t packetsRejected = 0;
+
+		//gets a whole snapshot that's still kept, nullptr if there is none
+		inline const ReplicationSnapshot* GetSnapshot(uint32_t sequence) const
+		{
+			if (sequence == REPLICATION_NO_BASELINE || latestSequence == REPLICATION_NO_BASELINE || sequence > latestSequence ||
+				latestSequence - sequence >= REPLICATION_HISTORY_SIZE || history[sequence % REPLICATION_HISTORY_SIZE].sequence != sequence)
+				return nullptr;
+			return &history[sequence % REPLICATION_HISTORY_SIZE];
+		}
+
+		//gets the newest whole snapshot, nullptr if none has come in
+		inline const ReplicationSnapshot* GetLatest() const { return GetSnapshot(latestSequence); }
+
+		//merges the entries with the baseline once every packet of the snapshot is in
+		inline void FinishPending(const ReplicationSnapshot* baseline)
+		{
+			std::sort(pendingEntries.begin(), pendingEntries.end(), [](const DecodedEntry& a, const DecodedEntry& b) { return a.entity.GetIndex() < b.entity.GetIndex(); });
+
+			//ReadPacket rejects baselines REPLICATION_HISTORY_SIZE or more behind, so the baseline is never in the slot being written
+			ReplicationSnapshot* snapshot = &history[pendingSequence % REPLICATION_HISTORY_SIZE];
+			snapshot->sequence = pendingSequence;
+			snapshot->entities.clear();
+
+			const size_t baselineCount = (baseline ? baseline->entities.size() : 0);
+			size_t e = 0, b = 0;
+			while (e < pendingEntries.size() || b < baselineCount)
+			{
+				const DecodedEntry* entry = (e < pendingEntries.size() ? &pendingEntries[e] : nullptr);
+				const ReplicatedEntity* baselineEntity = (b < baselineCount ? &baseline->entities[b] : nullptr);
+
+				//unchanged since the baseline
+				if (!entry || (baselineEntity && baselineEntity->GetIndex() < entry->entity.GetIndex()))
+				{
+					snapshot->entities.emplace_back(*baselineEntity);
+					b++;
+					continue;
+				}
+
+				if (baselineEntity && baselineEntity->GetIndex() == entry->entity.GetIndex())
+					b++;
+				if (entry->kind != ReplicationEntryKind::Removed)
+					snapshot->entities.emplace_back(entry->entity);
+				e++;
+			}
+
+			latestSequence = pendingSequence;
+			pendingSequence = REPLICATION_NO_BASELINE;
+		}
+
+		//reads a packet, returns true once it completes a snapshot. Ack latestSequence back to the server when it does
+		inline bool ReadPacket(const uint8_t* data, size_t size)
+		{
+			BitReader reader;
+			reader.Start(data, size);
+			if (size < REPLICATION_PACKET_HEADER_SIZE || reader.Read(16) != REPLICATION_PACKET_MAGIC || reader.Read(8) != REPLICATION_PACKET_TYPE_SNAPSHOT)
+			{
+				packetsRejected++;
+				return false;
+			}
+
+			const uint32_t sequence = reader.Read(32);
+			const uint32_t baselineSequence = reader.Read(32);
+			const uint32_t fragment = reader.Read(16);
+			const uint32_t fragmentCount = reader.Read(16);
+			const uint32_t entryCount = reader.Read(16);
+
+			//old snapshots are dropped, a newer one replaces the one being put together
+			if ((latestSequence != REPLICATION_NO_BASELINE && sequence <= latestSequence) || fragment >= fragmentCount)
+				return false;
+
+			//a baseline a whole history behind shares the snapshot's slot and would be overwritten while it's merged
+			//the encoder never sends one, the client keeps acking and gets a whole snapshot once its ack is too old
+			const ReplicationSnapshot* baseline = GetSnapshot(baselineSequence);
+			if (baselineSequence != REPLICATION_NO_BASELINE && (!baseline || sequence - baselineSequence >= REPLICATION_HISTORY_SIZE))
+			{
+				packetsRejected++;
+				return false;
+			}
+
+			if (sequence != pendingSequence)
+			{
+				if (pendingSequence != REPLICATION_NO_BASELINE && sequence < pendingSequence)
+					return false;
+
+				pendingSequence = sequence;
+				pendingBaseline = baselineSequence;
+				pendingFragmentCount = fragmentCount;
+				pendingFragmentsReceived = 0;
+				pendingFragments.assign(fragmentCount, 0);
+				pendingEntries.clear();
+			}
+
+			if (pendingFragments[fragment] || fragmentCount != pendingFragmentCount || baselineSequence != pendingBaseline)
+				return false;
+
+			//reads the entries, a bad one throws the packet away
+			const size_t firstEntry = pendingEntries.size();
+			uint32_t index = 0;
+			for (uint32_t i = 0; i < entryCount; ++i)
+			{
+				index += reader.ReadVarBits();
+				const ReplicationEntryKind kind = (ReplicationEntryKind)reader.Read(2);
+
+				DecodedEntry* entry = &pendingEntries.emplace_back();
+				entry->kind = kind;
+				if (kind == ReplicationEntryKind::New)
+				{
+					entry->entity.entityID = ECS::Entity_PackID(index, reader.ReadVarBits());
+					for (uint32_t a = 0; a < 3; ++a)
+						entry->entity.position[a] = reader.Read(quantization.positionBits);
+					for (uint32_t a = 0; a < 3; ++a)
+						entry->entity.rotation[a] = reader.Read(quantization.rotationBits);
+					if (!reader.ReadBool())
+					{
+						for (uint32_t a = 0; a < 3; ++a)
+							entry->entity.scale[a] = reader.ReadFloat();
+					}
+				}
+
+				else if (kind == ReplicationEntryKind::Changed)
+				{
+					const ReplicatedEntity* baselineEntity = (baseline ? baseline->Find(index) : nullptr);
+					if (!baselineEntity)
+					{
+						reader.hasOverflowed = true;
+						break;
+					}
+
+					entry->entity = *baselineEntity;
+					const bool positionChanged = reader.ReadBool(), rotationChanged = reader.ReadBool(), scaleChanged = reader.ReadBool();
+					if (positionChanged)
+					{
+						for (uint32_t a = 0; a < 3; ++a)
+							entry->entity.position[a] = ReadQuantizedDelta(reader, baselineEntity->position[a], quantization.positionBits, quantization.positionDeltaBits);
+					}
+					if (rotationChanged)
+					{
+						for (uint32_t a = 0; a < 3; ++a)
+							entry->entity.rotation[a] = ReadQuantizedDelta(reader, baselineEntity->rotation[a], quantization.rotationBits, quantization.rotationDeltaBits);
+					}
+					if (scaleChanged)
+					{
+						for (uint32_t a = 0; a < 3; ++a)
+							entry->entity.scale[a] = reader.ReadFloat();
+					}
+				}
+
+				else if (kind == ReplicationEntryKind::Removed)
+					entry->entity.entityID = ECS::Entity_PackID(index, 0);
+
+				else
+					reader.hasOverflowed = true;
+
+				if (reader.hasOverflowed)
+					break;
+			}
+
+			if (reader.hasOverflowed)
+			{
+				pendingEntries.resize(firstEntry);
+				packetsRejected++;
+				return false;
+			}
+
+			pendingFragments[fragment] = 1;
+			if (++pendingFragmentsReceived < pendingFragmentCount)
+				return false;
+
+			FinishPending(baseline);
+			return true;
+		}
+	};
+}
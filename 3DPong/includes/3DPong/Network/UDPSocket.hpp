@@ -0,0 +1,224 @@
+#pragma once
+
+//defines a non blocking UDP socket, Winsock on Windows and BSD sockets everywhere else
+
+#include <fmt/color.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mstcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Pong3D::Network
+{
+#if defined(_WIN32)
+	using SocketHandle = SOCKET;
+	static constexpr SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+#else
+	using SocketHandle = int;
+	static constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+#endif
+
+	//the biggest packet that is sent, well under the usual MTU so nothing is fragmented
+	static constexpr size_t MAX_PACKET_SIZE = 1200;
+
+	//defines a IPv4 address and port, both in host byte order
+	struct NetAddress
+	{
+		uint32_t ip = 0;
+		uint16_t port = 0;
+
+		inline bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+		inline bool operator!=(const NetAddress& other) const { return !(*this == other); }
+
+		//makes a address from a dotted IPv4 string, returns a address with a IP of 0 if it can't be read
+		static inline NetAddress FromString(const char* ipString, uint16_t port)
+		{
+			NetAddress address;
+			in_addr parsed = {};
+			if (inet_pton(AF_INET, ipString, &parsed) == 1)
+				address.ip = ntohl(parsed.s_addr);
+			address.port = port;
+			return address;
+		}
+
+		//gets the address as "a.b.c.d:port"
+		inline std::string ToString() const
+		{
+			return fmt::format("{}.{}.{}.{}:{}", (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF, port);
+		}
+	};
+
+#if defined(_WIN32)
+	//gets how many sockets are holding Winsock open
+	inline int& Network_GetInitCount()
+	{
+		static int initCount = 0;
+		return initCount;
+	}
+#endif
+
+	//starts the platform's socket library, Winsock needs it before any socket is made. Counted so every socket can call it
+	inline bool Network_Init()
+	{
+#if defined(_WIN32)
+		int& initCount = Network_GetInitCount();
+		if (initCount++ > 0)
+			return true;
+
+		WSADATA data;
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		{
+			initCount = 0;
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE NETWORK ERROR: Network_Init || Failed to start Winsock!\n");
+			return false;
+		}
+#endif
+		return true;
+	}
+
+	//stops the platform's socket library once the last Network_Init is matched
+	inline void Network_Shutdown()
+	{
+#if defined(_WIN32)
+		int& initCount = Network_GetInitCount();
+		if (initCount > 0 && --initCount == 0)
+			WSACleanup();
+#endif
+	}
+
+	//defines a UDP socket
+	struct UDPSocket
+	{
+		SocketHandle handle = INVALID_SOCKET_HANDLE;
+		uint16_t port = 0; //the port it's bound to
+
+		//is the socket open
+		inline bool IsOpen() const { return handle != INVALID_SOCKET_HANDLE; }
+
+		//opens the socket on a port, 0 lets the OS pick one. The socket never blocks
+		inline bool Open(uint16_t _port = 0)
+		{
+			if (IsOpen())
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE NETWORK WARNING: UDP Socket || Open || The socket is already open on port {}!\n", port);
+				return true;
+			}
+
+			if (!Network_Init())
+				return false;
+
+			handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+			if (handle == INVALID_SOCKET_HANDLE)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE NETWORK ERROR: UDP Socket || Open || Failed to make the socket!\n");
+				Network_Shutdown();
+				return false;
+			}
+
+			sockaddr_in bindAddress = {};
+			bindAddress.sin_family = AF_INET;
+			bindAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+			bindAddress.sin_port = htons(_port);
+			if (bind(handle, (const sockaddr*)&bindAddress, sizeof(bindAddress)) != 0)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE NETWORK ERROR: UDP Socket || Open || Failed to bind to port {}!\n", _port);
+				Close();
+				return false;
+			}
+
+			//non blocking, the game polls it every tick
+#if defined(_WIN32)
+			u_long nonBlocking = 1;
+			const bool setNonBlocking = (ioctlsocket(handle, FIONBIO, &nonBlocking) == 0);
+
+			//Windows reports a ICMP port unreachable from a earlier send as a WSAECONNRESET on the next receive, which would stop the polling
+			BOOL reportConnectionReset = FALSE;
+			DWORD bytesReturned = 0;
+			WSAIoctl(handle, SIO_UDP_CONNRESET, &reportConnectionReset, sizeof(reportConnectionReset), nullptr, 0, &bytesReturned, nullptr, nullptr);
+#else
+			const bool setNonBlocking = (fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) != -1);
+#endif
+			if (!setNonBlocking)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE NETWORK ERROR: UDP Socket || Open || Failed to make the socket non blocking!\n");
+				Close();
+				return false;
+			}
+
+			//gets the port the OS picked
+			sockaddr_in boundAddress = {};
+			socklen_t boundAddressSize = sizeof(boundAddress);
+			getsockname(handle, (sockaddr*)&boundAddress, &boundAddressSize);
+			port = ntohs(boundAddress.sin_port);
+			return true;
+		}
+
+		//closes the socket
+		inline void Close()
+		{
+			if (!IsOpen())
+				return;
+
+#if defined(_WIN32)
+			closesocket(handle);
+#else
+			close(handle);
+#endif
+			handle = INVALID_SOCKET_HANDLE;
+			port = 0;
+			Network_Shutdown();
+		}
+
+		//sends a packet, returns false if it couldn't be sent. UDP gives no word on if it arrives
+		inline bool Send(const NetAddress& to, const void* data, size_t size)
+		{
+			sockaddr_in address = {};
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(to.ip);
+			address.sin_port = htons(to.port);
+			return sendto(handle, (const char*)data, (int)size, 0, (const sockaddr*)&address, sizeof(address)) == (int)size;
+		}
+
+		//receives a packet if one is waiting, returns its size or 0 if there's nothing
+		inline size_t Receive(void* data, size_t capacity, NetAddress& from)
+		{
+			sockaddr_in address = {};
+			socklen_t addressSize = sizeof(address);
+			int received = (int)recvfrom(handle, (char*)data, (int)capacity, 0, (sockaddr*)&address, &addressSize);
+#if defined(_WIN32)
+			//a reset left over from a send to a closed port isn't a packet, the next one may be waiting behind it
+			while (received < 0 && WSAGetLastError() == WSAECONNRESET)
+			{
+				addressSize = sizeof(address);
+				received = (int)recvfrom(handle, (char*)data, (int)capacity, 0, (sockaddr*)&address, &addressSize);
+			}
+#endif
+			if (received <= 0)
+				return 0;
+
+			from.ip = ntohl(address.sin_addr.s_addr);
+			from.port = ntohs(address.sin_port);
+			return (size_t)received;
+		}
+	};
+}
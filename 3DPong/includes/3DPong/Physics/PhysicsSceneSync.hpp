@@ -0,0 +1,59 @@
+#pragma once
+
+//defines writing the physics world back into the scene, the renderables it moved are marked for the transform sync
+
+#include <3DPong/Physics/PongPhysics.hpp>
+#include <3DPong/Physics/SimulationThread.hpp>
+#include <3DPong/ECS/Scene.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+namespace Pong3D::Physics
+{
+	//writes the balls' and paddles' positions into their renderables, call once a frame after the fixed steps
+	//returns how many were written
+	inline uint64_t Physics_WriteToScene(const PhysicsWorld& world, Scene::Scene& scene)
+	{
+		PONG3D_PROFILE_ZONE("Physics Write To Scene");
+		uint64_t writtenCount = 0;
+		for (size_t i = 0; i < world.balls.Size(); ++i)
+		{
+			const ECS::RenderableRef ref = scene.Renderable_MarkDirty(world.balls.entityIDs[i]);
+			if (!ref.IsValid())
+				continue;
+
+			ref.Position() = glm::vec3(world.balls.x[i], world.balls.y[i], world.balls.z[i]);
+			writtenCount++;
+		}
+
+		for (size_t i = 0; i < world.paddles.Size(); ++i)
+		{
+			const ECS::RenderableRef ref = scene.Renderable_MarkDirty(world.paddles.entityIDs[i]);
+			if (!ref.IsValid())
+				continue;
+
+			ref.Position() = glm::vec3(world.paddles.x[i], world.paddles.y[i], world.paddles.z[i]);
+			writtenCount++;
+		}
+
+		return writtenCount;
+	}
+
+	//writes a simulation snapshot into the renderables, the positions are blended between the last two steps by alpha
+	//returns how many were written
+	inline uint64_t Physics_WriteSnapshotToScene(const SimulationSnapshot& snapshot, float alpha, Scene::Scene& scene)
+	{
+		PONG3D_PROFILE_ZONE("Physics Write Snapshot To Scene");
+		uint64_t writtenCount = 0;
+		for (size_t i = 0; i < snapshot.entityIDs.size(); ++i)
+		{
+			const ECS::RenderableRef ref = scene.Renderable_MarkDirty(snapshot.entityIDs[i]);
+			if (!ref.IsValid())
+				continue;
+
+			ref.Position() = snapshot.previousPositions[i] + (snapshot.positions[i] - snapshot.previousPositions[i]) * alpha;
+			writtenCount++;
+		}
+
+		return writtenCount;
+	}
+}
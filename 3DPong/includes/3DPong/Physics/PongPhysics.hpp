@@ -0,0 +1,405 @@
+#pragma once
+
+//defines the physics of the Pong world, balls are spheres and paddles are boxes inside a box shaped arena
+//the balls are stored as arrays of each part and moved 4 (SSE) or 8 (AVX) at a time, a uniform grid finds the balls near each paddle
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX__)
+#define PONG3D_PHYSICS_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG3D_PHYSICS_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Pong3D::Physics
+{
+	//defines the lanes the balls are moved in, one register of floats
+#if defined(PONG3D_PHYSICS_AVX)
+	struct PhysicsLanes
+	{
+		typedef __m256 Reg;
+		static constexpr size_t WIDTH = 8;
+
+		static inline Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+		static inline void Store(float* p, Reg a) { _mm256_storeu_ps(p, a); }
+		static inline Reg Set(float a) { return _mm256_set1_ps(a); }
+		static inline Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+		static inline Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+		static inline Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+		static inline Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+		static inline Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+		static inline Reg Less(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static inline Reg Greater(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static inline Reg Or(Reg a, Reg b) { return _mm256_or_ps(a, b); }
+		static inline Reg Select(Reg mask, Reg a, Reg b) { return _mm256_blendv_ps(b, a, mask); }
+		static inline Reg Abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		static inline int Mask(Reg a) { return _mm256_movemask_ps(a); }
+	};
+#elif defined(PONG3D_PHYSICS_SSE)
+	struct PhysicsLanes
+	{
+		typedef __m128 Reg;
+		static constexpr size_t WIDTH = 4;
+
+		static inline Reg Load(const float* p) { return _mm_loadu_ps(p); }
+		static inline void Store(float* p, Reg a) { _mm_storeu_ps(p, a); }
+		static inline Reg Set(float a) { return _mm_set1_ps(a); }
+		static inline Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+		static inline Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+		static inline Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+		static inline Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+		static inline Reg Max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+		static inline Reg Less(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+		static inline Reg Greater(Reg a, Reg b) { return _mm_cmpgt_ps(a, b); }
+		static inline Reg Or(Reg a, Reg b) { return _mm_or_ps(a, b); }
+		static inline Reg Select(Reg mask, Reg a, Reg b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); } //SSE2 has no blend
+		static inline Reg Abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		static inline int Mask(Reg a) { return _mm_movemask_ps(a); }
+	};
+#endif
+
+	//defines the balls, stored as arrays of each part so they can be loaded a register at a time
+	struct BallSoA
+	{
+		std::vector<float> x, y, z;
+		std::vector<float> vx, vy, vz;
+		std::vector<float> radius;
+		std::vector<uint64_t> entityIDs; //the entity each ball moves
+
+		inline size_t Size() const { return x.size(); }
+
+		inline void Reserve(size_t count)
+		{
+			x.reserve(count); y.reserve(count); z.reserve(count);
+			vx.reserve(count); vy.reserve(count); vz.reserve(count);
+			radius.reserve(count); entityIDs.reserve(count);
+		}
+
+		//adds a ball, returns its index
+		inline size_t Add(uint64_t entityID, const glm::vec3& position, const glm::vec3& velocity, float _radius)
+		{
+			x.emplace_back(position.x); y.emplace_back(position.y); z.emplace_back(position.z);
+			vx.emplace_back(velocity.x); vy.emplace_back(velocity.y); vz.emplace_back(velocity.z);
+			radius.emplace_back(_radius); entityIDs.emplace_back(entityID);
+			return x.size() - 1;
+		}
+
+		//removes a ball, the last ball is moved into its index
+		inline void RemoveAt(size_t index)
+		{
+			const size_t last = x.size() - 1;
+			x[index] = x[last]; y[index] = y[last]; z[index] = z[last];
+			vx[index] = vx[last]; vy[index] = vy[last]; vz[index] = vz[last];
+			radius[index] = radius[last]; entityIDs[index] = entityIDs[last];
+
+			x.pop_back(); y.pop_back(); z.pop_back();
+			vx.pop_back(); vy.pop_back(); vz.pop_back();
+			radius.pop_back(); entityIDs.pop_back();
+		}
+	};
+
+	//defines the paddles, boxes that move with the velocity the game gives them and stop at the arena walls
+	struct PaddleSoA
+	{
+		std::vector<float> x, y, z; //the center
+		std::vector<float> halfX, halfY, halfZ;
+		std::vector<float> vx, vy, vz;
+		std::vector<uint64_t> entityIDs;
+
+		inline size_t Size() const { return x.size(); }
+
+		//adds a paddle, returns its index
+		inline size_t Add(uint64_t entityID, const glm::vec3& position, const glm::vec3& halfExtents)
+		{
+			x.emplace_back(position.x); y.emplace_back(position.y); z.emplace_back(position.z);
+			halfX.emplace_back(halfExtents.x); halfY.emplace_back(halfExtents.y); halfZ.emplace_back(halfExtents.z);
+			vx.emplace_back(0.0f); vy.emplace_back(0.0f); vz.emplace_back(0.0f);
+			entityIDs.emplace_back(entityID);
+			return x.size() - 1;
+		}
+
+		//sets a paddle's velocity, it's kept until it's set again
+		inline void SetVelocity(size_t index, const glm::vec3& velocity) { vx[index] = velocity.x; vy[index] = velocity.y; vz[index] = velocity.z; }
+	};
+
+	//defines a copy of the parts of the world that change as it steps, the rollback netcode keeps one for each tick
+	//copying into a state that's already the right size reuses its memory
+	struct PhysicsState
+	{
+		BallSoA balls;
+		PaddleSoA paddles;
+	};
+
+	//defines the settings of the physics world
+	struct PhysicsWorld_CreateInfo
+	{
+		glm::vec3 arenaMin = glm::vec3(-10.0f, -8.0f, 0.0f), arenaMax = glm::vec3(10.0f, 8.0f, 14.0f); //the walls
+		float restitution = 1.0f; //how much speed a bounce keeps, Pong balls don't slow down
+		float gridCellSize = 2.0f; //the size of the broadphase cells, about the size of a paddle works best
+	};
+
+	//defines the stats of the last step
+	struct PhysicsStepStats
+	{
+		uint64_t wallBounces = 0;
+		uint64_t paddleCandidates = 0; //how many balls the broadphase put near a paddle
+		uint64_t paddleHits = 0;
+	};
+
+	//defines the physics world
+	struct PhysicsWorld
+	{
+		glm::vec3 arenaMin = glm::vec3(0.0f), arenaMax = glm::vec3(0.0f);
+		float restitution = 1.0f;
+
+		BallSoA balls;
+		PaddleSoA paddles;
+
+		//the broadphase grid, the balls are counting sorted into the cells each step. Kept around so the memory is reused
+		float gridCellSize = 2.0f;
+		uint32_t gridSizeX = 1, gridSizeY = 1, gridSizeZ = 1;
+		std::vector<uint32_t> ballCells; //the cell of each ball
+		std::vector<uint32_t> cellStarts; //where each cell's balls start in cellBalls, one extra at the end
+		std::vector<uint32_t> cellBalls; //the ball indices sorted by cell
+
+		PhysicsStepStats stats;
+
+		//sets up the world
+		inline void Create(const PhysicsWorld_CreateInfo& info = PhysicsWorld_CreateInfo())
+		{
+			arenaMin = info.arenaMin; arenaMax = info.arenaMax;
+			restitution = info.restitution;
+
+			gridCellSize = (info.gridCellSize > 0.0f ? info.gridCellSize : 2.0f);
+			gridSizeX = std::max(1u, (uint32_t)std::ceil((arenaMax.x - arenaMin.x) / gridCellSize));
+			gridSizeY = std::max(1u, (uint32_t)std::ceil((arenaMax.y - arenaMin.y) / gridCellSize));
+			gridSizeZ = std::max(1u, (uint32_t)std::ceil((arenaMax.z - arenaMin.z) / gridCellSize));
+			cellStarts.assign((size_t)gridSizeX * gridSizeY * gridSizeZ + 1, 0);
+		}
+
+		//gets the cell along one axis, clamped into the grid
+		static inline uint32_t GetCellCoord(float position, float arenaMinimum, float inverseCellSize, uint32_t gridSize)
+		{
+			const float cell = (position - arenaMinimum) * inverseCellSize;
+			return (cell <= 0.0f ? 0 : std::min((uint32_t)cell, gridSize - 1));
+		}
+
+		//moves the balls along one axis and bounces them off the two walls on it, returns how many bounced
+		static inline uint64_t IntegrateAxis(float* position, float* velocity, const float* radius, size_t count, float dt, float wallMin, float wallMax, float restitution)
+		{
+			uint64_t bounces = 0;
+			size_t i = 0;
+
+#if defined(PONG3D_PHYSICS_AVX) || defined(PONG3D_PHYSICS_SSE)
+			typedef PhysicsLanes L;
+			const L::Reg step = L::Set(dt), lowWall = L::Set(wallMin), highWall = L::Set(wallMax), bounce = L::Set(restitution), two = L::Set(2.0f);
+			for (; i + L::WIDTH <= count; i += L::WIDTH)
+			{
+				const L::Reg r = L::Load(radius + i);
+				L::Reg p = L::Load(position + i), v = L::Load(velocity + i);
+				p = L::Add(p, L::Mul(v, step));
+
+				//past a wall, the ball is mirrored back inside and heads away from it
+				const L::Reg low = L::Add(lowWall, r), high = L::Sub(highWall, r);
+				const L::Reg isBelow = L::Less(p, low), isAbove = L::Greater(p, high);
+				p = L::Select(isBelow, L::Sub(L::Mul(two, low), p), p);
+				p = L::Select(isAbove, L::Sub(L::Mul(two, high), p), p);
+				p = L::Max(low, L::Min(p, high)); //a ball moving more than the arena in a step
+
+				const L::Reg speed = L::Mul(L::Abs(v), bounce);
+				v = L::Select(isBelow, speed, v);
+				v = L::Select(isAbove, L::Sub(L::Set(0.0f), speed), v);
+
+				L::Store(position + i, p);
+				L::Store(velocity + i, v);
+				bounces += (uint64_t)std::popcount((uint32_t)L::Mask(L::Or(isBelow, isAbove)));
+			}
+#endif
+
+			//what's left over, or everything if there is no SIMD
+			for (; i < count; ++i)
+			{
+				float p = position[i] + velocity[i] * dt;
+				const float low = wallMin + radius[i], high = wallMax - radius[i];
+				if (p < low)
+				{
+					p = std::min(2.0f * low - p, high);
+					velocity[i] = std::abs(velocity[i]) * restitution;
+					bounces++;
+				}
+				else if (p > high)
+				{
+					p = std::max(2.0f * high - p, low);
+					velocity[i] = -std::abs(velocity[i]) * restitution;
+					bounces++;
+				}
+				position[i] = p;
+			}
+
+			return bounces;
+		}
+
+		//sorts the balls into the grid cells
+		inline void BuildBroadphase()
+		{
+			const size_t ballCount = balls.Size();
+			const float inverseCellSize = 1.0f / gridCellSize;
+			ballCells.resize(ballCount);
+			cellBalls.resize(ballCount);
+			std::fill(cellStarts.begin(), cellStarts.end(), 0);
+
+			for (size_t i = 0; i < ballCount; ++i)
+			{
+				const uint32_t cell = GetCellCoord(balls.x[i], arenaMin.x, inverseCellSize, gridSizeX) +
+					gridSizeX * (GetCellCoord(balls.y[i], arenaMin.y, inverseCellSize, gridSizeY) +
+					gridSizeY * GetCellCoord(balls.z[i], arenaMin.z, inverseCellSize, gridSizeZ));
+				ballCells[i] = cell;
+				cellStarts[cell + 1]++;
+			}
+
+			for (size_t c = 1; c < cellStarts.size(); ++c)
+				cellStarts[c] += cellStarts[c - 1];
+
+			//cellStarts is bumped while filling, then moved back a cell so it holds the starts again
+			for (size_t i = 0; i < ballCount; ++i)
+				cellBalls[cellStarts[ballCells[i]]++] = (uint32_t)i;
+			for (size_t c = cellStarts.size() - 1; c > 0; --c)
+				cellStarts[c] = cellStarts[c - 1];
+			cellStarts[0] = 0;
+		}
+
+		//pushes a ball out of a paddle and bounces it off, returns true if they touched
+		inline bool CollideBallPaddle(size_t ball, size_t paddle)
+		{
+			const float bx = balls.x[ball], by = balls.y[ball], bz = balls.z[ball], r = balls.radius[ball];
+			const float px = paddles.x[paddle], py = paddles.y[paddle], pz = paddles.z[paddle];
+			const float hx = paddles.halfX[paddle], hy = paddles.halfY[paddle], hz = paddles.halfZ[paddle];
+
+			//the closest point on the box
+			const float dx = bx - std::clamp(bx, px - hx, px + hx), dy = by - std::clamp(by, py - hy, py + hy), dz = bz - std::clamp(bz, pz - hz, pz + hz);
+			const float distanceSquared = dx * dx + dy * dy + dz * dz;
+			if (distanceSquared > r * r)
+				return false;
+
+			float nx = 0.0f, ny = 0.0f, nz = 0.0f, penetration = 0.0f;
+			if (distanceSquared > 1e-12f)
+			{
+				const float distance = std::sqrt(distanceSquared);
+				nx = dx / distance; ny = dy / distance; nz = dz / distance;
+				penetration = r - distance;
+			}
+			else
+			{
+				//the center is inside the box, it leaves through the closest face
+				const float ox = hx - std::abs(bx - px), oy = hy - std::abs(by - py), oz = hz - std::abs(bz - pz);
+				if (ox <= oy && ox <= oz) { nx = (bx < px ? -1.0f : 1.0f); penetration = ox + r; }
+				else if (oy <= oz) { ny = (by < py ? -1.0f : 1.0f); penetration = oy + r; }
+				else { nz = (bz < pz ? -1.0f : 1.0f); penetration = oz + r; }
+			}
+
+			balls.x[ball] += nx * penetration; balls.y[ball] += ny * penetration; balls.z[ball] += nz * penetration;
+
+			//only bounces if it's heading into the paddle, the paddle's own speed is carried into the ball
+			const float rvx = balls.vx[ball] - paddles.vx[paddle], rvy = balls.vy[ball] - paddles.vy[paddle], rvz = balls.vz[ball] - paddles.vz[paddle];
+			const float normalSpeed = rvx * nx + rvy * ny + rvz * nz;
+			if (normalSpeed < 0.0f)
+			{
+				const float impulse = (1.0f + restitution) * normalSpeed;
+				balls.vx[ball] -= impulse * nx; balls.vy[ball] -= impulse * ny; balls.vz[ball] -= impulse * nz;
+			}
+
+			return true;
+		}
+
+		//saves the balls and paddles into a state
+		inline void SaveState(PhysicsState& state) const
+		{
+			state.balls = balls;
+			state.paddles = paddles;
+		}
+
+		//puts the world back to a saved state, the broadphase is rebuilt by the next step
+		inline void LoadState(const PhysicsState& state)
+		{
+			balls = state.balls;
+			paddles = state.paddles;
+		}
+
+		//hashes the positions and velocities, two worlds stepped with the same inputs have the same checksum
+		inline uint64_t Checksum() const
+		{
+			uint64_t hash = 14695981039346656037ull; //FNV-1a
+			const auto hashFloats = [&](const std::vector<float>& values) {
+				for (size_t i = 0; i < values.size(); ++i)
+				{
+					hash ^= std::bit_cast<uint32_t>(values[i]);
+					hash *= 1099511628211ull;
+				}
+				};
+
+			hashFloats(balls.x); hashFloats(balls.y); hashFloats(balls.z);
+			hashFloats(balls.vx); hashFloats(balls.vy); hashFloats(balls.vz);
+			hashFloats(paddles.x); hashFloats(paddles.y); hashFloats(paddles.z);
+			return hash;
+		}
+
+		//steps the world by a fixed time step
+		inline void Step(float dt)
+		{
+			stats = PhysicsStepStats();
+
+			//paddles, only a few so they're moved one at a time
+			for (size_t p = 0; p < paddles.Size(); ++p)
+			{
+				paddles.x[p] = std::clamp(paddles.x[p] + paddles.vx[p] * dt, arenaMin.x + paddles.halfX[p], arenaMax.x - paddles.halfX[p]);
+				paddles.y[p] = std::clamp(paddles.y[p] + paddles.vy[p] * dt, arenaMin.y + paddles.halfY[p], arenaMax.y - paddles.halfY[p]);
+				paddles.z[p] = std::clamp(paddles.z[p] + paddles.vz[p] * dt, arenaMin.z + paddles.halfZ[p], arenaMax.z - paddles.halfZ[p]);
+			}
+
+			//balls, a axis at a time
+			const size_t ballCount = balls.Size();
+			stats.wallBounces += IntegrateAxis(balls.x.data(), balls.vx.data(), balls.radius.data(), ballCount, dt, arenaMin.x, arenaMax.x, restitution);
+			stats.wallBounces += IntegrateAxis(balls.y.data(), balls.vy.data(), balls.radius.data(), ballCount, dt, arenaMin.y, arenaMax.y, restitution);
+			stats.wallBounces += IntegrateAxis(balls.z.data(), balls.vz.data(), balls.radius.data(), ballCount, dt, arenaMin.z, arenaMax.z, restitution);
+
+			if (paddles.Size() == 0 || ballCount == 0)
+				return;
+
+			//each paddle only checks the balls in the cells its box, grown by the biggest ball, touches
+			BuildBroadphase();
+			const float maxRadius = *std::max_element(balls.radius.begin(), balls.radius.end());
+			const float inverseCellSize = 1.0f / gridCellSize;
+			for (size_t p = 0; p < paddles.Size(); ++p)
+			{
+				const float reachX = paddles.halfX[p] + maxRadius, reachY = paddles.halfY[p] + maxRadius, reachZ = paddles.halfZ[p] + maxRadius;
+				const uint32_t minX = GetCellCoord(paddles.x[p] - reachX, arenaMin.x, inverseCellSize, gridSizeX), maxX = GetCellCoord(paddles.x[p] + reachX, arenaMin.x, inverseCellSize, gridSizeX);
+				const uint32_t minY = GetCellCoord(paddles.y[p] - reachY, arenaMin.y, inverseCellSize, gridSizeY), maxY = GetCellCoord(paddles.y[p] + reachY, arenaMin.y, inverseCellSize, gridSizeY);
+				const uint32_t minZ = GetCellCoord(paddles.z[p] - reachZ, arenaMin.z, inverseCellSize, gridSizeZ), maxZ = GetCellCoord(paddles.z[p] + reachZ, arenaMin.z, inverseCellSize, gridSizeZ);
+
+				for (uint32_t cz = minZ; cz <= maxZ; ++cz)
+				{
+					for (uint32_t cy = minY; cy <= maxY; ++cy)
+					{
+						for (uint32_t cx = minX; cx <= maxX; ++cx)
+						{
+							const uint32_t cell = cx + gridSizeX * (cy + gridSizeY * cz);
+							for (uint32_t b = cellStarts[cell]; b < cellStarts[cell + 1]; ++b)
+							{
+								stats.paddleCandidates++;
+								stats.paddleHits += (CollideBallPaddle(cellBalls[b], p) ? 1 : 0);
+							}
+						}
+					}
+				}
+			}
+		}
+	};
+}
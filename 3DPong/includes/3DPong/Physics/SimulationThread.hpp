@@ -0,0 +1,258 @@
+#pragma once
+
+//defines running the physics on its own thread at the fixed time step
+//each step's positions are published in a snapshot through a triple buffer, the render thread interpolates the last two steps so a slow frame never holds up the simulation
+
+#include <3DPong/Physics/PongPhysics.hpp>
+#include <3DPong/Network/RollbackSession.hpp>
+#include <3DPong/Input/InputState.hpp>
+#include <3DPong/Threading/TripleBuffer.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <fmt/color.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace Pong3D::Physics
+{
+	//defines the positions of the moved entities at the last two steps, once published it is never written until the reader hands it back
+	struct SimulationSnapshot
+	{
+		uint64_t stepNumber = 0; //how many steps had run, 0 is a empty snapshot
+		std::chrono::steady_clock::time_point stepTime; //when the last step was due, the alpha is worked out from it
+		float fixedDeltaTime = 1.0f / 60.0f;
+
+		//the entities the physics moves, the balls then the paddles
+		std::vector<uint64_t> entityIDs;
+		std::vector<glm::vec3> previousPositions, positions;
+
+		size_t ballCount = 0;
+		PhysicsStepStats stats; //the stats of the last step
+		Network::RollbackStats rollbackStats; //the netplay session's stats, if there is one
+		uint64_t appliedInputEvents = 0; //how many of the sampled input events the ticks have applied
+
+		//gets how far the render time is between the previous and the last step, 0 to 1
+		inline float GetAlpha(std::chrono::steady_clock::time_point now) const
+		{
+			const float alpha = std::chrono::duration<float>(now - stepTime).count() / fixedDeltaTime;
+			return (alpha < 0.0f ? 0.0f : alpha > 1.0f ? 1.0f : alpha);
+		}
+	};
+
+	//defines the create info for the simulation thread
+	struct SimulationThread_CreateInfo
+	{
+		float fixedDeltaTime = 1.0f / 60.0f;
+		float paddleSpeed = 10.0f; //the paddles move up and down at this speed while their input is held
+		uint32_t maxStepsPerFrame = 5; //steps past this are dropped after a long stall so it doesn't spiral
+
+		//a networked game, optional. The session steps the world with the local paddle's input and the remote peer's
+		Network::RollbackSession* rollbackSession = nullptr;
+
+		//the sampled input, optional. Each tick applies the events that happened by the time it was due and sets the bound paddles' directions
+		Input::InputQueue* inputQueue = nullptr;
+		std::vector<Input::PaddleBinding> inputBindings;
+	};
+
+	//defines the simulation thread, it owns the physics world from Start until Stop
+	struct SimulationThread
+	{
+		PhysicsWorld* world = nullptr;
+		float fixedDeltaTime = 1.0f / 60.0f;
+		float paddleSpeed = 10.0f;
+		uint32_t maxStepsPerFrame = 5;
+		Network::RollbackSession* rollbackSession = nullptr;
+
+		//the input from the main thread, a direction for each paddle. Written whenever, read at the start of each step
+		std::unique_ptr<std::atomic<float>[]> paddleDirections;
+		size_t paddleCount = 0;
+
+		Input::InputTickMapper inputMapper; //only the simulation thread touches it once started
+
+		Threading::TripleBuffer<SimulationSnapshot> snapshots;
+
+		std::thread thread;
+		std::atomic<bool> isRunning{ false };
+		std::atomic<uint64_t> droppedSteps{ 0 };
+
+		//starts the thread, the world must not be touched by any other thread until Stop
+		inline bool Start(PhysicsWorld* _world, const SimulationThread_CreateInfo& info = SimulationThread_CreateInfo())
+		{
+			if (isRunning)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE PHYSICS WARNING: SimulationThread || Start || The simulation thread is already running!\n");
+				return true;
+			}
+
+			if (!_world || info.fixedDeltaTime <= 0.0f)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PHYSICS ERROR: SimulationThread || Start || A physics world and a fixed time step above 0 are needed!\n");
+				return false;
+			}
+
+			world = _world;
+			fixedDeltaTime = info.fixedDeltaTime;
+			paddleSpeed = info.paddleSpeed;
+			maxStepsPerFrame = (info.maxStepsPerFrame > 0 ? info.maxStepsPerFrame : 1);
+			rollbackSession = info.rollbackSession;
+
+			paddleCount = world->paddles.Size();
+			if (rollbackSession && rollbackSession->localPlayer >= paddleCount)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PHYSICS ERROR: SimulationThread || Start || The rollback session's local player has no paddle!\n");
+				return false;
+			}
+			if (rollbackSession)
+				rollbackSession->ReserveStates(*world);
+
+			for (size_t i = 0; i < info.inputBindings.size(); ++i)
+			{
+				if (info.inputBindings[i].paddleIndex >= paddleCount)
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PHYSICS ERROR: SimulationThread || Start || Input binding {} moves paddle {} which doesn't exist!\n",
+						i, info.inputBindings[i].paddleIndex);
+					return false;
+				}
+			}
+			inputMapper.queue = info.inputQueue;
+			inputMapper.bindings = info.inputBindings;
+
+			paddleDirections = std::make_unique<std::atomic<float>[]>(paddleCount);
+			for (size_t i = 0; i < paddleCount; ++i)
+				paddleDirections[i].store(0.0f, std::memory_order_relaxed);
+
+			//sizes every buffer up front so the steps don't allocate
+			const size_t entityCount = world->balls.Size() + world->paddles.Size();
+			for (size_t i = 0; i < 3; ++i)
+			{
+				snapshots.buffers[i].entityIDs.reserve(entityCount);
+				snapshots.buffers[i].previousPositions.reserve(entityCount);
+				snapshots.buffers[i].positions.reserve(entityCount);
+			}
+
+			isRunning = true;
+			thread = std::thread(&SimulationThread::Loop, this);
+			return true;
+		}
+
+		//stops the thread, the world belongs to the caller again afterwards
+		inline void Stop()
+		{
+			if (!isRunning)
+				return;
+
+			isRunning = false;
+			thread.join();
+		}
+
+		//sets a paddle's input, -1 down, 1 up, 0 stopped. Safe from any thread, a paddle with a input binding is overwritten each tick
+		inline void SetPaddleDirection(size_t paddleIndex, float direction)
+		{
+			if (paddleIndex < paddleCount)
+				paddleDirections[paddleIndex].store(direction, std::memory_order_relaxed);
+		}
+
+		//applies the input that happened by a tick's time to the bound paddles
+		inline void ApplyInput(std::chrono::steady_clock::time_point tickTime)
+		{
+			inputMapper.ConsumeUntil(tickTime);
+			for (size_t i = 0; i < inputMapper.bindings.size(); ++i)
+			{
+				const Input::PaddleBinding& binding = inputMapper.bindings[i];
+				paddleDirections[binding.paddleIndex].store(binding.GetDirection(inputMapper.state), std::memory_order_relaxed);
+			}
+		}
+
+		//writes the world's positions into a snapshot
+		inline void WritePositions(std::vector<glm::vec3>& positions) const
+		{
+			positions.resize(world->balls.Size() + world->paddles.Size());
+
+			size_t w = 0;
+			for (size_t i = 0; i < world->balls.Size(); ++i)
+				positions[w++] = glm::vec3(world->balls.x[i], world->balls.y[i], world->balls.z[i]);
+			for (size_t i = 0; i < world->paddles.Size(); ++i)
+				positions[w++] = glm::vec3(world->paddles.x[i], world->paddles.y[i], world->paddles.z[i]);
+		}
+
+		//steps the world at the fixed time step and publishes a snapshot after the steps of each wake up
+		inline void Loop()
+		{
+			PONG3D_PROFILE_THREAD("Simulation");
+
+			using Clock = std::chrono::steady_clock;
+			const Clock::duration stepDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(fixedDeltaTime));
+			uint64_t stepNumber = 0;
+			Clock::time_point nextStepTime = Clock::now();
+
+			while (isRunning.load(std::memory_order_relaxed))
+			{
+				//waits for the next step, sleeps while it's far off and spins the last bit so the step isn't late
+				const Clock::time_point now = Clock::now();
+				if (now < nextStepTime)
+				{
+					if (nextStepTime - now > std::chrono::milliseconds(2))
+						std::this_thread::sleep_for(nextStepTime - now - std::chrono::milliseconds(1));
+					else
+						std::this_thread::yield();
+					continue;
+				}
+
+				SimulationSnapshot& snapshot = snapshots.GetWriteBuffer();
+				uint32_t stepCount = 0;
+				while (nextStepTime <= Clock::now())
+				{
+					//a long stall would take more steps than can be caught up on, the time is dropped instead
+					if (stepCount == maxStepsPerFrame)
+					{
+						const uint64_t dropped = (uint64_t)((Clock::now() - nextStepTime) / stepDuration) + 1;
+						droppedSteps.fetch_add(dropped, std::memory_order_relaxed);
+						nextStepTime += stepDuration * dropped;
+						break;
+					}
+
+					PONG3D_PROFILE_ZONE("Simulation Step");
+
+					//only the step before the last one is kept for the interpolation
+					WritePositions(snapshot.previousPositions);
+
+					//the tick's input is what had happened by the time it was due, not when it ran
+					if (inputMapper.queue)
+						ApplyInput(nextStepTime);
+
+					//a networked game only moves the local paddle, the session steps the world and rolls it back when the remote input comes in
+					//the tick is lost while it waits on the remote peer
+					if (rollbackSession)
+						rollbackSession->AdvanceTick(*world, paddleDirections[rollbackSession->localPlayer].load(std::memory_order_relaxed));
+					else
+					{
+						for (size_t i = 0; i < paddleCount; ++i)
+							world->paddles.SetVelocity(i, glm::vec3(0.0f, paddleDirections[i].load(std::memory_order_relaxed) * paddleSpeed, 0.0f));
+						world->Step(fixedDeltaTime);
+					}
+
+					stepNumber++;
+					stepCount++;
+					nextStepTime += stepDuration;
+				}
+
+				//publishes the steps
+				snapshot.stepNumber = stepNumber;
+				snapshot.stepTime = nextStepTime - stepDuration;
+				snapshot.fixedDeltaTime = fixedDeltaTime;
+				snapshot.ballCount = world->balls.Size();
+				snapshot.stats = world->stats;
+				snapshot.appliedInputEvents = inputMapper.appliedEvents;
+				if (rollbackSession)
+					snapshot.rollbackStats = rollbackSession->stats;
+				snapshot.entityIDs.assign(world->balls.entityIDs.begin(), world->balls.entityIDs.end());
+				snapshot.entityIDs.insert(snapshot.entityIDs.end(), world->paddles.entityIDs.begin(), world->paddles.entityIDs.end());
+				WritePositions(snapshot.positions);
+				snapshots.Publish();
+			}
+		}
+	};
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+//defines running the renderer without a display, a device made without a surface and offscreen images standing in for the swapchain
+//used for benchmarking and CI, it runs on software Vulkan drivers like lavapipe
+
+#include <BTDSTD/Wireframe/Core/GPU.hpp>
+
+#include <VkBootstrap.h>
+#include <vk_mem_alloc.h>
+
+#include <vector>
+
+namespace Pong3D::Platform
+{
+	//defines the settings of a headless device
+	struct HeadlessDevice_CreateInfo
+	{
+		bool isDebug = false;
+		bool preferSoftwareDevice = false; //picks a CPU device (lavapipe, SwiftShader) over any real GPU
+
+		uint32_t vulkanMajorVersion = 1, vulkanMinorVersion = 3; //the same as the windowed device
+		VkPhysicalDeviceVulkan12Features features12 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+	};
+
+	//defines a headless device, fills in a GPU the rest of the engine uses like one made for a window
+	struct HeadlessDevice
+	{
+		vkb::Instance instance;
+		vkb::Device device;
+		bool isCreated = false;
+
+		//creates the device and fills in the GPU
+		inline bool Create(const HeadlessDevice_CreateInfo& info, Wireframe::Device::GPU* GPU)
+		{
+			vkb::InstanceBuilder instanceBuilder;
+			instanceBuilder.set_app_name("3DPong Headless").set_headless(true)
+				.require_api_version(info.vulkanMajorVersion, info.vulkanMinorVersion, 0);
+			if (info.isDebug)
+				instanceBuilder.request_validation_layers(true).use_default_debug_messenger();
+
+			auto instanceResult = instanceBuilder.build();
+			if (!instanceResult)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Headless Device || Create || Failed to create a instance: {}\n", instanceResult.error().message());
+				return false;
+			}
+			instance = instanceResult.value();
+
+			vkb::PhysicalDeviceSelector selector(instance);
+			selector.set_minimum_version(info.vulkanMajorVersion, info.vulkanMinorVersion)
+				.set_required_features_12(info.features12)
+				.allow_any_gpu_device_type(true);
+			if (info.preferSoftwareDevice)
+				selector.prefer_gpu_device_type(vkb::PreferredDeviceType::cpu);
+
+			auto physicalDeviceResult = selector.select();
+			if (!physicalDeviceResult)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Headless Device || Create || No device supports the engine: {}\n", physicalDeviceResult.error().message());
+				vkb::destroy_instance(instance);
+				return false;
+			}
+
+			vkb::DeviceBuilder deviceBuilder(physicalDeviceResult.value());
+			auto deviceResult = deviceBuilder.build();
+			if (!deviceResult)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Headless Device || Create || Failed to create the device: {}\n", deviceResult.error().message());
+				vkb::destroy_instance(instance);
+				return false;
+			}
+			device = deviceResult.value();
+
+			GPU->instance = instance.instance;
+			GPU->chosenGPU = device.physical_device.physical_device;
+			GPU->device = device.device;
+			GPU->graphicsQueue = device.get_queue(vkb::QueueType::graphics).value();
+			GPU->graphicsQueueFamily = device.get_queue_index(vkb::QueueType::graphics).value();
+
+#ifdef VOLK_H_
+			volkLoadInstance(GPU->instance);
+			volkLoadDevice(GPU->device);
+#endif
+
+			fmt::print("Headless device: {}\n", device.physical_device.properties.deviceName);
+			isCreated = true;
+			return true;
+		}
+
+		//destroys the device, the GPU it filled in is invalid after
+		inline void Destroy()
+		{
+			if (!isCreated)
+				return;
+
+			vkb::destroy_device(device);
+			vkb::destroy_instance(instance);
+			isCreated = false;
+		}
+	};
+
+	//defines a offscreen image with its memory and view
+	struct OffscreenImage
+	{
+		VkImage image = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+	};
+
+	//defines the offscreen images a headless renderer draws into in place of a swapchain
+	struct OffscreenSwapchain
+	{
+		VkFormat _swapchainImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+		VkFormat _depthFormat = VK_FORMAT_D32_SFLOAT;
+		VkExtent2D extent = { 0, 0 };
+
+		std::vector<OffscreenImage> colorImages;
+		std::vector<VkImageView> colorImageViews; //the views of the color images, laid out like a swapchain's for the framebuffers
+		OffscreenImage depthImage;
+
+		//creates a image and its view
+		static inline bool CreateImage(Wireframe::Device::GPU* GPU, VmaAllocator allocator, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect,
+			VkExtent2D extent, OffscreenImage& image)
+		{
+			VkImageCreateInfo imageInfo = {};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = format;
+			imageInfo.extent = { extent.width, extent.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = usage;
+
+			VmaAllocationCreateInfo allocInfo = {};
+			allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+			if (vmaCreateImage(allocator, &imageInfo, &allocInfo, &image.image, &image.allocation, nullptr) != VK_SUCCESS)
+				return false;
+
+			VkImageViewCreateInfo viewInfo = {};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = image.image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = format;
+			viewInfo.subresourceRange.aspectMask = aspect;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.layerCount = 1;
+			return vkCreateImageView(GPU->device, &viewInfo, nullptr, &image.view) == VK_SUCCESS;
+		}
+
+		//destroys a image and its view
+		static inline void DestroyImage(Wireframe::Device::GPU* GPU, VmaAllocator allocator, OffscreenImage& image)
+		{
+			if (image.view != VK_NULL_HANDLE)
+				vkDestroyImageView(GPU->device, image.view, nullptr);
+			if (image.image != VK_NULL_HANDLE)
+				vmaDestroyImage(allocator, image.image, image.allocation);
+			image = OffscreenImage();
+		}
+
+		//creates the images, a frame renders into the image after the last one so it works like a swapchain with that many images
+		inline bool Create(Wireframe::Device::GPU* GPU, VmaAllocator allocator, VkExtent2D _extent, uint32_t imageCount = 3)
+		{
+			extent = _extent;
+			colorImages.resize(imageCount);
+			colorImageViews.resize(imageCount);
+			for (uint32_t i = 0; i < imageCount; ++i)
+			{
+				if (!CreateImage(GPU, allocator, _swapchainImageFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+					VK_IMAGE_ASPECT_COLOR_BIT, extent, colorImages[i]))
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Offscreen Swapchain || Create || Failed to create a {}x{} color image!\n", extent.width, extent.height);
+					Destroy(GPU, allocator);
+					return false;
+				}
+				colorImageViews[i] = colorImages[i].view;
+			}
+
+			if (!CreateImage(GPU, allocator, _depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, extent, depthImage))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Offscreen Swapchain || Create || Failed to create a {}x{} depth image!\n", extent.width, extent.height);
+				Destroy(GPU, allocator);
+				return false;
+			}
+
+			return true;
+		}
+
+		//destroys the images
+		inline void Destroy(Wireframe::Device::GPU* GPU, VmaAllocator allocator)
+		{
+			for (size_t i = 0; i < colorImages.size(); ++i)
+				DestroyImage(GPU, allocator, colorImages[i]);
+			colorImages.clear();
+			colorImageViews.clear();
+			DestroyImage(GPU, allocator, depthImage);
+		}
+	};
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+//defines a read only memory mapped file, the OS pages it in as it's read so nothing is copied
+
+#include <fmt/color.h>
+
+#include <cstdint>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Pong3D::Platform
+{
+	//defines a mapped file
+	struct MappedFile
+	{
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+
+#if defined(_WIN32)
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mappingHandle = NULL;
+#else
+		int fileDescriptor = -1;
+#endif
+
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { Close(); }
+
+		//is the file mapped
+		inline bool IsOpen() const { return data != nullptr; }
+
+		//maps a file
+		inline bool Open(const std::string& filepath)
+		{
+			Close();
+
+#if defined(_WIN32)
+			fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Mapped File || Open || Failed to open \"{}\"!\n", filepath);
+				return false;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Mapped File || Open || \"{}\" is empty!\n", filepath);
+				Close();
+				return false;
+			}
+			size = (size_t)fileSize.QuadPart;
+
+			mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mappingHandle == NULL)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Mapped File || Open || Failed to map \"{}\"!\n", filepath);
+				Close();
+				return false;
+			}
+
+			data = (const uint8_t*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+			fileDescriptor = open(filepath.c_str(), O_RDONLY);
+			if (fileDescriptor < 0)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Mapped File || Open || Failed to open \"{}\"!\n", filepath);
+				return false;
+			}
+
+			struct stat fileStats;
+			if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Mapped File || Open || \"{}\" is empty!\n", filepath);
+				Close();
+				return false;
+			}
+			size = (size_t)fileStats.st_size;
+
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+			data = (mapping == MAP_FAILED ? nullptr : (const uint8_t*)mapping);
+			if (data)
+				madvise(mapping, size, MADV_SEQUENTIAL);
+#endif
+
+			if (!data)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Mapped File || Open || Failed to map \"{}\"!\n", filepath);
+				Close();
+				return false;
+			}
+
+			return true;
+		}
+
+		//unmaps the file
+		inline void Close()
+		{
+#if defined(_WIN32)
+			if (data)
+				UnmapViewOfFile(data);
+			if (mappingHandle != NULL)
+				CloseHandle(mappingHandle);
+			if (fileHandle != INVALID_HANDLE_VALUE)
+				CloseHandle(fileHandle);
+			mappingHandle = NULL;
+			fileHandle = INVALID_HANDLE_VALUE;
+#else
+			if (data)
+				munmap((void*)data, size);
+			if (fileDescriptor >= 0)
+				close(fileDescriptor);
+			fileDescriptor = -1;
+#endif
+
+			data = nullptr;
+			size = 0;
+		}
+	};
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+//defines the swapchain a window presents through, with a selectable present mode and recreation when the window changes size
+//recreating hands the old swapchain to the new one so the driver can reuse its images, and the depth image is only remade when it has to grow
+
+#include <3DPong/Platform/Headless.hpp>
+
+#include <VkBootstrap.h>
+#include <vk_mem_alloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace Pong3D::Platform
+{
+	//defines how the swapchain paces the frames it presents
+	enum class PresentMode : uint8_t
+	{
+		Fifo = 0, //waits for vblank, no tearing. Always supported, it's the fallback for the rest
+		FifoRelaxed, //waits for vblank unless the frame is late, then it tears instead of waiting a whole refresh
+		Mailbox, //never waits, the newest frame replaces the queued one at vblank. No tearing and the lowest latency without it
+		Immediate, //never waits and presents right away, tears
+
+		Count
+	};
+
+	//gets the name of a present mode
+	inline const char* PresentMode_GetName(PresentMode mode)
+	{
+		switch (mode)
+		{
+		case PresentMode::Fifo: return "FIFO";
+		case PresentMode::FifoRelaxed: return "FIFO Relaxed";
+		case PresentMode::Mailbox: return "Mailbox";
+		case PresentMode::Immediate: return "Immediate";
+		default: return "Unknown";
+		}
+	}
+
+	//gets the Vulkan present mode
+	inline VkPresentModeKHR PresentMode_ToVulkan(PresentMode mode)
+	{
+		switch (mode)
+		{
+		case PresentMode::FifoRelaxed: return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+		case PresentMode::Mailbox: return VK_PRESENT_MODE_MAILBOX_KHR;
+		case PresentMode::Immediate: return VK_PRESENT_MODE_IMMEDIATE_KHR;
+		default: return VK_PRESENT_MODE_FIFO_KHR;
+		}
+	}
+
+	//gets the present mode from the Vulkan one, anything else is FIFO
+	inline PresentMode PresentMode_FromVulkan(VkPresentModeKHR mode)
+	{
+		switch (mode)
+		{
+		case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return PresentMode::FifoRelaxed;
+		case VK_PRESENT_MODE_MAILBOX_KHR: return PresentMode::Mailbox;
+		case VK_PRESENT_MODE_IMMEDIATE_KHR: return PresentMode::Immediate;
+		default: return PresentMode::Fifo;
+		}
+	}
+
+	//defines the settings of the window swapchain
+	struct WindowSwapchain_CreateInfo
+	{
+		PresentMode presentMode = PresentMode::Fifo; //falls back to FIFO if the surface doesn't support it
+		uint32_t imageCount = 0; //0 takes one more than the surface's minimum, mailbox wants at least 3
+	};
+
+	//defines the stats of the window swapchain
+	struct WindowSwapchainStats
+	{
+		uint64_t recreations = 0;
+		uint64_t depthImageReuses = 0; //recreations that kept the depth image since it was already big enough
+		float lastRecreateMS = 0.0f;
+	};
+
+	//defines the window swapchain
+	struct WindowSwapchain
+	{
+		vkb::Swapchain swapchain;
+		VkSwapchainKHR _swapchain = VK_NULL_HANDLE;
+		VkFormat _swapchainImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+		VkExtent2D extent = { 0, 0 };
+
+		std::vector<VkImage> _swapchainImages;
+		std::vector<VkImageView> _swapchainImageViews;
+
+		//the depth image can be bigger than the swapchain, a framebuffer's attachments only have to cover it
+		VkFormat _depthFormat = VK_FORMAT_D32_SFLOAT;
+		OffscreenImage depthImage;
+		VkExtent2D depthExtent = { 0, 0 };
+
+		VkSurfaceKHR surface = VK_NULL_HANDLE;
+		WindowSwapchain_CreateInfo settings;
+		PresentMode presentMode = PresentMode::Fifo; //the mode it got, the requested one may have fallen back to FIFO
+
+		WindowSwapchainStats stats;
+		bool isCreated = false;
+
+		//builds the swapchain, the old one is handed over and destroyed after
+		inline bool Build(Wireframe::Device::GPU* GPU, VmaAllocator allocator, VkExtent2D desiredExtent)
+		{
+			vkb::SwapchainBuilder builder(GPU->chosenGPU, GPU->device, surface);
+			builder.use_default_format_selection()
+				.set_desired_present_mode(PresentMode_ToVulkan(settings.presentMode))
+				.add_fallback_present_mode(VK_PRESENT_MODE_FIFO_KHR)
+				.set_desired_extent(desiredExtent.width, desiredExtent.height)
+				.set_old_swapchain(swapchain);
+			if (settings.imageCount > 0)
+				builder.set_desired_min_image_count(settings.imageCount);
+
+			auto swapchainResult = builder.build();
+			if (!swapchainResult)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Window Swapchain || Build || Failed to build a {}x{} swapchain: {}\n",
+					desiredExtent.width, desiredExtent.height, swapchainResult.error().message());
+				return false;
+			}
+
+			//the old swapchain is retired once the new one exists, its images are either reused by the driver or freed
+			DestroySwapchain();
+			swapchain = swapchainResult.value();
+			_swapchain = swapchain.swapchain;
+			_swapchainImageFormat = swapchain.image_format;
+			extent = swapchain.extent;
+			presentMode = PresentMode_FromVulkan(swapchain.present_mode);
+			_swapchainImages = swapchain.get_images().value();
+			_swapchainImageViews = swapchain.get_image_views().value();
+
+			if (settings.presentMode != presentMode)
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE PLATFORM WARNING: Window Swapchain || Build || {} isn't supported, presenting with {}.\n",
+					PresentMode_GetName(settings.presentMode), PresentMode_GetName(presentMode));
+
+			//a smaller window keeps the depth image it has
+			if (depthImage.image != VK_NULL_HANDLE && extent.width <= depthExtent.width && extent.height <= depthExtent.height)
+			{
+				stats.depthImageReuses++;
+				return true;
+			}
+
+			OffscreenSwapchain::DestroyImage(GPU, allocator, depthImage);
+			const VkExtent2D newDepthExtent = { std::max(extent.width, depthExtent.width), std::max(extent.height, depthExtent.height) };
+			if (!OffscreenSwapchain::CreateImage(GPU, allocator, _depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT,
+				newDepthExtent, depthImage))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PLATFORM ERROR: Window Swapchain || Build || Failed to create a {}x{} depth image!\n",
+					newDepthExtent.width, newDepthExtent.height);
+				return false;
+			}
+			depthExtent = newDepthExtent;
+
+			return true;
+		}
+
+		//destroys the swapchain and its views, the depth image is kept
+		inline void DestroySwapchain()
+		{
+			if (swapchain.swapchain == VK_NULL_HANDLE)
+				return;
+
+			swapchain.destroy_image_views(_swapchainImageViews);
+			vkb::destroy_swapchain(swapchain);
+			swapchain = vkb::Swapchain();
+			_swapchain = VK_NULL_HANDLE;
+			_swapchainImages.clear();
+			_swapchainImageViews.clear();
+		}
+
+		//creates the swapchain for a window's surface
+		inline bool Create(const WindowSwapchain_CreateInfo& info, Wireframe::Device::GPU* GPU, VkSurfaceKHR _surface, VmaAllocator allocator, VkExtent2D windowExtent)
+		{
+			if (isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE PLATFORM WARNING: Window Swapchain || Create || The swapchain is already created!\n");
+				return true;
+			}
+
+			surface = _surface;
+			settings = info;
+			if (!Build(GPU, allocator, windowExtent))
+			{
+				Destroy(GPU, allocator);
+				return false;
+			}
+
+			isCreated = true;
+			return true;
+		}
+
+		//recreates the swapchain at the window's new size or with new settings, the GPU must be done with the old one
+		inline bool Recreate(const WindowSwapchain_CreateInfo& info, Wireframe::Device::GPU* GPU, VmaAllocator allocator, VkExtent2D windowExtent)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			settings = info;
+			if (!Build(GPU, allocator, windowExtent))
+				return false;
+
+			stats.recreations++;
+			stats.lastRecreateMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			return true;
+		}
+
+		//gets the size of the surface, 0 by 0 while the window is minimized
+		inline VkExtent2D GetSurfaceExtent(Wireframe::Device::GPU* GPU, VkExtent2D windowExtent) const
+		{
+			VkSurfaceCapabilitiesKHR capabilities = {};
+			if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(GPU->chosenGPU, surface, &capabilities) != VK_SUCCESS)
+				return windowExtent;
+
+			//some platforms let the swapchain pick the size, the window's is used then
+			if (capabilities.currentExtent.width == UINT32_MAX)
+				return windowExtent;
+			return capabilities.currentExtent;
+		}
+
+		//destroys the swapchain and the depth image
+		inline void Destroy(Wireframe::Device::GPU* GPU, VmaAllocator allocator)
+		{
+			DestroySwapchain();
+			OffscreenSwapchain::DestroyImage(GPU, allocator, depthImage);
+			depthExtent = { 0, 0 };
+			isCreated = false;
+		}
+	};
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+//defines a CPU zone profiler, a zone times the scope it's in and writes one event into its thread's ring buffer
+//writing never locks, a thread only takes the lock once to register its buffer. The events are dumped as a Chrome trace,
+//which chrome://tracing and Perfetto both open. Compiled out in Dist unless PONG3D_PROFILING_IN_DIST is defined
+
+#include <fmt/color.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PONG3D_PROFILER_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PONG3D_PROFILER_HAS_RDTSC 1
+#endif
+
+#if !defined(PONG3D_PROFILING)
+#if defined(BTD_DIST) && !defined(PONG3D_PROFILING_IN_DIST)
+#define PONG3D_PROFILING 0
+#else
+#define PONG3D_PROFILING 1
+#endif
+#endif
+
+namespace Pong3D::Profiling
+{
+	//how many events each thread keeps, the oldest are overwritten
+	static constexpr uint64_t CPU_PROFILER_EVENTS_PER_THREAD = 1 << 16;
+
+	//gets the steady clock's time in nanoseconds
+	inline uint64_t CPUProfiler_NowNS()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//gets the zone clock, the time stamp counter where there is one since it's a few times cheaper than the steady clock
+	//the ticks are turned into nanoseconds when the trace is written
+	inline uint64_t CPUProfiler_Now()
+	{
+#if defined(PONG3D_PROFILER_HAS_RDTSC)
+		return (uint64_t)__rdtsc();
+#else
+		return CPUProfiler_NowNS();
+#endif
+	}
+
+	//defines a finished zone, the name must outlive the profiler so it's always a string literal
+	struct CPUProfileEvent
+	{
+		const char* name = nullptr;
+		uint64_t start = 0, end = 0; //in zone clock ticks
+	};
+
+	//defines a slot in a thread's ring buffer, the sequence is the event's index + 1 once it's written and 0 while it's being written
+	//the ring wraps while a trace is dumped, so the reader checks the sequence before and after copying and drops the event if it moved
+	struct CPUProfileEventSlot
+	{
+		std::atomic<uint64_t> sequence{ 0 };
+		std::atomic<const char*> name{ nullptr };
+		std::atomic<uint64_t> start{ 0 }, end{ 0 };
+	};
+
+	//defines a thread's ring buffer, only the thread writes to it
+	struct CPUProfileThreadBuffer
+	{
+		std::unique_ptr<CPUProfileEventSlot[]> events;
+		std::atomic<uint64_t> head{ 0 }; //how many events have ever been written
+
+		uint32_t threadID = 0;
+		std::string threadName;
+
+		CPUProfileThreadBuffer() : events(std::make_unique<CPUProfileEventSlot[]>(CPU_PROFILER_EVENTS_PER_THREAD)) {}
+
+		//writes a event, the slot's sequence is cleared first and published after so a reader never keeps a half written event
+		//the relaxed stores are plain moves on x86 and ARM, the zone costs the same as before
+		inline void Push(const char* name, uint64_t start, uint64_t end)
+		{
+			const uint64_t index = head.load(std::memory_order_relaxed);
+			CPUProfileEventSlot* slot = &events[index & (CPU_PROFILER_EVENTS_PER_THREAD - 1)];
+			slot->sequence.store(0, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot->name.store(name, std::memory_order_relaxed);
+			slot->start.store(start, std::memory_order_relaxed);
+			slot->end.store(end, std::memory_order_relaxed);
+			slot->sequence.store(index + 1, std::memory_order_release);
+			head.store(index + 1, std::memory_order_release);
+		}
+
+		//copies the event at a index, false if it was overwritten or is being written
+		inline bool Read(uint64_t index, CPUProfileEvent& event) const
+		{
+			const CPUProfileEventSlot* slot = &events[index & (CPU_PROFILER_EVENTS_PER_THREAD - 1)];
+			if (slot->sequence.load(std::memory_order_acquire) != index + 1)
+				return false;
+
+			event.name = slot->name.load(std::memory_order_relaxed);
+			event.start = slot->start.load(std::memory_order_relaxed);
+			event.end = slot->end.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return slot->sequence.load(std::memory_order_relaxed) == index + 1;
+		}
+	};
+
+	//defines the profiler, holds every thread's buffer
+	struct CPUProfiler
+	{
+		std::mutex mutex; //only for registering threads and dumping
+		std::vector<std::unique_ptr<CPUProfileThreadBuffer>> threads; //kept after a thread exits so its events can still be dumped
+
+		//the trace's time 0 on both clocks, the ticks per nanosecond are worked out from how far both have moved since
+		uint64_t startTicks = CPUProfiler_Now();
+		uint64_t startNS = CPUProfiler_NowNS();
+		double zoneOverheadNS = 0.0; //set by CPUProfiler_MeasureZoneOverhead
+
+		//gets how many nanoseconds a zone clock tick is
+		inline double GetNSPerTick() const
+		{
+#if defined(PONG3D_PROFILER_HAS_RDTSC)
+			const uint64_t ticks = CPUProfiler_Now() - startTicks;
+			const uint64_t ns = CPUProfiler_NowNS() - startNS;
+			return (ticks > 0 && ns > 0 ? (double)ns / (double)ticks : 1.0);
+#else
+			return 1.0;
+#endif
+		}
+
+		//registers a buffer for the calling thread
+		inline CPUProfileThreadBuffer* RegisterThread()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			CPUProfileThreadBuffer* buffer = threads.emplace_back(std::make_unique<CPUProfileThreadBuffer>()).get();
+			buffer->threadID = (uint32_t)threads.size();
+			buffer->threadName = "Thread " + std::to_string(buffer->threadID);
+			return buffer;
+		}
+
+		//writes every thread's events as a Chrome trace, events written or overwritten while dumping are skipped
+		inline bool WriteChromeTrace(const std::string& filepath)
+		{
+			std::ofstream file(filepath, std::ios::trunc);
+			if (!file.is_open())
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE PROFILING ERROR: CPU Profiler || WriteChromeTrace || Failed to open \"{}\" for writing!\n", filepath);
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			const double NSPerTick = GetNSPerTick();
+			file << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"zoneOverheadNS\":" << zoneOverheadNS << "},\"traceEvents\":[\n";
+
+			bool isFirst = true;
+			size_t eventCount = 0;
+			for (size_t t = 0; t < threads.size(); ++t)
+			{
+				CPUProfileThreadBuffer* buffer = threads[t].get();
+				file << (isFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadID
+					<< ",\"args\":{\"name\":\"" << buffer->threadName << "\"}}";
+				isFirst = false;
+
+				//only the last ring's worth of events are still there
+				const uint64_t head = buffer->head.load(std::memory_order_acquire);
+				const uint64_t first = (head > CPU_PROFILER_EVENTS_PER_THREAD ? head - CPU_PROFILER_EVENTS_PER_THREAD : 0);
+				for (uint64_t i = first; i < head; ++i)
+				{
+					CPUProfileEvent event;
+					if (!buffer->Read(i, event) || !event.name || event.start < startTicks)
+						continue;
+
+					//microseconds, with the nanoseconds kept as fractions
+					file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadID
+						<< ",\"ts\":" << fmt::format("{:.3f}", (double)(event.start - startTicks) * NSPerTick / 1000.0)
+						<< ",\"dur\":" << fmt::format("{:.3f}", (double)(event.end - event.start) * NSPerTick / 1000.0) << "}";
+					eventCount++;
+				}
+			}
+
+			file << "\n]}\n";
+			fmt::print("Wrote {} CPU profiler events to \"{}\"\n", eventCount, filepath);
+			return true;
+		}
+	};
+
+	//gets the profiler
+	inline CPUProfiler& CPUProfiler_Get()
+	{
+		static CPUProfiler profiler;
+		return profiler;
+	}
+
+	//gets the calling thread's buffer slot, the measurement swaps it out
+	inline CPUProfileThreadBuffer*& CPUProfiler_ThreadBufferSlot()
+	{
+		static thread_local CPUProfileThreadBuffer* buffer = nullptr;
+		return buffer;
+	}
+
+	//gets the calling thread's buffer, registering it the first time
+	inline CPUProfileThreadBuffer* CPUProfiler_GetThreadBuffer()
+	{
+		CPUProfileThreadBuffer*& buffer = CPUProfiler_ThreadBufferSlot();
+		if (!buffer)
+			buffer = CPUProfiler_Get().RegisterThread();
+		return buffer;
+	}
+
+	//names the calling thread in the trace
+	inline void CPUProfiler_SetThreadName(const std::string& name)
+	{
+		CPUProfileThreadBuffer* buffer = CPUProfiler_GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(CPUProfiler_Get().mutex);
+		buffer->threadName = name;
+	}
+
+	//defines a zone, times from construction to destruction
+	struct CPUProfileZone
+	{
+		CPUProfileThreadBuffer* buffer; //looked up before the clock is read so the thread local isn't timed
+		const char* name;
+		uint64_t start;
+
+		explicit CPUProfileZone(const char* _name) : buffer(CPUProfiler_GetThreadBuffer()), name(_name), start(CPUProfiler_Now()) {}
+		~CPUProfileZone() { buffer->Push(name, start, CPUProfiler_Now()); }
+
+		CPUProfileZone(const CPUProfileZone&) = delete;
+		CPUProfileZone& operator=(const CPUProfileZone&) = delete;
+	};
+
+	//measures how long a empty zone costs in nanoseconds, the zones go to a scratch buffer so the trace isn't filled with them
+	inline double CPUProfiler_MeasureZoneOverhead(uint32_t iterations = 100000)
+	{
+		CPUProfileThreadBuffer*& slot = CPUProfiler_ThreadBufferSlot();
+		CPUProfileThreadBuffer* threadBuffer = slot;
+		std::unique_ptr<CPUProfileThreadBuffer> scratch = std::make_unique<CPUProfileThreadBuffer>();
+		slot = scratch.get();
+
+		const uint64_t start = CPUProfiler_NowNS();
+		for (uint32_t i = 0; i < iterations; ++i)
+		{
+			CPUProfileZone zone("Overhead");
+		}
+		const uint64_t end = CPUProfiler_NowNS();
+
+		slot = threadBuffer;
+		const double overheadNS = (double)(end - start) / (double)iterations;
+		CPUProfiler_Get().zoneOverheadNS = overheadNS;
+		return overheadNS;
+	}
+}
+
+#define PONG3D_PROFILE_CONCAT_INNER(a, b) a##b
+#define PONG3D_PROFILE_CONCAT(a, b) PONG3D_PROFILE_CONCAT_INNER(a, b)
+
+#if PONG3D_PROFILING
+//times the rest of the scope, the name has to be a string literal
+#define PONG3D_PROFILE_ZONE(name) Pong3D::Profiling::CPUProfileZone PONG3D_PROFILE_CONCAT(pong3DProfileZone, __LINE__)(name)
+//names the calling thread in the trace
+#define PONG3D_PROFILE_THREAD(name) Pong3D::Profiling::CPUProfiler_SetThreadName(name)
+//writes the trace
+#define PONG3D_PROFILE_WRITE_TRACE(filepath) Pong3D::Profiling::CPUProfiler_Get().WriteChromeTrace(filepath)
+#else
+#define PONG3D_PROFILE_ZONE(name)
+#define PONG3D_PROFILE_THREAD(name)
+#define PONG3D_PROFILE_WRITE_TRACE(filepath) ((void)(filepath), false)
+#endif
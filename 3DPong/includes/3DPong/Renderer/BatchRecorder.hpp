@@ -0,0 +1,87 @@
+#pragma once
+
+//defines the recording of render operation batches into a frame, inline or split across the render manager's workers
+
+#include <3DPong/Renderer/FrameManager.hpp>
+#include <3DPong/Renderer/MeshRenderer.hpp>
+
+namespace Pong3D::Renderer
+{
+	//defines a batch recorder
+	struct BatchRecorder
+	{
+		RecordedRenderState recordedState; //the state of the primary when recording inline
+
+		std::vector<std::string> batchScopeNames; //the GPU profiler scope of each batch
+
+		//uploads the batches' data and records their GPU culling, pass it to FrameRenderManager::StartFrame as the pre render pass
+		inline void Prepare(Frame& frame, std::deque<RenderOperationBatch>& batches, const ViewFrameConstants& view)
+		{
+			PONG3D_PROFILE_ZONE("Prepare Batches");
+
+			//uploads happen once up front, the workers only record
+			for (size_t b = 0; b < batches.size(); ++b)
+			{
+				batches[b].PrepareRender(frame.frameSlotIndex, view, frame.arena);
+				batches[b].RecordGPUCulling(frame.cmd.handle, frame.frameSlotIndex, view);
+			}
+		}
+
+		//records the prepared batches into the frame's render pass using the render manager's record mode
+		inline void Record(FrameRenderManager& renderManager, Frame& frame, std::deque<RenderOperationBatch>& batches, const ViewFrameConstants& view)
+		{
+			PONG3D_PROFILE_ZONE("Record Batches");
+			if (renderManager.recordMode != FrameRecordMode::ParallelSecondary)
+			{
+				recordedState.Reset();
+				for (size_t b = batchScopeNames.size(); b < batches.size(); ++b)
+					batchScopeNames.emplace_back("Batch " + std::to_string(b));
+
+				for (size_t b = 0; b < batches.size(); ++b)
+				{
+					const uint32_t batchScope = renderManager.gpuProfiler.BeginScope(frame.cmd.handle, batchScopeNames[b].c_str());
+					batches[b].RecordRuns(frame.cmd.handle, frame.frameSlotIndex, view, recordedState, batches[b].stats, 0, batches[b].drawRuns.size());
+					renderManager.gpuProfiler.EndScope(frame.cmd.handle, batchScope);
+				}
+				return;
+			}
+
+			//the stats each worker recorded for each batch, merged once the workers are done
+			const size_t batchCount = batches.size();
+			Memory::FrameVector<RenderOperationBatchStats> workerStats = Memory::FrameVector_Create<RenderOperationBatchStats>(frame.arena);
+			workerStats.resize((size_t)renderManager.workerPool.GetWorkerCount() * batchCount);
+
+			//each worker records an even slice of every batch's instances, a run that crosses slices is drawn in parts by each worker
+			//instancing puts a whole mesh in one run, so splitting by runs would leave a scene of one mesh to a single worker
+			//the GPU driven path's runs are indirect draws with counts only the GPU knows, those are split by runs instead
+			//the slices are executed in worker order so the sort order holds. The GPU profiler isn't thread safe, the render manager times the secondaries as a whole
+			renderManager.RecordInParallel(frame, [&](VkCommandBuffer& cmd, uint32_t workerIndex, uint32_t workerCount) {
+				RecordedRenderState workerState; //nothing carries over between secondaries, each worker binds its own state
+				for (size_t b = 0; b < batchCount; ++b)
+				{
+					RenderOperationBatch* batch = &batches[b];
+					RenderOperationBatchStats* stats = &workerStats[workerIndex * batchCount + b];
+					if (batch->IsGPUCullingEnabled())
+					{
+						const size_t runCount = batch->drawRuns.size();
+						const size_t firstRun = runCount * workerIndex / workerCount;
+						const size_t lastRun = runCount * (workerIndex + 1) / workerCount;
+						batch->RecordRuns(cmd, frame.frameSlotIndex, view, workerState, *stats, firstRun, lastRun - firstRun);
+						continue;
+					}
+
+					const uint64_t instanceCount = batch->GetDrawnInstanceCount();
+					const uint64_t firstInstance = instanceCount * workerIndex / workerCount;
+					const uint64_t lastInstance = instanceCount * (workerIndex + 1) / workerCount;
+					batch->RecordRuns(cmd, frame.frameSlotIndex, view, workerState, *stats, 0, batch->drawRuns.size(), firstInstance, lastInstance - firstInstance);
+				}
+				});
+
+			for (size_t w = 0; w < renderManager.workerPool.GetWorkerCount(); ++w)
+			{
+				for (size_t b = 0; b < batchCount; ++b)
+					batches[b].stats.AddRecordCounts(workerStats[w * batchCount + b]);
+			}
+		}
+	};
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+//defines the per view data that is the same for every draw in a frame, generated once per camera and passed to all the batches
+
+#include <BTDSTD/Wireframe/Pipeline/GraphicsPipeline.hpp>
+
+#include <Smok/Components/Camera.hpp>
+#include <Smok/Components/Transform.hpp>
+
+namespace Pong3D::Renderer
+{
+	//defines the frustum planes, each is (normal, distance) and points inside
+	enum class FrustumPlane : uint8_t
+	{
+		Left = 0,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+
+		Count
+	};
+
+	//defines the constants of a view for a frame
+	struct ViewFrameConstants
+	{
+		glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::mat4 projectionView = glm::mat4(1.0f);
+
+		glm::vec4 frustumPlanes[(size_t)FrustumPlane::Count];
+
+		VkViewport viewport = {};
+		VkRect2D scissor = {};
+
+		//generates the constants for a camera
+		inline void Generate(Smok::ECS::Comp::Transform* cameraTransform, Smok::ECS::Comp::Camera* cameraSettings)
+		{
+			cameraPosition = cameraTransform->position;
+
+			view = cameraSettings->GenerateView(cameraTransform->position);
+			projection = cameraSettings->GeneratePerspective();
+			projectionView = projection * view;
+
+			GenerateFrustumPlanes();
+
+			viewport = {};
+			viewport.width = cameraSettings->renderSize.x;
+			viewport.height = cameraSettings->renderSize.y;
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			scissor = {};
+			scissor.extent = { (uint32_t)viewport.width, (uint32_t)viewport.height };
+		}
+
+		//extracts the frustum planes from the projection view, the depth range is 0 to 1 (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+		inline void GenerateFrustumPlanes()
+		{
+			//glm is column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+			const glm::mat4& m = projectionView;
+			const glm::vec4 row0 = { m[0][0], m[1][0], m[2][0], m[3][0] };
+			const glm::vec4 row1 = { m[0][1], m[1][1], m[2][1], m[3][1] };
+			const glm::vec4 row2 = { m[0][2], m[1][2], m[2][2], m[3][2] };
+			const glm::vec4 row3 = { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+			frustumPlanes[(size_t)FrustumPlane::Left] = row3 + row0;
+			frustumPlanes[(size_t)FrustumPlane::Right] = row3 - row0;
+			frustumPlanes[(size_t)FrustumPlane::Bottom] = row3 + row1;
+			frustumPlanes[(size_t)FrustumPlane::Top] = row3 - row1;
+			frustumPlanes[(size_t)FrustumPlane::Near] = row2;
+			frustumPlanes[(size_t)FrustumPlane::Far] = row3 - row2;
+
+			//normalize so distances to the planes are in world units
+			for (size_t i = 0; i < (size_t)FrustumPlane::Count; ++i)
+			{
+				const float length = glm::length(glm::vec3(frustumPlanes[i]));
+				if (length > 0.0f)
+					frustumPlanes[i] /= length;
+			}
+		}
+	};
+
+	//defines the state already recorded into a command buffer, shared by every batch rendered into it so they don't re-record it
+	struct RecordedRenderState
+	{
+		Wireframe::Pipeline::GraphicsPipeline* pipeline = nullptr;
+
+		bool viewportIsSet = false;
+		VkViewport viewport = {};
+		VkRect2D scissor = {};
+
+		//binds a pipeline if it isn't already, returns true if it was bound
+		inline bool BindPipeline(VkCommandBuffer& cmd, Wireframe::Pipeline::GraphicsPipeline* _pipeline, const ViewFrameConstants& view)
+		{
+			if (pipeline == _pipeline)
+			{
+				SetViewportAndScissor(cmd, view, false);
+				return false;
+			}
+
+			pipeline = _pipeline;
+			pipeline->Bind(cmd);
+
+			//dynamic state from a previous pipeline isn't guaranteed to carry over
+			SetViewportAndScissor(cmd, view, true);
+			return true;
+		}
+
+		//sets the viewport and scissor if the pipeline changed or the view was resized
+		inline void SetViewportAndScissor(VkCommandBuffer& cmd, const ViewFrameConstants& view, bool pipelineChanged)
+		{
+			if (!pipeline)
+				return;
+
+			const bool resized = !viewportIsSet || viewport.width != view.viewport.width || viewport.height != view.viewport.height;
+			if (!pipelineChanged && !resized)
+				return;
+
+			viewport = view.viewport;
+			scissor = view.scissor;
+			viewportIsSet = true;
+			pipeline->SetViewport(cmd, viewport);
+			pipeline->SetScissor(cmd, scissor);
+		}
+
+		//resets the state, call when starting to record a new command buffer
+		inline void Reset() { *this = RecordedRenderState(); }
+	};
+}
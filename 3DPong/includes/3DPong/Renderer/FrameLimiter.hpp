@@ -0,0 +1,61 @@
+#pragma once
+
+//defines a frame limiter, it paces the main loop to a frame rate when the present mode doesn't (mailbox, immediate) or there's nothing to present
+//it sleeps most of the wait and spins the last of it, a sleep can overshoot by the scheduler's tick
+
+#include <chrono>
+#include <thread>
+
+namespace Pong3D::Renderer
+{
+	//how much of the wait is spun instead of slept
+	static constexpr std::chrono::microseconds FRAME_LIMITER_SPIN_TIME = std::chrono::microseconds(1500);
+
+	//defines the stats of the frame limiter
+	struct FrameLimiterStats
+	{
+		float lastWaitMS = 0.0f; //how long the last frame was held back
+		uint64_t lateFrames = 0; //frames that started more than a frame late, the pacing restarts from them
+	};
+
+	//defines the frame limiter
+	struct FrameLimiter
+	{
+		std::chrono::steady_clock::time_point nextFrameTime;
+		bool hasStarted = false;
+		FrameLimiterStats stats;
+
+		//waits until the next frame is due at a frame rate, 0 or less doesn't wait
+		inline void Wait(float maxFPS)
+		{
+			if (maxFPS <= 0.0f)
+			{
+				hasStarted = false;
+				stats.lastWaitMS = 0.0f;
+				return;
+			}
+
+			using Clock = std::chrono::steady_clock;
+			const Clock::duration frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / (double)maxFPS));
+			const Clock::time_point start = Clock::now();
+
+			//the first frame, or one that's fallen too far behind, starts the pacing over rather than rushing to catch up
+			if (!hasStarted || start - nextFrameTime > frameDuration)
+			{
+				stats.lateFrames += (hasStarted ? 1 : 0);
+				nextFrameTime = start + frameDuration;
+				hasStarted = true;
+				stats.lastWaitMS = 0.0f;
+				return;
+			}
+
+			if (nextFrameTime - start > FRAME_LIMITER_SPIN_TIME)
+				std::this_thread::sleep_for(nextFrameTime - start - FRAME_LIMITER_SPIN_TIME);
+			while (Clock::now() < nextFrameTime)
+				std::this_thread::yield();
+
+			stats.lastWaitMS = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+			nextFrameTime += frameDuration;
+		}
+	};
+}
@@ -3,6 +3,10 @@
 //defines a frame manager for rendering to the screen
 
 #include <3DPong/Engine.hpp>
+#include <3DPong/Renderer/GPUProfiler.hpp>
+#include <3DPong/Memory/FrameArena.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+#include <3DPong/Threading/WorkerPool.hpp>
 
 #include <TyGUI/WidgetRenderer.hpp>
 
@@ -10,15 +14,87 @@
 #include <BTDSTD/Wireframe/SyncObjects.hpp>
 #include <BTDSTD/Wireframe/CommandBuffer.hpp>
 
+#include <chrono>
+
 namespace Pong3D::Renderer
 {
+	//defines how the content of a frame's render pass is recorded
+	enum class FrameRecordMode : uint8_t
+	{
+		Inline = 0, //everything is recorded straight into the frame's primary command buffer
+
+		ParallelSecondary, //workers record secondary command buffers that the primary executes, TyGUI gets a secondary of its own
+
+		Count
+	};
+
 	//defines a frame
 	struct Frame
 	{
-		bool isValid = true;
+		bool isValid = true; //false when the swapchain couldn't give a image, nothing should be recorded or submitted
 
 		uint32_t swapchainImageIndex;
+		uint32_t frameSlotIndex = 0; //the frame in flight slot this frame is recording into
 		Wireframe::CommandBuffer::CommandBuffer cmd;
+
+		Memory::FrameArena* arena = nullptr; //the slot's arena, for data that only lives as long as the frame
+
+		//the GPU profiler scopes the render manager opened for the frame
+		uint32_t frameProfileScope = UINT32_MAX, renderPassProfileScope = UINT32_MAX;
+		uint32_t secondariesProfileScope = UINT32_MAX; //wraps the whole pass, timestamps can't be written in a pass that takes secondaries
+	};
+
+	//defines the data owned by a single frame in flight
+	struct FrameSlot
+	{
+		Wireframe::CommandBuffer::CommandBuffer cmd;
+
+		VkSemaphore _presentSemaphore = VK_NULL_HANDLE, _renderSemaphore = VK_NULL_HANDLE;
+		VkFence _renderFence = VK_NULL_HANDLE;
+
+		Smok::Memory::DeletionQueue deletionQueue; //objects used by this slot, flushed once its fence has signaled
+
+		Memory::FrameArena arena; //the per frame scratch data, reset once the fence has signaled
+
+		//the secondary command buffers the primary will execute, only used in FrameRecordMode::ParallelSecondary
+		Wireframe::CommandBuffer::CommandBuffer TyGUICmd;
+		Memory::FrameVector<VkCommandBuffer> secondaryCommandBuffers; //lives in the slot's arena
+	};
+
+	//defines the frame pacing stats, how long the CPU was blocked waiting on the GPU to give back a frame slot
+	struct FramePacingStats
+	{
+		float lastFenceWaitMS = 0.0f; //the last wait
+		float averageFenceWaitMS = 0.0f; //a moving average of the waits
+		float maxFenceWaitMS = 0.0f; //the longest wait since the last reset
+
+		//the time from one frame's start to the next, the CPU was busy for it minus the fence wait
+		float lastFrameMS = 0.0f;
+		float averageFrameMS = 0.0f;
+
+		uint64_t sampleCount = 0;
+
+		//adds a wait sample
+		inline void AddSample(float waitMS)
+		{
+			lastFenceWaitMS = waitMS;
+			if (waitMS > maxFenceWaitMS)
+				maxFenceWaitMS = waitMS;
+
+			//the first sample seeds the average, the rest are blended in
+			averageFenceWaitMS = (sampleCount == 0 ? waitMS : averageFenceWaitMS + (waitMS - averageFenceWaitMS) * 0.05f);
+			sampleCount++;
+		}
+
+		//adds a frame time sample
+		inline void AddFrameSample(float frameMS)
+		{
+			lastFrameMS = frameMS;
+			averageFrameMS = (averageFrameMS == 0.0f ? frameMS : averageFrameMS + (frameMS - averageFrameMS) * 0.05f);
+		}
+
+		//resets the stats
+		inline void Reset() { *this = FramePacingStats(); }
 	};
 
 	//defines a renderer frame manager
@@ -32,13 +108,37 @@ namespace Pong3D::Renderer
 		Smok::Memory::DeletionQueue renderObjectsDeleteQueue;
 		Wireframe::Renderpass::Renderpass renderpass;
 
-		VkSemaphore _presentSemaphore, _renderSemaphore;
-		VkFence _renderFence;
+		//frames in flight, the CPU records into one slot while the GPU is still executing the others
+		uint32_t framesInFlightCount = 2;
+		uint32_t currentFrameSlot = 0;
+		std::vector<FrameSlot> frameSlots;
+
+		FramePacingStats pacingStats; //how long we were blocked in vkWaitForFences
+
+		//low latency, caps how many frames the CPU can queue ahead of the GPU. 0 lets every frame in flight queue up
+		//1 waits for the last frame to finish before starting the next, so the input it samples is as fresh as it can be
+		uint32_t maxQueuedFrames = 0;
+		std::chrono::high_resolution_clock::time_point lastFrameStart;
+		bool hasStartedAFrame = false;
+
+		//GPU timing, optional. The results are read back frames in flight late
+		GPUProfiler gpuProfiler;
 
 		Wireframe::CommandBuffer::CommandPool commandPool;
 
+		//parallel recording, each worker records from its own pool since pools can't be used from several threads at once
+		FrameRecordMode recordMode = FrameRecordMode::Inline;
+		Threading::WorkerPool workerPool;
+		std::vector<Wireframe::CommandBuffer::CommandPool> workerCommandPools; //one per worker, holding a secondary for each frame slot
+		Wireframe::CommandBuffer::CommandPool TyGUICommandPool; //holds the TyGUI secondary for each frame slot
+
 		std::vector<VkFramebuffer> _framebuffers;
 
+		//the window's swapchain is recreated at the start of the next frame once it's out of date or its settings changed
+		Platform::WindowSwapchain_CreateInfo swapchainSettings;
+		bool swapchainNeedsRecreate = false;
+		uint64_t swapchainOutOfDateCount = 0; //how many acquires and presents said the swapchain no longer matched the window
+
 		//defines data for render operations
 		Wireframe::Renderpass::RenderOperation::RenderPassData renderpassData;
 
@@ -47,16 +147,83 @@ namespace Pong3D::Renderer
 		bool TyGUIWidgetsShouldRender = false;
 		TyGUI::WidgetRenderer widgetRenderer; //manages ImGUI
 
+		//generates the render pass for offscreen images, the color is left ready to be copied out instead of presented
+		inline bool GenerateRenderPass_Offscreen()
+		{
+			VkAttachmentDescription attachments[2] = {};
+			attachments[0].format = engine->GetColorFormat();
+			attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+			attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			attachments[0].finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+			attachments[1].format = engine->GetDepthFormat();
+			attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+			attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+			VkAttachmentReference colorReference = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+			VkAttachmentReference depthReference = { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+			VkSubpassDescription subpass = {};
+			subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			subpass.colorAttachmentCount = 1;
+			subpass.pColorAttachments = &colorReference;
+			subpass.pDepthStencilAttachment = &depthReference;
+
+			//the same dependencies as the windowed pass, color and depth from outside into the subpass
+			VkSubpassDependency dependencies[2] = {};
+			dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+			dependencies[0].dstSubpass = 0;
+			dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; //the last frame's writes to the image
+			dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+			dependencies[1].dstSubpass = 0;
+			dependencies[1].srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			dependencies[1].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			dependencies[1].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+			VkRenderPassCreateInfo renderpassInfo = {};
+			renderpassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+			renderpassInfo.attachmentCount = 2;
+			renderpassInfo.pAttachments = attachments;
+			renderpassInfo.subpassCount = 1;
+			renderpassInfo.pSubpasses = &subpass;
+			renderpassInfo.dependencyCount = 2;
+			renderpassInfo.pDependencies = dependencies;
+			if (vkCreateRenderPass(GPU->device, &renderpassInfo, nullptr, &renderpass._renderPass) != VK_SUCCESS)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDER MANAGER ERROR: GenerateRenderPass_Offscreen || Failed to create the offscreen render pass!\n");
+				return false;
+			}
+
+			return true;
+		}
+
 		//generates the render pass
 		inline bool GenerateRenderPass()
 		{
+			if (engine->isHeadless)
+				return GenerateRenderPass_Offscreen();
+
 			//we define an attachment description for our main color image
 			//the attachment is loaded as "clear" when renderpass start
 			//the attachment is stored when renderpass ends
 			//the attachment layout starts as "undefined", and transitions to "Present" so its possible to display it
 			//we dont care about stencil, and dont use multisampling
-			const std::vector<Wireframe::Util::Attachment::Attachment> attachments = { Wireframe::Util::Attachment::GenerateDefaultAttachment_Color(engine->swapchain._swachainImageFormat),
-			Wireframe::Util::Attachment::GenerateDefaultAttachment_DepthStencil(engine->swapchain._depthFormat) };
+			const std::vector<Wireframe::Util::Attachment::Attachment> attachments = { Wireframe::Util::Attachment::GenerateDefaultAttachment_Color(engine->GetColorFormat()),
+			Wireframe::Util::Attachment::GenerateDefaultAttachment_DepthStencil(engine->GetDepthFormat()) };
 			/*
 			0 = color attachment
 			1 = depth attachment
@@ -90,6 +257,12 @@ namespace Pong3D::Renderer
 		//initalizes TyGUI
 		inline bool TyGUI_Init(bool TyGUIShouldRender = true)
 		{
+			if (engine->isHeadless)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDER MANAGER WARNING: TyGUI || TyGUI_Init || TyGUI needs a window, it's not used when headless.\n");
+				return false;
+			}
+
 			TyGUI::WidgetRenderer_CreateInfo info;
 			info.isDynamicRender = false; //ignored for now but only supported when Wireframe is in 1.3 mode
 			if (!widgetRenderer.Init(&engine->GPU, &engine->window, renderpass._renderPass, info))
@@ -112,11 +285,20 @@ namespace Pong3D::Renderer
 		}
 
 		//inits the renderer
-		inline bool Init(Pong3D::Core::Engine* _engine)
+		inline bool Init(Pong3D::Core::Engine* _engine, uint32_t framesInFlight = 2, FrameRecordMode _recordMode = FrameRecordMode::Inline, uint32_t workerCount = 0,
+			size_t frameArenaSize = Memory::FRAME_ARENA_DEFAULT_SIZE)
 		{
 			engine = _engine;
 			GPU = &engine->GPU;
 
+			if (framesInFlight == 0)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDER MANAGER WARNING: Init || frames in flight can not be 0, using 1.\n");
+				framesInFlight = 1;
+			}
+			framesInFlightCount = framesInFlight;
+			currentFrameSlot = 0;
+
 			//create render pass
 			bool state = GenerateRenderPass();
 			if (!state)
@@ -126,8 +308,9 @@ namespace Pong3D::Renderer
 				});
 
 			//framebuffer
-			Wireframe::FrameBuffer::FrameBufferCreate(_framebuffers, engine->swapchain._swapchainImages.size(), engine->swapchain._swapchainImageViews.data(), engine->swapchain._depthImageView,
-				renderpass._renderPass, engine->window._windowExtent, GPU);
+			swapchainSettings = engine->swapchain.settings;
+			swapchainNeedsRecreate = false;
+			CreateFramebuffers();
 			renderObjectsDeleteQueue.push_function([&]() {
 				Wireframe::FrameBuffer::DestroyFrameBuffers(_framebuffers, GPU);
 				});
@@ -137,24 +320,136 @@ namespace Pong3D::Renderer
 			info.canBeReset = true; info.queueFamilyIndex = engine->GPU.graphicsQueueFamily;
 			commandPool.Create(info, GPU);
 
-			//allocate our command buffer
-			commandPool.AllocateCommandBuffers(1, VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_PRIMARY, GPU);
+			//allocate a command buffer for every frame in flight
+			commandPool.AllocateCommandBuffers(framesInFlightCount, VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_PRIMARY, GPU);
 			renderObjectsDeleteQueue.push_function([&]() {
 				commandPool.Destroy(GPU);
 				});
 
-			Wireframe::SyncObjects::Fence_Create(_renderFence, GPU);
-			Wireframe::SyncObjects::Semaphore_Create(_presentSemaphore, GPU);
-			Wireframe::SyncObjects::Semaphore_Create(_renderSemaphore, GPU);
+			//creates the frame slots
+			frameSlots.resize(framesInFlightCount);
+			for (uint32_t i = 0; i < framesInFlightCount; ++i)
+			{
+				FrameSlot* slot = &frameSlots[i];
+				slot->cmd = commandPool.commandBuffers[i];
+
+				Wireframe::SyncObjects::Fence_Create(slot->_renderFence, GPU);
+				Wireframe::SyncObjects::Semaphore_Create(slot->_presentSemaphore, GPU);
+				Wireframe::SyncObjects::Semaphore_Create(slot->_renderSemaphore, GPU);
+				if (!slot->arena.Create(frameArenaSize))
+					state = false; //the frame would allocate from a arena that isn't there
+			}
 			renderObjectsDeleteQueue.push_function([&]() {
-				Wireframe::SyncObjects::Semaphore_Destroy(_renderSemaphore, GPU);
-				Wireframe::SyncObjects::Semaphore_Destroy(_presentSemaphore, GPU);
-				Wireframe::SyncObjects::Fence_Destroy(_renderFence, GPU);
+				for (size_t i = 0; i < frameSlots.size(); ++i)
+				{
+					frameSlots[i].deletionQueue.flush();
+					Wireframe::SyncObjects::Semaphore_Destroy(frameSlots[i]._renderSemaphore, GPU);
+					Wireframe::SyncObjects::Semaphore_Destroy(frameSlots[i]._presentSemaphore, GPU);
+					Wireframe::SyncObjects::Fence_Destroy(frameSlots[i]._renderFence, GPU);
+					frameSlots[i].arena.Destroy();
+				}
+				frameSlots.clear();
 				});
 
+			//creates the workers and their pools for parallel recording
+			recordMode = _recordMode;
+			if (recordMode == FrameRecordMode::ParallelSecondary)
+			{
+				workerPool.Init(workerCount);
+				renderObjectsDeleteQueue.push_function([&]() {
+					workerPool.Shutdown();
+					});
+
+				workerCommandPools.resize(workerPool.GetWorkerCount());
+				for (size_t i = 0; i < workerCommandPools.size(); ++i)
+				{
+					workerCommandPools[i].Create(info, GPU);
+					workerCommandPools[i].AllocateCommandBuffers(framesInFlightCount, VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_SECONDARY, GPU);
+				}
+
+				TyGUICommandPool.Create(info, GPU);
+				TyGUICommandPool.AllocateCommandBuffers(framesInFlightCount, VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_SECONDARY, GPU);
+				for (uint32_t i = 0; i < framesInFlightCount; ++i)
+					frameSlots[i].TyGUICmd = TyGUICommandPool.commandBuffers[i];
+
+				renderObjectsDeleteQueue.push_function([&]() {
+					TyGUICommandPool.Destroy(GPU);
+					for (size_t i = 0; i < workerCommandPools.size(); ++i)
+						workerCommandPools[i].Destroy(GPU);
+					workerCommandPools.clear();
+					});
+			}
+
 			return state;
 		}
 
+		//creates a framebuffer for each image frames are rendered into
+		inline void CreateFramebuffers()
+		{
+			Wireframe::FrameBuffer::FrameBufferCreate(_framebuffers, engine->GetColorImageCount(), engine->GetColorImageViews(), engine->GetDepthImageView(),
+				renderpass._renderPass, engine->GetRenderExtent(), GPU);
+		}
+
+		//recreates the swapchain and the framebuffers on it, the frame slots, command buffers and render pass are kept
+		//returns false while the window is minimized, it's tried again next frame
+		inline bool RecreateSwapchain()
+		{
+			if (engine->isHeadless)
+			{
+				swapchainNeedsRecreate = false;
+				return false;
+			}
+
+			PONG3D_PROFILE_ZONE("Recreate Swapchain");
+
+			//every frame in flight may still be drawing into the old images
+			VK_CHECK(vkDeviceWaitIdle(GPU->device));
+			if (!engine->RecreateSwapchain(swapchainSettings))
+				return false;
+
+			//the surface's format doesn't change, so the render pass and the pipelines made against it still fit
+			Wireframe::FrameBuffer::DestroyFrameBuffers(_framebuffers, GPU);
+			_framebuffers.clear();
+			CreateFramebuffers();
+
+			swapchainNeedsRecreate = false;
+			return true;
+		}
+
+		//recreates the swapchain at the start of the next frame, for when the window is resized or restored
+		//not every platform reports a stale swapchain through the acquire or present
+		inline void RequestSwapchainRecreate() { swapchainNeedsRecreate = !engine->isHeadless; }
+
+		//changes how the swapchain presents, it's recreated at the start of the next frame
+		inline void SetPresentMode(Platform::PresentMode presentMode, uint32_t imageCount = 0)
+		{
+			if (swapchainSettings.presentMode == presentMode && swapchainSettings.imageCount == imageCount)
+				return;
+
+			swapchainSettings.presentMode = presentMode;
+			swapchainSettings.imageCount = imageCount;
+			RequestSwapchainRecreate();
+		}
+
+		//sets how many frames the CPU can queue ahead of the GPU, 0 or anything past the frames in flight lets all of them queue
+		inline void SetMaxQueuedFrames(uint32_t maxFrames) { maxQueuedFrames = (maxFrames < framesInFlightCount ? maxFrames : 0); }
+
+		//enables the GPU profiler, pipeline statistics need the pipelineStatisticsQuery device feature
+		//statistics are only collected when recording inline since the secondaries would need to inherit the query
+		inline bool EnableGPUProfiling(uint32_t maxScopes = 32, bool collectPipelineStatistics = false)
+		{
+			if (gpuProfiler.isCreated)
+				return true;
+
+			if (!gpuProfiler.Create(GPU, framesInFlightCount, maxScopes, collectPipelineStatistics && recordMode == FrameRecordMode::Inline))
+				return false;
+
+			renderObjectsDeleteQueue.push_function([&]() {
+				gpuProfiler.Destroy();
+				});
+			return true;
+		}
+
 		//destroys the renderer
 		inline void Shutdown()
 		{
@@ -164,48 +459,215 @@ namespace Pong3D::Renderer
 			renderObjectsDeleteQueue.flush();
 		}
 
-		//starts frame
-		inline Frame StartFrame()
+		//starts frame, the pre render pass callback records work that has to happen outside of the render pass (compute, copies)
+		//it runs after the frame slot's fence has signaled so the slot's resources are free to write
+		inline Frame StartFrame(const std::function<void(Frame& frame)>& preRenderPass = nullptr)
 		{
+			PONG3D_PROFILE_ZONE("Start Frame");
 			Wireframe::Device::GPU* GPU = &engine->GPU;
-			Wireframe::Swapchain::DesktopSwapchain* swapchain = &engine->swapchain;
+			Platform::WindowSwapchain* swapchain = &engine->swapchain;
 
-			//wait until the gpu has finished rendering the last frame. Timeout of 1 second and reset it
-			VK_CHECK(vkWaitForFences(GPU->device, 1, &_renderFence, true, 1000000000));
-			VK_CHECK(vkResetFences(GPU->device, 1, &_renderFence));
+			FrameSlot* slot = &frameSlots[currentFrameSlot];
+
+			//wait until the gpu has finished rendering the last frame that used this slot. Timeout of 1 second
+			//in low latency the frame queued maxQueuedFrames ago is waited on too, its fence is never reset before its own slot comes around
+			VkFence waitFences[2] = { slot->_renderFence, VK_NULL_HANDLE };
+			uint32_t waitFenceCount = 1;
+			if (maxQueuedFrames > 0 && (uint32_t)_frameNumber >= maxQueuedFrames)
+				waitFences[waitFenceCount++] = frameSlots[(currentFrameSlot + framesInFlightCount - maxQueuedFrames) % framesInFlightCount]._renderFence;
+
+			const auto waitStart = std::chrono::high_resolution_clock::now();
+			{
+				PONG3D_PROFILE_ZONE("Fence Wait");
+				VK_CHECK(vkWaitForFences(GPU->device, waitFenceCount, waitFences, true, 1000000000));
+			}
+			pacingStats.AddSample(std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - waitStart).count());
 
 			Frame frame;
-			frame.cmd = commandPool.commandBuffers[0];
+			frame.frameSlotIndex = currentFrameSlot;
+
+			//request image from the swapchain, headless frames take the offscreen images in turn
+			//the fence is only reset once there's a image, a frame given up on here leaves the slot ready for the next one
+			if (engine->isHeadless)
+				frame.swapchainImageIndex = (uint32_t)(_frameNumber % engine->GetColorImageCount());
+			else
+			{
+				if (swapchainNeedsRecreate && !RecreateSwapchain())
+				{
+					frame.isValid = false;
+					return frame;
+				}
+
+				VkResult acquireResult = vkAcquireNextImageKHR(GPU->device, swapchain->_swapchain, 1000000000, slot->_presentSemaphore, nullptr, &frame.swapchainImageIndex);
+				if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR)
+				{
+					swapchainOutOfDateCount++;
+					if (RecreateSwapchain())
+						acquireResult = vkAcquireNextImageKHR(GPU->device, swapchain->_swapchain, 1000000000, slot->_presentSemaphore, nullptr, &frame.swapchainImageIndex);
+				}
+
+				if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR)
+				{
+					swapchainNeedsRecreate = true;
+					frame.isValid = false;
+					return frame;
+				}
+
+				//a suboptimal image still presents, the swapchain is recreated before the next frame
+				if (acquireResult == VK_SUBOPTIMAL_KHR)
+					swapchainNeedsRecreate = true;
+				else
+					VK_CHECK(acquireResult);
+			}
+			VK_CHECK(vkResetFences(GPU->device, 1, &slot->_renderFence));
+
+			const auto frameStart = std::chrono::high_resolution_clock::now();
+			if (hasStartedAFrame)
+				pacingStats.AddFrameSample(std::chrono::duration<float, std::milli>(frameStart - lastFrameStart).count());
+			lastFrameStart = frameStart;
+			hasStartedAFrame = true;
+
+			//the GPU is done with this slot, anything queued for deletion can go and the last frame's scratch data with it
+			slot->deletionQueue.flush();
+			slot->arena.Reset();
+
+			frame.cmd = slot->cmd;
+			frame.arena = &slot->arena;
 
 			//now that we are sure that the commands finished executing, we can safely reset the command buffer to begin recording again.
 			frame.cmd.Reset();
 
-			//request image from the swapchain
-			VK_CHECK(vkAcquireNextImageKHR(GPU->device, swapchain->_swapchain, 1000000000, _presentSemaphore, nullptr, &frame.swapchainImageIndex));
-
 			frame.cmd.StartRecording(); //starts recording
 
+			//the slot's fence has signaled, so the profiler can read what it recorded last time
+			gpuProfiler.BeginFrame(frame.cmd.handle, frame.frameSlotIndex, (uint64_t)_frameNumber);
+			frame.frameProfileScope = gpuProfiler.BeginScope(frame.cmd.handle, "Frame");
+
+			if (preRenderPass)
+			{
+				const uint32_t preRenderPassScope = gpuProfiler.BeginScope(frame.cmd.handle, "Pre Render Pass");
+				preRenderPass(frame);
+				gpuProfiler.EndScope(frame.cmd.handle, preRenderPassScope);
+			}
+
+			frame.renderPassProfileScope = gpuProfiler.BeginScope(frame.cmd.handle, "Render Pass");
+			gpuProfiler.BeginPipelineStatistics(frame.cmd.handle);
+
 			//make a clear-color from frame number. This will flash with a 120 frame period.
 			float flash = abs(sin(_frameNumber / 120.f));
 			renderpassData.clearColor = { { 0.0f, 0.0f, flash, 1.0f } };
 
-			renderpassData.renderSize = engine->window._windowExtent; //sets the size for rendering
+			renderpassData.renderSize = engine->GetRenderExtent(); //sets the size for rendering
 
 			//starts the render pass
-			Wireframe::Renderpass::RenderOperation::StartRenderPass_InlinedContent(frame.cmd.handle, renderpass._renderPass, _framebuffers[frame.swapchainImageIndex], renderpassData);
+			if (recordMode == FrameRecordMode::ParallelSecondary)
+			{
+				//the content comes from secondaries so the pass can't use the inlined helper
+				VkClearValue clearValues[2] = {};
+				clearValues[0].color = { { 0.0f, 0.0f, flash, 1.0f } };
+				clearValues[1].depthStencil.depth = 1.0f;
+
+				VkRenderPassBeginInfo beginInfo = {};
+				beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+				beginInfo.renderPass = renderpass._renderPass;
+				beginInfo.framebuffer = _framebuffers[frame.swapchainImageIndex];
+				beginInfo.renderArea.extent = renderpassData.renderSize;
+				beginInfo.clearValueCount = 2;
+				beginInfo.pClearValues = clearValues;
+				frame.secondariesProfileScope = gpuProfiler.BeginScope(frame.cmd.handle, "Secondaries");
+				vkCmdBeginRenderPass(frame.cmd.handle, &beginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+				slot->secondaryCommandBuffers = Memory::FrameVector_Create<VkCommandBuffer>(&slot->arena, workerCommandPools.size() + 1);
+			}
+			else
+				Wireframe::Renderpass::RenderOperation::StartRenderPass_InlinedContent(frame.cmd.handle, renderpass._renderPass, _framebuffers[frame.swapchainImageIndex], renderpassData);
 		
 			return frame;
 		}
 
+		//starts recording a secondary command buffer that continues the frame's render pass
+		inline void StartSecondaryRecording(Wireframe::CommandBuffer::CommandBuffer& cmd, const Frame& frame)
+		{
+			VkCommandBufferInheritanceInfo inheritanceInfo = {};
+			inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+			inheritanceInfo.renderPass = renderpass._renderPass;
+			inheritanceInfo.subpass = 0;
+			inheritanceInfo.framebuffer = _framebuffers[frame.swapchainImageIndex];
+
+			VkCommandBufferBeginInfo beginInfo = {};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+			beginInfo.pInheritanceInfo = &inheritanceInfo;
+			VK_CHECK(vkBeginCommandBuffer(cmd.handle, &beginInfo));
+		}
+
+		//records the frame's content across the workers, each worker gets its own secondary command buffer
+		//the secondaries are executed in worker order so the callback can split sorted work by the worker index
+		//only valid in FrameRecordMode::ParallelSecondary and once per frame, the callback runs on the worker threads
+		//the callback is taken as is rather than as a std::function so a big capture doesn't heap allocate every frame
+		template<typename RecordFunc>
+		inline void RecordInParallel(const Frame& frame, const RecordFunc& record)
+		{
+			if (recordMode != FrameRecordMode::ParallelSecondary)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDER MANAGER ERROR: RecordInParallel || The render manager was not initalized with FrameRecordMode::ParallelSecondary!\n");
+				return;
+			}
+
+			const uint32_t workerCount = workerPool.GetWorkerCount();
+			workerPool.Run([&](uint32_t workerIndex) {
+				Wireframe::CommandBuffer::CommandBuffer* cmd = &workerCommandPools[workerIndex].commandBuffers[frame.frameSlotIndex];
+				cmd->Reset();
+				StartSecondaryRecording(*cmd, frame);
+				record(cmd->handle, workerIndex, workerCount);
+				cmd->EndRecording();
+				});
+
+			FrameSlot* slot = &frameSlots[frame.frameSlotIndex];
+			for (uint32_t i = 0; i < workerCount; ++i)
+				slot->secondaryCommandBuffers.emplace_back(workerCommandPools[i].commandBuffers[frame.frameSlotIndex].handle);
+		}
+
 		//submits frame
 		inline void SubmitFrame(Frame& frame)
 		{
+			PONG3D_PROFILE_ZONE("Submit Frame");
+			FrameSlot* slot = &frameSlots[frame.frameSlotIndex];
+
+			if (recordMode == FrameRecordMode::ParallelSecondary)
+			{
+				//renders ImGUI widget data into its own secondary, ImGUI isn't thread safe so it stays on this thread
+				if (TyGUIWidgetsShouldRender)
+				{
+					slot->TyGUICmd.Reset();
+					StartSecondaryRecording(slot->TyGUICmd, frame);
+					const uint32_t TyGUIScope = gpuProfiler.BeginScope(slot->TyGUICmd.handle, "TyGUI");
+					widgetRenderer.Render(slot->TyGUICmd.handle);
+					gpuProfiler.EndScope(slot->TyGUICmd.handle, TyGUIScope);
+					slot->TyGUICmd.EndRecording();
+					slot->secondaryCommandBuffers.emplace_back(slot->TyGUICmd.handle);
+				}
+
+				if (slot->secondaryCommandBuffers.size() > 0)
+					vkCmdExecuteCommands(frame.cmd.handle, (uint32_t)slot->secondaryCommandBuffers.size(), slot->secondaryCommandBuffers.data());
+			}
+
 			//renders ImGUI widget data
-			if (TyGUIWidgetsShouldRender)
+			else if (TyGUIWidgetsShouldRender)
+			{
+				const uint32_t TyGUIScope = gpuProfiler.BeginScope(frame.cmd.handle, "TyGUI");
 				widgetRenderer.Render(frame.cmd.handle);
+				gpuProfiler.EndScope(frame.cmd.handle, TyGUIScope);
+			}
 
 			//finalize the render pass
 			Wireframe::Renderpass::RenderOperation::EndRenderPass(frame.cmd.handle);
+			if (recordMode == FrameRecordMode::ParallelSecondary)
+				gpuProfiler.EndScope(frame.cmd.handle, frame.secondariesProfileScope);
+			gpuProfiler.EndPipelineStatistics(frame.cmd.handle);
+			gpuProfiler.EndScope(frame.cmd.handle, frame.renderPassProfileScope);
+			gpuProfiler.EndScope(frame.cmd.handle, frame.frameProfileScope);
+			gpuProfiler.EndFrame();
 
 			frame.cmd.EndRecording(); //stops recording
 
@@ -218,15 +680,26 @@ namespace Pong3D::Renderer
 
 			submit.pWaitDstStageMask = &waitStage;
 
-			submit.waitSemaphoreCount = 1;
-			submit.pWaitSemaphores = &_presentSemaphore;
+			//headless frames have no image to wait on or present
+			if (!engine->isHeadless)
+			{
+				submit.waitSemaphoreCount = 1;
+				submit.pWaitSemaphores = &slot->_presentSemaphore;
 
-			submit.signalSemaphoreCount = 1;
-			submit.pSignalSemaphores = &_renderSemaphore;
+				submit.signalSemaphoreCount = 1;
+				submit.pSignalSemaphores = &slot->_renderSemaphore;
+			}
 
 			//submit command buffer to the queue and execute it.
-			// _renderFence will now block until the graphic commands finish execution
-			VK_CHECK(vkQueueSubmit(GPU->graphicsQueue, 1, &submit, _renderFence));
+			// the slot's _renderFence will now block until the graphic commands finish execution
+			VK_CHECK(vkQueueSubmit(GPU->graphicsQueue, 1, &submit, slot->_renderFence));
+
+			if (engine->isHeadless)
+			{
+				_frameNumber++;
+				currentFrameSlot = (currentFrameSlot + 1) % framesInFlightCount;
+				return;
+			}
 
 			//prepare present
 			// this will put the image we just rendered to into the visible window.
@@ -237,15 +710,31 @@ namespace Pong3D::Renderer
 			presentInfo.pSwapchains = &engine->swapchain._swapchain;
 			presentInfo.swapchainCount = 1;
 
-			presentInfo.pWaitSemaphores = &_renderSemaphore;
+			presentInfo.pWaitSemaphores = &slot->_renderSemaphore;
 			presentInfo.waitSemaphoreCount = 1;
 
 			presentInfo.pImageIndices = &frame.swapchainImageIndex;
 
-			VK_CHECK(vkQueuePresentKHR(GPU->graphicsQueue, &presentInfo));
+			//a resized window makes the swapchain out of date, it's recreated at the start of the next frame instead of failing
+			const VkResult presentResult = vkQueuePresentKHR(GPU->graphicsQueue, &presentInfo);
+			if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR)
+			{
+				swapchainOutOfDateCount += (presentResult == VK_ERROR_OUT_OF_DATE_KHR ? 1 : 0);
+				swapchainNeedsRecreate = true;
+			}
+			else
+				VK_CHECK(presentResult);
 
-			//increase the number of frames drawn
+			//increase the number of frames drawn and move to the next slot
 			_frameNumber++;
+			currentFrameSlot = (currentFrameSlot + 1) % framesInFlightCount;
+		}
+
+		//queues a object for deletion once the GPU is done with the frame that used it
+		//the frame's own slot is used, the current slot has already moved on once the frame is submitted
+		inline void PushFrameDeletion(const Frame& frame, std::function<void()>&& function)
+		{
+			frameSlots[frame.frameSlotIndex].deletionQueue.push_function(std::move(function));
 		}
 
 		//enables TyGUI widget rendering
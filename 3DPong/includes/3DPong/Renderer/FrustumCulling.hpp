@@ -0,0 +1,176 @@
+#pragma once
+
+//defines CPU frustum and distance culling of bounding spheres, 4 (SSE) or 8 (AVX) spheres at a time
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX__)
+#define PONG3D_CULLING_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG3D_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Pong3D::Renderer
+{
+	//defines world space bounding spheres stored as arrays of each part so they can be loaded a register at a time
+	struct BoundingSphereSoA
+	{
+		std::vector<float> x, y, z, radius;
+
+		inline size_t Size() const { return x.size(); }
+
+		inline void Resize(size_t count)
+		{
+			x.resize(count); y.resize(count); z.resize(count); radius.resize(count);
+		}
+
+		//sets a sphere, a negative radius means it has no bounds and is never culled
+		inline void Set(size_t index, const glm::vec3& center, float _radius)
+		{
+			x[index] = center.x; y[index] = center.y; z[index] = center.z;
+			radius[index] = (_radius < 0.0f ? std::numeric_limits<float>::infinity() : _radius);
+		}
+	};
+
+	//defines the settings of a cull
+	struct CullSettings
+	{
+		const glm::vec4* frustumPlanes = nullptr; //6 normalized planes pointing inside
+		glm::vec3 cameraPosition = glm::vec3(0.0f);
+		float maxDistance = 0.0f; //spheres further than this are culled, 0 or less disables it
+	};
+
+	//culls a single sphere
+	inline bool CullSphere_Scalar(const CullSettings& settings, float x, float y, float z, float radius)
+	{
+		for (size_t p = 0; p < 6; ++p)
+		{
+			const glm::vec4& plane = settings.frustumPlanes[p];
+			if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius)
+				return false;
+		}
+
+		if (settings.maxDistance > 0.0f)
+		{
+			const float dx = x - settings.cameraPosition.x, dy = y - settings.cameraPosition.y, dz = z - settings.cameraPosition.z;
+			const float reach = settings.maxDistance + radius;
+			if (dx * dx + dy * dy + dz * dz > reach * reach)
+				return false;
+		}
+
+		return true;
+	}
+
+	//culls the spheres, writing 1 into visibility for the ones that are visible and 0 for the rest
+	//returns how many are visible
+	inline size_t CullSpheres(const CullSettings& settings, const BoundingSphereSoA& spheres, uint8_t* visibility)
+	{
+		const size_t count = spheres.Size();
+		const float* xs = spheres.x.data(); const float* ys = spheres.y.data(); const float* zs = spheres.z.data(); const float* rs = spheres.radius.data();
+		const bool useDistance = settings.maxDistance > 0.0f;
+
+		size_t visibleCount = 0;
+		size_t i = 0;
+
+#if defined(PONG3D_CULLING_AVX)
+		__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (size_t p = 0; p < 6; ++p)
+		{
+			planeX[p] = _mm256_set1_ps(settings.frustumPlanes[p].x); planeY[p] = _mm256_set1_ps(settings.frustumPlanes[p].y);
+			planeZ[p] = _mm256_set1_ps(settings.frustumPlanes[p].z); planeW[p] = _mm256_set1_ps(settings.frustumPlanes[p].w);
+		}
+		const __m256 camX = _mm256_set1_ps(settings.cameraPosition.x), camY = _mm256_set1_ps(settings.cameraPosition.y), camZ = _mm256_set1_ps(settings.cameraPosition.z);
+		const __m256 maxDistance = _mm256_set1_ps(settings.maxDistance);
+		const __m256 zero = _mm256_setzero_ps();
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i), z = _mm256_loadu_ps(zs + i), r = _mm256_loadu_ps(rs + i);
+			const __m256 negativeR = _mm256_sub_ps(zero, r);
+
+			//a sphere is outside if it's fully behind any plane
+			__m256 outside = _mm256_setzero_ps();
+			for (size_t p = 0; p < 6; ++p)
+			{
+				const __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y)),
+					_mm256_add_ps(_mm256_mul_ps(planeZ[p], z), planeW[p]));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, negativeR, _CMP_LT_OQ));
+			}
+
+			if (useDistance)
+			{
+				const __m256 dx = _mm256_sub_ps(x, camX), dy = _mm256_sub_ps(y, camY), dz = _mm256_sub_ps(z, camZ);
+				const __m256 distanceSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+				const __m256 reach = _mm256_add_ps(maxDistance, r);
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(distanceSquared, _mm256_mul_ps(reach, reach), _CMP_GT_OQ));
+			}
+
+			const int outsideMask = _mm256_movemask_ps(outside);
+			for (int lane = 0; lane < 8; ++lane)
+			{
+				const uint8_t isVisible = (uint8_t)(((outsideMask >> lane) & 1) ^ 1);
+				visibility[i + lane] = isVisible;
+				visibleCount += isVisible;
+			}
+		}
+#elif defined(PONG3D_CULLING_SSE)
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (size_t p = 0; p < 6; ++p)
+		{
+			planeX[p] = _mm_set1_ps(settings.frustumPlanes[p].x); planeY[p] = _mm_set1_ps(settings.frustumPlanes[p].y);
+			planeZ[p] = _mm_set1_ps(settings.frustumPlanes[p].z); planeW[p] = _mm_set1_ps(settings.frustumPlanes[p].w);
+		}
+		const __m128 camX = _mm_set1_ps(settings.cameraPosition.x), camY = _mm_set1_ps(settings.cameraPosition.y), camZ = _mm_set1_ps(settings.cameraPosition.z);
+		const __m128 maxDistance = _mm_set1_ps(settings.maxDistance);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i), z = _mm_loadu_ps(zs + i), r = _mm_loadu_ps(rs + i);
+			const __m128 negativeR = _mm_sub_ps(zero, r);
+
+			//a sphere is outside if it's fully behind any plane
+			__m128 outside = _mm_setzero_ps();
+			for (size_t p = 0; p < 6; ++p)
+			{
+				const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+					_mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negativeR));
+			}
+
+			if (useDistance)
+			{
+				const __m128 dx = _mm_sub_ps(x, camX), dy = _mm_sub_ps(y, camY), dz = _mm_sub_ps(z, camZ);
+				const __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				const __m128 reach = _mm_add_ps(maxDistance, r);
+				outside = _mm_or_ps(outside, _mm_cmpgt_ps(distanceSquared, _mm_mul_ps(reach, reach)));
+			}
+
+			const int outsideMask = _mm_movemask_ps(outside);
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				const uint8_t isVisible = (uint8_t)(((outsideMask >> lane) & 1) ^ 1);
+				visibility[i + lane] = isVisible;
+				visibleCount += isVisible;
+			}
+		}
+#endif
+
+		//what's left over, or everything if there is no SIMD
+		for (; i < count; ++i)
+		{
+			const uint8_t isVisible = (CullSphere_Scalar(settings, xs[i], ys[i], zs[i], rs[i]) ? 1 : 0);
+			visibility[i] = isVisible;
+			visibleCount += isVisible;
+		}
+
+		return visibleCount;
+	}
+}
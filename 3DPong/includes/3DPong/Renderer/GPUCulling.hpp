@@ -0,0 +1,308 @@
+#pragma once
+
+//defines the GPU driven path, a compute pass frustum culls the instances and writes the indirect draw commands the batches draw with
+
+#include <3DPong/Renderer/FrameConstants.hpp>
+#include <3DPong/Renderer/InstanceBuffer.hpp>
+
+#include <string>
+
+namespace Pong3D::Renderer
+{
+	//defines the bounds of a instance, matches cull.comp
+	struct GPUCullInstanceBounds
+	{
+		glm::vec4 sphere = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f); //local space center and radius, a negative radius is never culled
+		uint32_t runIndex = 0;
+		uint32_t runFirstInstance = 0;
+		uint32_t pad[2] = { 0, 0 };
+	};
+
+	//defines a indirect command, the run index rides along after the Vulkan command so the stride is 32 bytes. Matches cull.comp
+	struct GPUIndirectCommand
+	{
+		VkDrawIndexedIndirectCommand command = {};
+		uint32_t runIndex = 0;
+		uint32_t pad[2] = { 0, 0 };
+	};
+
+	//defines the push constants of the cull pass, matches cull.comp
+	struct GPUCullPushConstants
+	{
+		glm::vec4 frustumPlanes[(size_t)FrustumPlane::Count];
+		uint32_t instanceCount = 0;
+		uint32_t commandCount = 0;
+		uint32_t pass = 0; //0 culls the instances, 1 writes the instance counts into the commands
+		uint32_t pad = 0;
+	};
+
+	//the bindings of the cull pass, matches cull.comp
+	enum class GPUCullBinding : uint32_t
+	{
+		Instances = 0,
+		Bounds,
+		VisibleInstances,
+		RunCounters,
+		Commands,
+
+		Count
+	};
+
+	static constexpr uint32_t GPU_CULL_WORKGROUP_SIZE = 64;
+
+	//defines the GPU culling data of a batch for a single frame in flight
+	struct GPUCullingFrameData
+	{
+		InstanceBuffer bounds; //written by the CPU when the draw list is compiled
+		InstanceBuffer commands; //written by the CPU when the draw list is compiled, the GPU fills in the instance counts
+		InstanceBuffer visibleInstances; //GPU only, the compacted visible instances the draws read
+		InstanceBuffer runCounters; //GPU only, how many instances of each run are visible
+		InstanceBuffer readback; //the run counters copied back so the CPU can read the visible count a few frames late
+
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+		//what was recorded into this frame, used when reading it back
+		uint32_t instanceCount = 0, commandCount = 0, runCount = 0;
+		bool hasReadback = false;
+
+		//destroys the buffers, the descriptor set is freed with the pool
+		inline void Destroy(VmaAllocator allocator)
+		{
+			bounds.Destroy(allocator);
+			commands.Destroy(allocator);
+			visibleInstances.Destroy(allocator);
+			runCounters.Destroy(allocator);
+			readback.Destroy(allocator);
+			descriptorSet = VK_NULL_HANDLE;
+			hasReadback = false;
+		}
+	};
+
+	//defines the GPU culling pass, the pipeline is shared by every batch that uses it
+	struct GPUCullingPass
+	{
+		Wireframe::Device::GPU* GPU = nullptr;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+
+		bool isCreated = false;
+
+		//creates the pass, max frame data is how many batches * frames in flight can use it
+		inline bool Create(Wireframe::Device::GPU* _GPU, VmaAllocator _allocator, const std::string& shaderBinaryFilepath, uint32_t maxFrameData = 64,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE)
+		{
+			GPU = _GPU;
+			allocator = _allocator;
+
+			//loads the shader
+			Wireframe::Shader::ShaderModule cullShader;
+			if (!cullShader.Create(shaderBinaryFilepath.c_str(), GPU))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: GPU Culling Pass || Create || Failed to load the cull shader at \"{}\", compile shaders/Code/cull.comp!\n", shaderBinaryFilepath);
+				return false;
+			}
+
+			//the layout, every binding is a storage buffer
+			VkDescriptorSetLayoutBinding bindings[(size_t)GPUCullBinding::Count] = {};
+			for (uint32_t i = 0; i < (uint32_t)GPUCullBinding::Count; ++i)
+			{
+				bindings[i].binding = i;
+				bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				bindings[i].descriptorCount = 1;
+				bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			}
+			VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+			setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			setLayoutInfo.bindingCount = (uint32_t)GPUCullBinding::Count;
+			setLayoutInfo.pBindings = bindings;
+			VK_CHECK(vkCreateDescriptorSetLayout(GPU->device, &setLayoutInfo, nullptr, &descriptorSetLayout));
+
+			VkDescriptorPoolSize poolSize = {};
+			poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			poolSize.descriptorCount = maxFrameData * (uint32_t)GPUCullBinding::Count;
+			VkDescriptorPoolCreateInfo poolInfo = {};
+			poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolInfo.maxSets = maxFrameData;
+			poolInfo.poolSizeCount = 1;
+			poolInfo.pPoolSizes = &poolSize;
+			VK_CHECK(vkCreateDescriptorPool(GPU->device, &poolInfo, nullptr, &descriptorPool));
+
+			VkPushConstantRange pushConstant = {};
+			pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			pushConstant.size = sizeof(GPUCullPushConstants);
+			VkPipelineLayoutCreateInfo layoutInfo = {};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			layoutInfo.setLayoutCount = 1;
+			layoutInfo.pSetLayouts = &descriptorSetLayout;
+			layoutInfo.pushConstantRangeCount = 1;
+			layoutInfo.pPushConstantRanges = &pushConstant;
+			VK_CHECK(vkCreatePipelineLayout(GPU->device, &layoutInfo, nullptr, &pipelineLayout));
+
+			//the pipeline
+			VkComputePipelineCreateInfo pipelineInfo = {};
+			pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+			pipelineInfo.stage = Wireframe::Shader::GenerateShaderStageInfoForPipeline(cullShader, Wireframe::Shader::Util::ShaderStage::Compute);
+			pipelineInfo.layout = pipelineLayout;
+			const VkResult result = vkCreateComputePipelines(GPU->device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+			cullShader.Destroy(GPU);
+			if (result != VK_SUCCESS)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: GPU Culling Pass || Create || Failed to create the cull pipeline!\n");
+				Destroy();
+				return false;
+			}
+
+			isCreated = true;
+			return true;
+		}
+
+		//destroys the pass, every batch using it must have destroyed its frame data
+		inline void Destroy()
+		{
+			if (pipeline != VK_NULL_HANDLE) vkDestroyPipeline(GPU->device, pipeline, nullptr);
+			if (pipelineLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(GPU->device, pipelineLayout, nullptr);
+			if (descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(GPU->device, descriptorPool, nullptr);
+			if (descriptorSetLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(GPU->device, descriptorSetLayout, nullptr);
+
+			pipeline = VK_NULL_HANDLE; pipelineLayout = VK_NULL_HANDLE; descriptorPool = VK_NULL_HANDLE; descriptorSetLayout = VK_NULL_HANDLE;
+			isCreated = false;
+		}
+
+		//creates the frame data a batch needs for each frame in flight
+		inline bool AllocateFrameData(std::vector<GPUCullingFrameData>& frames, uint32_t framesInFlight)
+		{
+			frames.resize(framesInFlight);
+			for (uint32_t i = 0; i < framesInFlight; ++i)
+			{
+				GPUCullingFrameData* frame = &frames[i];
+				frame->bounds.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+				frame->commands.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+				frame->visibleInstances.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+				frame->visibleInstances.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+				frame->runCounters.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+				frame->runCounters.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+				frame->readback.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+				frame->readback.memoryUsage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+
+				VkDescriptorSetAllocateInfo allocInfo = {};
+				allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+				allocInfo.descriptorPool = descriptorPool;
+				allocInfo.descriptorSetCount = 1;
+				allocInfo.pSetLayouts = &descriptorSetLayout;
+				if (vkAllocateDescriptorSets(GPU->device, &allocInfo, &frame->descriptorSet) != VK_SUCCESS)
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: GPU Culling Pass || AllocateFrameData || Out of descriptor sets, raise the max frame data!\n");
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		//makes sure the GPU written buffers can hold the frame's instances and runs, call after the fence for the frame has signaled
+		inline bool ReserveFrame(GPUCullingFrameData& frame, uint32_t instanceCount, uint32_t runCount)
+		{
+			return frame.visibleInstances.Reserve(allocator, (VkDeviceSize)instanceCount * sizeof(glm::mat4)) &&
+				frame.runCounters.Reserve(allocator, (VkDeviceSize)runCount * sizeof(uint32_t)) &&
+				frame.readback.Reserve(allocator, (VkDeviceSize)runCount * sizeof(uint32_t));
+		}
+
+		//reads how many instances were visible the last time this frame was recorded, call after the fence for the frame has signaled
+		//returns false if there is nothing to read yet
+		inline bool ReadVisibleCount(GPUCullingFrameData& frame, uint64_t& visibleCount)
+		{
+			if (!frame.hasReadback)
+				return false;
+
+			frame.readback.Invalidate(allocator, 0, (VkDeviceSize)frame.runCount * sizeof(uint32_t));
+			const uint32_t* counters = (const uint32_t*)frame.readback.mappedData;
+			visibleCount = 0;
+			for (uint32_t i = 0; i < frame.runCount; ++i)
+				visibleCount += counters[i];
+
+			return true;
+		}
+
+		//records the cull, must be outside of a render pass. The instances buffer holds the model matrices the bounds belong to
+		inline void RecordCull(VkCommandBuffer& cmd, GPUCullingFrameData& frame, InstanceBuffer& instances, const ViewFrameConstants& view,
+			uint32_t instanceCount, uint32_t commandCount, uint32_t runCount)
+		{
+			frame.instanceCount = instanceCount; frame.commandCount = commandCount; frame.runCount = runCount;
+			frame.hasReadback = false;
+			if (instanceCount == 0 || runCount == 0)
+				return;
+
+			//points the set at this frame's buffers, they may have grown since the last time
+			VkDescriptorBufferInfo bufferInfos[(size_t)GPUCullBinding::Count] = {};
+			bufferInfos[(size_t)GPUCullBinding::Instances] = { instances.buffer, 0, (VkDeviceSize)instanceCount * sizeof(glm::mat4) };
+			bufferInfos[(size_t)GPUCullBinding::Bounds] = { frame.bounds.buffer, 0, (VkDeviceSize)instanceCount * sizeof(GPUCullInstanceBounds) };
+			bufferInfos[(size_t)GPUCullBinding::VisibleInstances] = { frame.visibleInstances.buffer, 0, (VkDeviceSize)instanceCount * sizeof(glm::mat4) };
+			bufferInfos[(size_t)GPUCullBinding::RunCounters] = { frame.runCounters.buffer, 0, (VkDeviceSize)runCount * sizeof(uint32_t) };
+			bufferInfos[(size_t)GPUCullBinding::Commands] = { frame.commands.buffer, 0, (VkDeviceSize)commandCount * sizeof(GPUIndirectCommand) };
+
+			VkWriteDescriptorSet writes[(size_t)GPUCullBinding::Count] = {};
+			for (uint32_t i = 0; i < (uint32_t)GPUCullBinding::Count; ++i)
+			{
+				writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[i].dstSet = frame.descriptorSet;
+				writes[i].dstBinding = i;
+				writes[i].descriptorCount = 1;
+				writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writes[i].pBufferInfo = &bufferInfos[i];
+			}
+			vkUpdateDescriptorSets(GPU->device, (uint32_t)GPUCullBinding::Count, writes, 0, nullptr);
+
+			//clears the counters
+			vkCmdFillBuffer(cmd, frame.runCounters.buffer, 0, (VkDeviceSize)runCount * sizeof(uint32_t), 0);
+			VkMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+
+			GPUCullPushConstants constants;
+			for (size_t i = 0; i < (size_t)FrustumPlane::Count; ++i)
+				constants.frustumPlanes[i] = view.frustumPlanes[i];
+			constants.instanceCount = instanceCount;
+			constants.commandCount = commandCount;
+
+			//culls the instances
+			constants.pass = 0;
+			vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullPushConstants), &constants);
+			vkCmdDispatch(cmd, (instanceCount + GPU_CULL_WORKGROUP_SIZE - 1) / GPU_CULL_WORKGROUP_SIZE, 1, 1);
+
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			//writes the counts into the commands
+			constants.pass = 1;
+			vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPUCullPushConstants), &constants);
+			vkCmdDispatch(cmd, (commandCount + GPU_CULL_WORKGROUP_SIZE - 1) / GPU_CULL_WORKGROUP_SIZE, 1, 1);
+
+			//the draws read the commands and visible instances, the copy reads the counters
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			//copies the counters back for the CPU
+			VkBufferCopy copy = {};
+			copy.size = (VkDeviceSize)runCount * sizeof(uint32_t);
+			vkCmdCopyBuffer(cmd, frame.runCounters.buffer, frame.readback.buffer, 1, &copy);
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			frame.hasReadback = true;
+		}
+	};
+}
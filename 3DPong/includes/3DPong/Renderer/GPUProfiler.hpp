@@ -0,0 +1,332 @@
+#pragma once
+
+//defines a GPU profiler, named scopes write timestamps into a query pool owned by the frame slot
+//a slot's queries are read once its fence has signaled, so the results are frames in flight late but never stall
+
+#include <BTDSTD/Wireframe/Core/GPU.hpp>
+
+#include <string>
+#include <vector>
+
+namespace Pong3D::Renderer
+{
+	//defines the pipeline statistics of a frame's render pass
+	struct GPUPipelineStatistics
+	{
+		uint64_t inputAssemblyVertices = 0;
+		uint64_t vertexShaderInvocations = 0;
+		uint64_t clippingPrimitives = 0; //the primitives that made it past clipping
+		uint64_t fragmentShaderInvocations = 0;
+	};
+
+	//the statistics collected, in the order the query writes them
+	static constexpr VkQueryPipelineStatisticFlags GPU_PROFILER_PIPELINE_STATISTICS = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+	//defines the result of a scope
+	struct GPUProfileScopeResult
+	{
+		std::string name;
+		uint32_t depth = 0; //how many scopes it's inside of
+		double durationMS = 0.0;
+	};
+
+	//defines the results of a frame
+	struct GPUProfileFrameResults
+	{
+		bool isValid = false;
+		uint64_t frameNumber = 0; //the frame the results are from
+
+		std::vector<GPUProfileScopeResult> scopes; //in the order they were started
+		double frameMS = 0.0; //the first scope to the last one
+
+		bool hasPipelineStatistics = false;
+		GPUPipelineStatistics pipelineStatistics;
+
+		//gets the duration of a scope, 0 if it wasn't recorded
+		inline double GetScopeMS(const char* name) const
+		{
+			for (size_t i = 0; i < scopes.size(); ++i)
+			{
+				if (scopes[i].name == name)
+					return scopes[i].durationMS;
+			}
+			return 0.0;
+		}
+	};
+
+	//defines a scope recorded into a frame slot
+	struct GPUProfileScope
+	{
+		std::string name;
+		uint32_t depth = 0;
+		bool isClosed = false;
+	};
+
+	//defines the queries of a frame slot
+	struct GPUProfilerFrameSlot
+	{
+		VkQueryPool timestampPool = VK_NULL_HANDLE; //two timestamps per scope
+		VkQueryPool statisticsPool = VK_NULL_HANDLE; //one query, around the render pass
+
+		std::vector<GPUProfileScope> scopes;
+		uint32_t openScopeCount = 0;
+		bool statisticsWereWritten = false;
+
+		bool hasQueries = false; //has been recorded since its last read
+		uint64_t frameNumber = 0;
+	};
+
+	//defines the profiler
+	struct GPUProfiler
+	{
+		Wireframe::Device::GPU* GPU = nullptr;
+		bool isCreated = false;
+
+		uint32_t maxScopes = 0;
+		double timestampPeriodNS = 1.0; //how many nanoseconds a tick is
+		uint64_t timestampMask = ~0ull; //the bits of a timestamp the queue writes
+		bool collectsPipelineStatistics = false;
+
+		std::vector<GPUProfilerFrameSlot> frameSlots;
+		uint32_t recordingSlot = UINT32_MAX; //the slot the current frame is recording into
+
+		GPUProfileFrameResults lastResults; //the last frame that was read back
+		std::vector<uint64_t> timestampScratch;
+
+		//creates the query pools, pipeline statistics need the pipelineStatisticsQuery device feature enabled
+		inline bool Create(Wireframe::Device::GPU* _GPU, uint32_t framesInFlight, uint32_t _maxScopes = 32, bool collectPipelineStatistics = false)
+		{
+			GPU = _GPU;
+			maxScopes = _maxScopes;
+			collectsPipelineStatistics = collectPipelineStatistics;
+
+			//the queue has to support timestamps
+			uint32_t familyCount = 0;
+			vkGetPhysicalDeviceQueueFamilyProperties(GPU->chosenGPU, &familyCount, nullptr);
+			std::vector<VkQueueFamilyProperties> families(familyCount);
+			vkGetPhysicalDeviceQueueFamilyProperties(GPU->chosenGPU, &familyCount, families.data());
+			const uint32_t validBits = (GPU->graphicsQueueFamily < familyCount ? families[GPU->graphicsQueueFamily].timestampValidBits : 0);
+			if (validBits == 0)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDERER WARNING: GPU Profiler || Create || The graphics queue does not support timestamps, GPU profiling is off.\n");
+				return false;
+			}
+			timestampMask = (validBits >= 64 ? ~0ull : ((1ull << validBits) - 1));
+
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties(GPU->chosenGPU, &properties);
+			timestampPeriodNS = properties.limits.timestampPeriod;
+
+			//statistics pools can't be made on a device without the feature
+			if (collectsPipelineStatistics)
+			{
+				VkPhysicalDeviceFeatures features;
+				vkGetPhysicalDeviceFeatures(GPU->chosenGPU, &features);
+				if (!features.pipelineStatisticsQuery)
+				{
+					fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDERER WARNING: GPU Profiler || Create || The device does not support pipeline statistics queries, only timing.\n");
+					collectsPipelineStatistics = false;
+				}
+			}
+
+			frameSlots.resize(framesInFlight);
+			for (uint32_t i = 0; i < framesInFlight; ++i)
+			{
+				GPUProfilerFrameSlot* slot = &frameSlots[i];
+				slot->scopes.reserve(maxScopes);
+
+				VkQueryPoolCreateInfo timestampInfo = {};
+				timestampInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+				timestampInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+				timestampInfo.queryCount = maxScopes * 2;
+				if (vkCreateQueryPool(GPU->device, &timestampInfo, nullptr, &slot->timestampPool) != VK_SUCCESS)
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: GPU Profiler || Create || Failed to create a timestamp query pool!\n");
+					Destroy();
+					return false;
+				}
+
+				if (collectsPipelineStatistics)
+				{
+					VkQueryPoolCreateInfo statisticsInfo = {};
+					statisticsInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+					statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+					statisticsInfo.queryCount = 1;
+					statisticsInfo.pipelineStatistics = GPU_PROFILER_PIPELINE_STATISTICS;
+					if (vkCreateQueryPool(GPU->device, &statisticsInfo, nullptr, &slot->statisticsPool) != VK_SUCCESS)
+					{
+						fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDERER WARNING: GPU Profiler || Create || Failed to create a pipeline statistics query pool, is pipelineStatisticsQuery enabled? Only timing.\n");
+						collectsPipelineStatistics = false;
+					}
+				}
+			}
+
+			timestampScratch.resize((size_t)maxScopes * 2);
+			isCreated = true;
+			return true;
+		}
+
+		//destroys the query pools, the GPU must be done with them
+		inline void Destroy()
+		{
+			for (size_t i = 0; i < frameSlots.size(); ++i)
+			{
+				if (frameSlots[i].timestampPool != VK_NULL_HANDLE)
+					vkDestroyQueryPool(GPU->device, frameSlots[i].timestampPool, nullptr);
+				if (frameSlots[i].statisticsPool != VK_NULL_HANDLE)
+					vkDestroyQueryPool(GPU->device, frameSlots[i].statisticsPool, nullptr);
+			}
+			frameSlots.clear();
+			isCreated = false;
+		}
+
+		//reads the results the slot's last frame left, the slot's fence must have signaled
+		inline void ReadSlot(GPUProfilerFrameSlot& slot)
+		{
+			if (!slot.hasQueries)
+				return;
+			slot.hasQueries = false;
+
+			const uint32_t scopeCount = (uint32_t)slot.scopes.size();
+			if (scopeCount == 0)
+				return;
+
+			//everything was submitted and the fence signaled, so the results are there without waiting
+			if (vkGetQueryPoolResults(GPU->device, slot.timestampPool, 0, scopeCount * 2, scopeCount * 2 * sizeof(uint64_t),
+				timestampScratch.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+				return;
+
+			lastResults.isValid = true;
+			lastResults.frameNumber = slot.frameNumber;
+			lastResults.scopes.resize(scopeCount);
+			uint64_t first = UINT64_MAX, last = 0;
+			for (uint32_t i = 0; i < scopeCount; ++i)
+			{
+				const uint64_t begin = timestampScratch[i * 2] & timestampMask, end = timestampScratch[i * 2 + 1] & timestampMask;
+				GPUProfileScopeResult* result = &lastResults.scopes[i];
+				result->name = slot.scopes[i].name;
+				result->depth = slot.scopes[i].depth;
+				result->durationMS = (end > begin ? (double)(end - begin) * timestampPeriodNS / 1000000.0 : 0.0);
+
+				if (begin < first) first = begin;
+				if (end > last) last = end;
+			}
+			lastResults.frameMS = (last > first ? (double)(last - first) * timestampPeriodNS / 1000000.0 : 0.0);
+
+			lastResults.hasPipelineStatistics = false;
+			if (slot.statisticsWereWritten)
+			{
+				uint64_t statistics[4] = {};
+				if (vkGetQueryPoolResults(GPU->device, slot.statisticsPool, 0, 1, sizeof(statistics), statistics, sizeof(statistics), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+				{
+					lastResults.hasPipelineStatistics = true;
+					lastResults.pipelineStatistics.inputAssemblyVertices = statistics[0];
+					lastResults.pipelineStatistics.vertexShaderInvocations = statistics[1];
+					lastResults.pipelineStatistics.clippingPrimitives = statistics[2];
+					lastResults.pipelineStatistics.fragmentShaderInvocations = statistics[3];
+				}
+			}
+		}
+
+		//starts a frame in a slot, reading what the slot last recorded and resetting its queries
+		//call once the slot's fence has signaled, outside of a render pass
+		inline void BeginFrame(VkCommandBuffer& cmd, uint32_t frameSlotIndex, uint64_t frameNumber)
+		{
+			if (!isCreated)
+				return;
+
+			GPUProfilerFrameSlot* slot = &frameSlots[frameSlotIndex];
+			ReadSlot(*slot);
+
+			vkCmdResetQueryPool(cmd, slot->timestampPool, 0, maxScopes * 2);
+			if (collectsPipelineStatistics)
+				vkCmdResetQueryPool(cmd, slot->statisticsPool, 0, 1);
+
+			slot->scopes.clear();
+			slot->openScopeCount = 0;
+			slot->statisticsWereWritten = false;
+			slot->hasQueries = true;
+			slot->frameNumber = frameNumber;
+			recordingSlot = frameSlotIndex;
+		}
+
+		//starts a named scope, returns its index for EndScope or UINT32_MAX if it wasn't recorded
+		//scopes can nest, the command buffer can be a secondary as long as it's submitted with the frame
+		inline uint32_t BeginScope(VkCommandBuffer cmd, const char* name)
+		{
+			if (!isCreated || recordingSlot == UINT32_MAX)
+				return UINT32_MAX;
+
+			GPUProfilerFrameSlot* slot = &frameSlots[recordingSlot];
+			if (slot->scopes.size() >= maxScopes)
+				return UINT32_MAX;
+
+			const uint32_t scopeIndex = (uint32_t)slot->scopes.size();
+			GPUProfileScope* scope = &slot->scopes.emplace_back();
+			scope->name = name;
+			scope->depth = slot->openScopeCount++;
+
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot->timestampPool, scopeIndex * 2);
+			return scopeIndex;
+		}
+
+		//ends a scope
+		inline void EndScope(VkCommandBuffer cmd, uint32_t scopeIndex)
+		{
+			if (scopeIndex == UINT32_MAX || recordingSlot == UINT32_MAX)
+				return;
+
+			GPUProfilerFrameSlot* slot = &frameSlots[recordingSlot];
+			if (scopeIndex >= slot->scopes.size() || slot->scopes[scopeIndex].isClosed)
+				return;
+
+			slot->scopes[scopeIndex].isClosed = true;
+			slot->openScopeCount--;
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot->timestampPool, scopeIndex * 2 + 1);
+		}
+
+		//starts collecting pipeline statistics, once a frame. Only work recorded into the same command buffer is counted
+		inline void BeginPipelineStatistics(VkCommandBuffer& cmd)
+		{
+			if (!isCreated || !collectsPipelineStatistics || recordingSlot == UINT32_MAX)
+				return;
+
+			GPUProfilerFrameSlot* slot = &frameSlots[recordingSlot];
+			if (slot->statisticsWereWritten)
+				return;
+
+			vkCmdBeginQuery(cmd, slot->statisticsPool, 0, 0);
+			slot->statisticsWereWritten = true;
+		}
+
+		//stops collecting pipeline statistics
+		inline void EndPipelineStatistics(VkCommandBuffer& cmd)
+		{
+			if (!isCreated || !collectsPipelineStatistics || recordingSlot == UINT32_MAX || !frameSlots[recordingSlot].statisticsWereWritten)
+				return;
+
+			vkCmdEndQuery(cmd, frameSlots[recordingSlot].statisticsPool, 0);
+		}
+
+		//ends the frame, scopes left open are not read
+		inline void EndFrame()
+		{
+			if (recordingSlot == UINT32_MAX)
+				return;
+
+			//a scope that was never closed has no end timestamp, so the reads stop before it
+			GPUProfilerFrameSlot* slot = &frameSlots[recordingSlot];
+			for (size_t i = 0; i < slot->scopes.size(); ++i)
+			{
+				if (!slot->scopes[i].isClosed)
+				{
+					slot->scopes.resize(i);
+					break;
+				}
+			}
+			recordingSlot = UINT32_MAX;
+		}
+	};
+}
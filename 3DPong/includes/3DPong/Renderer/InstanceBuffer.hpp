@@ -0,0 +1,89 @@
+#pragma once
+
+//defines a growable buffer, host visible ones stay mapped. Used for streaming per instance data to the GPU every frame
+
+#include <BTDSTD/Wireframe/Core/GPU.hpp>
+
+#include <vk_mem_alloc.h>
+
+namespace Pong3D::Renderer
+{
+	//defines a persistently mapped buffer
+	struct InstanceBuffer
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		void* mappedData = nullptr; //stays mapped for the lifetime of the buffer
+
+		VkDeviceSize capacity = 0; //the size in bytes
+		VkBufferUsageFlags usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+		VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU; //GPU only buffers are never mapped
+
+		//creates the buffer
+		inline bool Create(VmaAllocator allocator, VkDeviceSize size, VkBufferUsageFlags _usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VmaMemoryUsage _memoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU)
+		{
+			usage = _usage;
+			memoryUsage = _memoryUsage;
+
+			VkBufferCreateInfo bufferInfo = {};
+			bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferInfo.size = size;
+			bufferInfo.usage = usage;
+			bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VmaAllocationCreateInfo allocInfo = {};
+			allocInfo.usage = memoryUsage;
+			allocInfo.flags = (memoryUsage == VMA_MEMORY_USAGE_GPU_ONLY ? 0 : VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+			VmaAllocationInfo allocationResult = {};
+			if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &buffer, &allocation, &allocationResult) != VK_SUCCESS)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Instance Buffer || Create || Failed to create a instance buffer of {} bytes!\n", size);
+				buffer = VK_NULL_HANDLE; allocation = VK_NULL_HANDLE; mappedData = nullptr; capacity = 0;
+				return false;
+			}
+
+			mappedData = allocationResult.pMappedData;
+			capacity = size;
+			return true;
+		}
+
+		//destroys the buffer
+		inline void Destroy(VmaAllocator allocator)
+		{
+			if (buffer != VK_NULL_HANDLE)
+				vmaDestroyBuffer(allocator, buffer, allocation);
+
+			buffer = VK_NULL_HANDLE; allocation = VK_NULL_HANDLE; mappedData = nullptr; capacity = 0;
+		}
+
+		//makes sure the buffer can hold at least the size, the old contents are NOT kept
+		//the buffer must not be in use by the GPU when it grows
+		inline bool Reserve(VmaAllocator allocator, VkDeviceSize size)
+		{
+			if (size <= capacity)
+				return true;
+
+			//grows by doubling so a steady increase in instances doesn't reallocate every frame
+			VkDeviceSize newCapacity = (capacity > 0 ? capacity : 4096);
+			while (newCapacity < size)
+				newCapacity *= 2;
+
+			Destroy(allocator);
+			return Create(allocator, newCapacity, usage, memoryUsage);
+		}
+
+		//flushes the written range so the GPU can see it, does nothing if the memory is coherent
+		inline void Flush(VmaAllocator allocator, VkDeviceSize offset, VkDeviceSize size)
+		{
+			vmaFlushAllocation(allocator, allocation, offset, size);
+		}
+
+		//invalidates a range so the CPU sees what the GPU wrote, does nothing if the memory is coherent
+		inline void Invalidate(VmaAllocator allocator, VkDeviceSize offset, VkDeviceSize size)
+		{
+			vmaInvalidateAllocation(allocator, allocation, offset, size);
+		}
+	};
+}
\ No newline at end of file
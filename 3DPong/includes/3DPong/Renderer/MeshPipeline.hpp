@@ -0,0 +1,176 @@
+#pragma once
+
+//defines the mesh pipeline, built from the pipeline and layout assets and shared through the registry when the same state was already made
+
+#include <3DPong/Engine.hpp>
+#include <3DPong/Renderer/MeshRenderer.hpp>
+#include <3DPong/Renderer/PipelineRegistry.hpp>
+
+#include <Smok/Assets/AssetManager.hpp>
+#include <Smok/Assets/Mesh.hpp>
+
+namespace Pong3D::Renderer
+{
+	//defines the files a pipeline is made from, hashed with the rest of its state to find pipelines that are the same
+	struct PipelineSourceFiles
+	{
+		std::string settings, pushConstant;
+		std::string vertexShader, fragmentShader;
+	};
+
+	//creates a graphics pipeline from the settings through the pipeline cache, a null cache compiles it without one
+	//the viewport and scissor are dynamic, the same as the pipelines GraphicsPipeline::Create makes
+	inline bool CreateGraphicsPipeline(Wireframe::Pipeline::GraphicsPipeline& pipeline, const Wireframe::Pipeline::PipelineSettings& settings,
+		const Wireframe::Pipeline::PipelineLayout& layout, VkRenderPass renderPass, Wireframe::Device::GPU* GPU, VkPipelineCache pipelineCache)
+	{
+		VkPipelineViewportStateCreateInfo viewportState = {};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		VkPipelineColorBlendStateCreateInfo colorBlending = {};
+		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlending.logicOpEnable = VK_FALSE;
+		colorBlending.logicOp = VK_LOGIC_OP_COPY;
+		colorBlending.attachmentCount = 1;
+		colorBlending.pAttachments = &settings._colorBlendAttachment;
+
+		const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState = {};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = 2;
+		dynamicState.pDynamicStates = dynamicStates;
+
+		VkGraphicsPipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = (uint32_t)settings._shaderStages.size();
+		pipelineInfo.pStages = settings._shaderStages.data();
+		pipelineInfo.pVertexInputState = &settings._vertexInputInfo;
+		pipelineInfo.pInputAssemblyState = &settings._inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &settings._rasterizer;
+		pipelineInfo.pMultisampleState = &settings._multisampling;
+		pipelineInfo.pDepthStencilState = &settings._depthStencil;
+		pipelineInfo.pColorBlendState = &colorBlending;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = layout.layout;
+		pipelineInfo.renderPass = renderPass;
+		pipelineInfo.subpass = 0;
+
+		if (vkCreateGraphicsPipelines(GPU->device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pipeline || CreateGraphicsPipeline || Failed to create the pipeline!\n");
+			pipeline.pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+
+		return true;
+	}
+
+	//creates the mesh pipeline and its layout, returns the ones already made if the same state was registered under another name
+	//the pipeline is compiled through the pipeline cache when one is given. Returns a empty state if it failed
+	inline PipelineState InitMeshPipeline(
+		Smok::Asset::AssetManager::Asset_PipelineLayout& pipelineLayout, Smok::Asset::AssetManager::Asset_GraphicsPipeline& pipeline,
+		const PipelineSourceFiles& sourceFiles, PipelineRegistry& pipelineRegistry,
+		Wireframe::Renderpass::Renderpass& renderpass,
+		Core::Engine* engine, VkPipelineCache pipelineCache = VK_NULL_HANDLE)
+	{
+		Wireframe::Device::GPU* GPU = &engine->GPU;
+
+		//the layout is the push constant settings and the size of the push constants
+		uint64_t layoutHash = PIPELINE_STATE_HASH_SEED;
+		if (!PipelineState_HashFile(layoutHash, sourceFiles.pushConstant))
+			return PipelineState();
+		layoutHash = PipelineState_HashValue(layoutHash, sizeof(MeshPushConstants));
+
+		//sets the vertex layout
+		Wireframe::Pipeline::VertexInputDescription vertexDescription = Smok::Asset::Mesh::Vertex::GenerateVertexInputDescription();
+		AddMeshInstanceInputDescription(vertexDescription);
+
+		//loads the shader settings
+		Wireframe::Shader::Serilize::ShaderSerilizeData vertex;
+		Wireframe::Shader::Serilize::LoadShaderDataFromFile(pipeline.vertexShaderDataSettingFile,
+			vertex, false);
+		Wireframe::Shader::Serilize::ShaderSerilizeData fragment;
+		Wireframe::Shader::Serilize::LoadShaderDataFromFile(pipeline.fragmentShaderDataSettingFile,
+			fragment, false);
+
+		//the pipeline is the settings, the SPIR-V of each stage, the vertex layout, the layout and the render pass
+		//the settings are hashed as saved, the serializer always writes them the same way
+		//the shader settings files aren't hashed, they hold the shader's name and paths which don't change the pipeline
+		uint64_t pipelineHash = layoutHash;
+		if (!PipelineState_HashFile(pipelineHash, sourceFiles.settings) ||
+			!PipelineState_HashFile(pipelineHash, vertex.binaryFilepath) ||
+			!PipelineState_HashFile(pipelineHash, fragment.binaryFilepath))
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pipeline || InitMeshPipeline || The pipeline settings or SPIR-V can't be read, the pipeline was not created!\n");
+			return PipelineState();
+		}
+		pipelineHash = PipelineState_HashBytes(pipelineHash, vertexDescription.bindings.data(), vertexDescription.bindings.size() * sizeof(VkVertexInputBindingDescription));
+		pipelineHash = PipelineState_HashBytes(pipelineHash, vertexDescription.attributes.data(), vertexDescription.attributes.size() * sizeof(VkVertexInputAttributeDescription));
+		pipelineHash = PipelineState_HashValue(pipelineHash, renderpass._renderPass);
+
+		//the same state was already created under another name
+		PipelineState state = pipelineRegistry.FindPipeline(pipelineHash);
+		if (state.pipeline)
+			return state;
+
+		//generates a layout and the push constants
+		state.layout = pipelineRegistry.FindLayout(layoutHash);
+		if (!state.layout)
+		{
+			Wireframe::Pipeline::PipelineLayout_CreateInfo pipelineLayoutInfo;
+			Wireframe::Pipeline::PushConstant p;
+			Wireframe::Pipeline::Serilize::LoadPipelineLayoutPushConstantDataFromFile(pipelineLayout.pushConstantDataSettingFile,
+				p);
+			p.size = sizeof(MeshPushConstants);
+			pipelineLayoutInfo.pushConstants.emplace_back(p);
+
+			pipelineLayout.asset.Create(pipelineLayoutInfo, GPU);
+			pipelineLayout.assetIsCreated = true;
+			state.layout = &pipelineLayout.asset;
+			pipelineRegistry.RegisterLayout(layoutHash, state.layout);
+		}
+
+		//loads a pipeline settings
+		Wireframe::Pipeline::PipelineSettings pipelineSettings;
+		Wireframe::Pipeline::Serilize::LoadPipelineSettingsDataFromFile(pipeline.pipelineDataSettingFile, pipelineSettings);
+
+		pipelineSettings._vertexInputInfo.pVertexAttributeDescriptions = vertexDescription.attributes.data();
+		pipelineSettings._vertexInputInfo.vertexAttributeDescriptionCount = vertexDescription.attributes.size();
+		pipelineSettings._vertexInputInfo.pVertexBindingDescriptions = vertexDescription.bindings.data();
+		pipelineSettings._vertexInputInfo.vertexBindingDescriptionCount = vertexDescription.bindings.size();
+
+		//loads the shaders
+		Wireframe::Shader::ShaderModule meshVertShader;
+		if (!meshVertShader.Create(vertex.binaryFilepath.c_str(), GPU))
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pipeline || InitMeshPipeline || Failed to load \"{}\", the pipeline was not created!\n", vertex.binaryFilepath);
+			return PipelineState();
+		}
+
+		Wireframe::Shader::ShaderModule meshFragShader;
+		if (!meshFragShader.Create(fragment.binaryFilepath.c_str(), GPU))
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pipeline || InitMeshPipeline || Failed to load \"{}\", the pipeline was not created!\n", fragment.binaryFilepath);
+			meshVertShader.Destroy(GPU);
+			return PipelineState();
+		}
+
+		pipelineSettings._shaderStages = { Wireframe::Shader::GenerateShaderStageInfoForPipeline(meshVertShader, Wireframe::Shader::Util::ShaderStage::Vertex),
+			Wireframe::Shader::GenerateShaderStageInfoForPipeline(meshFragShader, Wireframe::Shader::Util::ShaderStage::Fragment) };
+
+		//the modules are only needed while the pipeline is compiled
+		const bool pipelineIsCreated = CreateGraphicsPipeline(pipeline.asset, pipelineSettings, *state.layout, renderpass._renderPass, GPU, pipelineCache);
+		meshFragShader.Destroy(GPU);
+		meshVertShader.Destroy(GPU);
+		if (!pipelineIsCreated)
+			return PipelineState();
+
+		pipeline.assetIsCreated = true;
+		state.pipeline = &pipeline.asset;
+		pipelineRegistry.RegisterPipeline(pipelineHash, state);
+
+		return state;
+	}
+}
@@ -0,0 +1,602 @@
+#pragma once
+
+//defines a pool of mesh geometry, every mesh's vertices and indices are sub allocated out of one device local buffer per kind
+//and the upload batcher that fills it through a single staging buffer, recording every copy into one transfer submission
+
+#include <3DPong/Assets/BinaryMesh.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+#include <3DPong/Renderer/InstanceBuffer.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <deque>
+#include <functional>
+
+namespace Pong3D::Renderer
+{
+	struct MeshPool;
+
+	//defines a sub mesh in the pool, the first index is into the pool's index buffer
+	struct PooledSubMesh
+	{
+		uint32_t firstIndex = 0, indexCount = 0;
+	};
+
+	//defines a mesh in the pool, its indices are relative to its vertex offset
+	struct PooledMesh
+	{
+		MeshPool* pool = nullptr;
+
+		int32_t vertexOffset = 0;
+		uint32_t vertexCount = 0;
+
+		//every sub mesh's indices are next to each other, so the whole mesh can be drawn at once
+		uint32_t firstIndex = 0, indexCount = 0;
+		std::vector<PooledSubMesh> subMeshes;
+
+		glm::vec4 boundingSphere = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f); //local space center and radius, a negative radius is never culled
+
+		bool isResident = false; //set once the upload that holds it has finished
+	};
+
+	//defines a freed range of vertices or indices in a pool
+	struct MeshPoolRange
+	{
+		uint32_t first = 0, count = 0;
+	};
+
+	//defines a pool of geometry that shares a vertex layout and index type
+	struct MeshPool
+	{
+		InstanceBuffer vertexBuffer; //GPU only
+		InstanceBuffer indexBuffer; //GPU only
+
+		uint32_t vertexStride = 0;
+		VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+
+		uint32_t vertexCapacity = 0, indexCapacity = 0;
+		uint32_t usedVertices = 0, usedIndices = 0; //the end of the space handed out, freed space before it is in the free ranges
+		std::vector<MeshPoolRange> freeVertexRanges, freeIndexRanges; //sorted by first, never next to each other or the end
+
+		std::deque<PooledMesh> meshes; //a deque so the meshes never move
+		std::vector<PooledMesh*> freeMeshes; //freed meshes, handed out again before a new one is made
+
+		//the size of a index in bytes
+		inline uint32_t IndexSize() const { return (indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4); }
+
+		//creates the pool
+		inline bool Create(VmaAllocator allocator, uint32_t _vertexStride, uint32_t maxVertices, uint32_t maxIndices, VkIndexType _indexType = VK_INDEX_TYPE_UINT32)
+		{
+			vertexStride = _vertexStride;
+			indexType = _indexType;
+			vertexCapacity = maxVertices;
+			indexCapacity = maxIndices;
+			usedVertices = 0; usedIndices = 0;
+
+			if (!vertexBuffer.Create(allocator, (VkDeviceSize)maxVertices * vertexStride, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY) ||
+				!indexBuffer.Create(allocator, (VkDeviceSize)maxIndices * IndexSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pool || Create || Failed to create the pool buffers!\n");
+				Destroy(allocator);
+				return false;
+			}
+
+			return true;
+		}
+
+		//destroys the pool, the GPU must be done with it
+		inline void Destroy(VmaAllocator allocator)
+		{
+			vertexBuffer.Destroy(allocator);
+			indexBuffer.Destroy(allocator);
+			meshes.clear();
+			freeMeshes.clear();
+			usedVertices = 0; usedIndices = 0;
+			freeVertexRanges.clear(); freeIndexRanges.clear();
+		}
+
+		//takes a range out of the first freed range it fits in, or off the end
+		static inline bool TakeRange(std::vector<MeshPoolRange>& freeRanges, uint32_t& used, uint32_t capacity, uint32_t count, uint32_t& first)
+		{
+			for (size_t i = 0; i < freeRanges.size(); ++i)
+			{
+				if (freeRanges[i].count < count)
+					continue;
+
+				first = freeRanges[i].first;
+				freeRanges[i].first += count;
+				freeRanges[i].count -= count;
+				if (freeRanges[i].count == 0)
+					freeRanges.erase(freeRanges.begin() + i);
+				return true;
+			}
+
+			if (used + count > capacity)
+				return false;
+			first = used;
+			used += count;
+			return true;
+		}
+
+		//gives a range back, merging it with its neighbours and pulling the end back if it's the last one handed out
+		static inline void ReturnRange(std::vector<MeshPoolRange>& freeRanges, uint32_t& used, uint32_t first, uint32_t count)
+		{
+			if (count == 0)
+				return;
+
+			size_t i = 0;
+			while (i < freeRanges.size() && freeRanges[i].first < first)
+				++i;
+			freeRanges.insert(freeRanges.begin() + i, MeshPoolRange{ first, count });
+
+			if (i + 1 < freeRanges.size() && freeRanges[i].first + freeRanges[i].count == freeRanges[i + 1].first)
+			{
+				freeRanges[i].count += freeRanges[i + 1].count;
+				freeRanges.erase(freeRanges.begin() + i + 1);
+			}
+			if (i > 0 && freeRanges[i - 1].first + freeRanges[i - 1].count == freeRanges[i].first)
+			{
+				freeRanges[i - 1].count += freeRanges[i].count;
+				freeRanges.erase(freeRanges.begin() + i);
+			}
+
+			if (!freeRanges.empty() && freeRanges.back().first + freeRanges.back().count == used)
+			{
+				used = freeRanges.back().first;
+				freeRanges.pop_back();
+			}
+		}
+
+		//reserves a mesh without any space, used to hand out a mesh before its size is known
+		//it's not resident and draws nothing until space is allocated for it and it's uploaded
+		inline PooledMesh* ReserveMesh()
+		{
+			PooledMesh* mesh = nullptr;
+			if (!freeMeshes.empty())
+			{
+				mesh = freeMeshes.back();
+				freeMeshes.pop_back();
+				*mesh = PooledMesh();
+			}
+			else
+				mesh = &meshes.emplace_back(PooledMesh());
+			mesh->pool = this;
+			return mesh;
+		}
+
+		//allocates the space of a reserved mesh, returns false if the pool is full
+		inline bool AllocateSpace(PooledMesh* mesh, uint32_t vertexCount, uint32_t indexCount)
+		{
+			uint32_t firstVertex = 0, firstIndex = 0;
+			if (!TakeRange(freeVertexRanges, usedVertices, vertexCapacity, vertexCount, firstVertex))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pool || AllocateSpace || The pool is out of space for {} vertices and {} indices, create a bigger one!\n",
+					vertexCount, indexCount);
+				return false;
+			}
+			if (!TakeRange(freeIndexRanges, usedIndices, indexCapacity, indexCount, firstIndex))
+			{
+				ReturnRange(freeVertexRanges, usedVertices, firstVertex, vertexCount);
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Pool || AllocateSpace || The pool is out of space for {} vertices and {} indices, create a bigger one!\n",
+					vertexCount, indexCount);
+				return false;
+			}
+
+			mesh->vertexOffset = (int32_t)firstVertex;
+			mesh->vertexCount = vertexCount;
+			mesh->firstIndex = firstIndex;
+			mesh->indexCount = indexCount;
+			return true;
+		}
+
+		//frees the space of a mesh, the mesh stays reserved and draws nothing. The GPU must be done drawing it
+		inline void FreeSpace(PooledMesh* mesh)
+		{
+			ReturnRange(freeVertexRanges, usedVertices, (uint32_t)mesh->vertexOffset, mesh->vertexCount);
+			ReturnRange(freeIndexRanges, usedIndices, mesh->firstIndex, mesh->indexCount);
+
+			mesh->vertexOffset = 0; mesh->vertexCount = 0;
+			mesh->firstIndex = 0; mesh->indexCount = 0;
+			mesh->subMeshes.clear();
+			mesh->isResident = false;
+		}
+
+		//frees a mesh and its space, it's handed out again by the next ReserveMesh
+		//the GPU must be done drawing it and nothing can still be holding it
+		inline void Free(PooledMesh* mesh)
+		{
+			FreeSpace(mesh);
+			freeMeshes.emplace_back(mesh);
+		}
+
+		//reserves a mesh and its space, returns nullptr if the pool is full
+		inline PooledMesh* Allocate(uint32_t vertexCount, uint32_t indexCount)
+		{
+			PooledMesh* mesh = ReserveMesh();
+			if (!AllocateSpace(mesh, vertexCount, indexCount))
+			{
+				freeMeshes.emplace_back(mesh);
+				return nullptr;
+			}
+			return mesh;
+		}
+
+		//binds the vertex and index buffers, every mesh in the pool is drawn from them
+		inline void Bind(VkCommandBuffer& cmd) const
+		{
+			const VkDeviceSize offset = 0;
+			vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer.buffer, &offset);
+			vkCmdBindIndexBuffer(cmd, indexBuffer.buffer, 0, indexType);
+		}
+	};
+
+	//defines the stats of the uploads
+	struct MeshUploadStats
+	{
+		uint64_t meshes = 0;
+		uint64_t bytes = 0;
+		uint64_t copyRegions = 0;
+		uint64_t submissions = 0;
+	};
+
+	//defines how far a mesh queued a part at a time has got
+	struct MeshUploadProgress
+	{
+		VkDeviceSize vertexBytes = 0, indexBytes = 0; //staged so far
+		bool isAllocated = false; //its space is allocated in the pool
+		bool isQueued = false; //every part is staged
+	};
+
+	//defines a upload batcher, copies are staged and recorded together and sent in one submission with one fence
+	//a staging buffer too small for everything is submitted and reused as often as needed
+	struct MeshUploadBatcher
+	{
+		Wireframe::Device::GPU* GPU = nullptr;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		InstanceBuffer stagingBuffer;
+		VkDeviceSize stagingHead = 0;
+
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		VkCommandBuffer cmd = VK_NULL_HANDLE;
+		VkFence fence = VK_NULL_HANDLE;
+
+		//the copies waiting for the next submission, grouped by the buffer they write
+		std::vector<VkBufferCopy> vertexCopies, indexCopies;
+		MeshPool* pendingPool = nullptr;
+		std::vector<PooledMesh*> pendingMeshes;
+
+		//the submission the GPU is working on, the staging buffer can't be written until it's finished
+		bool submitIsInFlight = false;
+		std::vector<PooledMesh*> inFlightMeshes;
+
+		MeshUploadStats stats;
+
+		//creates the batcher
+		inline bool Init(Wireframe::Device::GPU* _GPU, VmaAllocator _allocator, VkDeviceSize stagingSize = 16 * 1024 * 1024)
+		{
+			GPU = _GPU;
+			allocator = _allocator;
+
+			if (!stagingBuffer.Create(allocator, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY))
+				return false;
+
+			VkCommandPoolCreateInfo poolInfo = {};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			poolInfo.queueFamilyIndex = GPU->graphicsQueueFamily;
+			VK_CHECK(vkCreateCommandPool(GPU->device, &poolInfo, nullptr, &commandPool));
+
+			VkCommandBufferAllocateInfo cmdInfo = {};
+			cmdInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			cmdInfo.commandPool = commandPool;
+			cmdInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			cmdInfo.commandBufferCount = 1;
+			VK_CHECK(vkAllocateCommandBuffers(GPU->device, &cmdInfo, &cmd));
+
+			VkFenceCreateInfo fenceInfo = {};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			VK_CHECK(vkCreateFence(GPU->device, &fenceInfo, nullptr, &fence));
+
+			return true;
+		}
+
+		//destroys the batcher, anything still staged is submitted first
+		inline void Destroy()
+		{
+			if (GPU)
+			{
+				Submit();
+				FinishSubmit(true);
+				if (fence != VK_NULL_HANDLE) vkDestroyFence(GPU->device, fence, nullptr);
+				if (commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(GPU->device, commandPool, nullptr);
+			}
+			stagingBuffer.Destroy(allocator);
+
+			fence = VK_NULL_HANDLE; commandPool = VK_NULL_HANDLE; cmd = VK_NULL_HANDLE;
+			GPU = nullptr;
+		}
+
+		//stages a write into a pool buffer, the writer fills the staging memory a chunk at a time
+		//chunks are split whenever the staging buffer fills up, which submits what's been staged so far
+		//if it can't submit it stops there, written is how much was staged and the write carries on from it on the next call
+		inline bool Stage(MeshPool* pool, std::vector<VkBufferCopy>& copies, VkDeviceSize dstOffset, VkDeviceSize size, VkDeviceSize chunkAlignment,
+			VkDeviceSize& written, bool canSubmit,
+			const std::function<void(uint8_t* dst, VkDeviceSize srcOffset, VkDeviceSize byteCount)>& writer)
+		{
+			while (written < size)
+			{
+				VkDeviceSize space = stagingBuffer.capacity - stagingHead;
+				if (space < chunkAlignment)
+				{
+					if (!canSubmit)
+						return true;
+					if (!Submit(pool))
+						return false;
+					pendingPool = pool;
+					space = stagingBuffer.capacity;
+				}
+
+				VkDeviceSize chunk = (size - written < space ? size - written : space);
+				chunk -= chunk % chunkAlignment; //never splits a vertex or index
+
+				writer((uint8_t*)stagingBuffer.mappedData + stagingHead, written, chunk);
+
+				VkBufferCopy copy = {};
+				copy.srcOffset = stagingHead;
+				copy.dstOffset = dstOffset + written;
+				copy.size = chunk;
+				copies.emplace_back(copy);
+
+				stagingHead = (stagingHead + chunk + 15) & ~(VkDeviceSize)15;
+				written += chunk;
+				stats.bytes += chunk;
+			}
+
+			return true;
+		}
+
+		//gets how much of the staging buffer a mesh needs
+		static inline VkDeviceSize GetStagingSize(const MeshPool* pool, const Asset::BinaryMeshView& source)
+		{
+			return source.header->vertexDataSize + (VkDeviceSize)source.header->totalIndexCount * pool->IndexSize() + 32;
+		}
+
+		//can this much be staged without submitting or waiting on the GPU
+		inline bool CanStage(VkDeviceSize size) const { return !submitIsInFlight && stagingHead + size <= stagingBuffer.capacity; }
+
+		//is a submission waiting on the GPU
+		inline bool IsSubmitInFlight() const { return submitIsInFlight; }
+
+		//queues a binary mesh to be uploaded into a pool, returns nullptr if it doesn't fit
+		//the mesh isn't resident until the next Submit, every mesh queued before then goes in the same submission
+		inline PooledMesh* QueueMesh(MeshPool* pool, const Asset::BinaryMeshView& source)
+		{
+			PooledMesh* mesh = pool->ReserveMesh();
+			if (!QueueMeshInto(pool, mesh, source))
+			{
+				pool->Free(mesh);
+				return nullptr;
+			}
+			return mesh;
+		}
+
+		//queues a binary mesh to be uploaded into a mesh reserved in the pool, returns false if it doesn't fit
+		//a mesh bigger than the staging buffer is split across submissions and this waits on them
+		inline bool QueueMeshInto(MeshPool* pool, PooledMesh* mesh, const Asset::BinaryMeshView& source)
+		{
+			MeshUploadProgress progress;
+			return QueueMeshPart(pool, mesh, source, progress, true);
+		}
+
+		//queues as much of a binary mesh as fits in what's left of the staging buffer, returns false if it failed and gives the space back
+		//the mesh is queued once progress.isQueued is set, until then call it again with the same progress after the next upload finishes
+		//nothing is submitted unless canSubmit is set, so a mesh bigger than the staging buffer can be spread over frames
+		inline bool QueueMeshPart(MeshPool* pool, PooledMesh* mesh, const Asset::BinaryMeshView& source, MeshUploadProgress& progress, bool canSubmit = false)
+		{
+			//the staging buffer is still being read by the last submission
+			if (submitIsInFlight)
+				FinishSubmit(true);
+
+			const Asset::BinaryMeshHeader* header = source.header;
+			if (progress.isAllocated)
+				return StageMeshPart(pool, mesh, source, progress, canSubmit);
+
+			if (header->vertexStride != pool->vertexStride)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Upload Batcher || QueueMesh || The mesh has {} byte vertices but the pool holds {} byte ones!\n",
+					header->vertexStride, pool->vertexStride);
+				return false;
+			}
+			if (pool->indexType == VK_INDEX_TYPE_UINT16 && header->vertexCount > UINT16_MAX + 1)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Mesh Upload Batcher || QueueMesh || The mesh has {} vertices, too many for a 16 bit pool!\n", header->vertexCount);
+				return false;
+			}
+
+			if (!pool->AllocateSpace(mesh, header->vertexCount, header->totalIndexCount))
+				return false;
+			progress.isAllocated = true;
+
+			mesh->subMeshes.resize(header->subMeshCount);
+			for (uint32_t i = 0; i < header->subMeshCount; ++i)
+			{
+				mesh->subMeshes[i].firstIndex = mesh->firstIndex + source.subMeshes[i].firstIndex;
+				mesh->subMeshes[i].indexCount = source.subMeshes[i].indexCount;
+			}
+			mesh->boundingSphere = glm::vec4(header->sphere[0], header->sphere[1], header->sphere[2], header->sphere[3]);
+
+			return StageMeshPart(pool, mesh, source, progress, canSubmit);
+		}
+
+		//stages the rest of a mesh that has its space, the vertices then the indices
+		inline bool StageMeshPart(MeshPool* pool, PooledMesh* mesh, const Asset::BinaryMeshView& source, MeshUploadProgress& progress, bool canSubmit)
+		{
+			const Asset::BinaryMeshHeader* header = source.header;
+
+			//a batch only writes one pool
+			if (pendingPool && pendingPool != pool && !Submit())
+			{
+				RollbackMesh(pool, mesh, vertexCopies.size(), indexCopies.size(), stats.submissions);
+				progress = MeshUploadProgress();
+				return false;
+			}
+			pendingPool = pool;
+
+			//where this part's copies start, so a failed stage can take them back out
+			const size_t firstVertexCopy = vertexCopies.size(), firstIndexCopy = indexCopies.size();
+			const uint64_t submissionsBefore = stats.submissions;
+
+			//the vertices go straight across
+			const uint8_t* vertexData = source.vertexData;
+			if (!Stage(pool, vertexCopies, (VkDeviceSize)mesh->vertexOffset * pool->vertexStride, header->vertexDataSize, pool->vertexStride,
+				progress.vertexBytes, canSubmit, [vertexData](uint8_t* dst, VkDeviceSize srcOffset, VkDeviceSize byteCount) { memcpy(dst, vertexData + srcOffset, byteCount); }))
+			{
+				RollbackMesh(pool, mesh, firstVertexCopy, firstIndexCopy, submissionsBefore);
+				progress = MeshUploadProgress();
+				return false;
+			}
+			if (progress.vertexBytes < header->vertexDataSize)
+				return true;
+
+			//the indices go straight across when the sizes match, otherwise they're converted as they're staged
+			const uint8_t* indexData = source.indexData;
+			const uint32_t srcIndexSize = source.IndexSize(), dstIndexSize = pool->IndexSize();
+			bool staged = false;
+			if (srcIndexSize == dstIndexSize)
+			{
+				staged = Stage(pool, indexCopies, (VkDeviceSize)mesh->firstIndex * dstIndexSize, header->indexDataSize, dstIndexSize,
+					progress.indexBytes, canSubmit, [indexData](uint8_t* dst, VkDeviceSize srcOffset, VkDeviceSize byteCount) { memcpy(dst, indexData + srcOffset, byteCount); });
+			}
+			else
+			{
+				staged = Stage(pool, indexCopies, (VkDeviceSize)mesh->firstIndex * dstIndexSize, (VkDeviceSize)header->totalIndexCount * dstIndexSize, dstIndexSize,
+					progress.indexBytes, canSubmit, [indexData, srcIndexSize, dstIndexSize](uint8_t* dst, VkDeviceSize dstOffset, VkDeviceSize byteCount) {
+						const size_t first = (size_t)(dstOffset / dstIndexSize), count = (size_t)(byteCount / dstIndexSize);
+						for (size_t i = 0; i < count; ++i)
+						{
+							const uint32_t index = (srcIndexSize == 2 ? ((const uint16_t*)indexData)[first + i] : ((const uint32_t*)indexData)[first + i]);
+							if (dstIndexSize == 2)
+								((uint16_t*)dst)[i] = (uint16_t)index;
+							else
+								((uint32_t*)dst)[i] = index;
+						}
+					});
+			}
+			if (!staged)
+			{
+				RollbackMesh(pool, mesh, firstVertexCopy, firstIndexCopy, submissionsBefore);
+				progress = MeshUploadProgress();
+				return false;
+			}
+			if (progress.indexBytes < (VkDeviceSize)header->totalIndexCount * dstIndexSize)
+				return true;
+
+			//it's resident after the submission holding its last part
+			pendingMeshes.emplace_back(mesh);
+			progress.isQueued = true;
+			stats.meshes++;
+			return true;
+		}
+
+		//takes a mesh that failed to stage back out of the batch and gives its space back to the pool
+		//copies already submitted land in space that's free again, anything that reuses it is uploaded after them
+		inline void RollbackMesh(MeshPool* pool, PooledMesh* mesh, size_t firstVertexCopy, size_t firstIndexCopy, uint64_t submissionsBefore)
+		{
+			//a submit part way through sent the copies before it, so everything still pending is this mesh's
+			if (stats.submissions != submissionsBefore)
+				firstVertexCopy = firstIndexCopy = 0;
+			if (vertexCopies.size() > firstVertexCopy)
+				vertexCopies.resize(firstVertexCopy);
+			if (indexCopies.size() > firstIndexCopy)
+				indexCopies.resize(firstIndexCopy);
+
+			pool->FreeSpace(mesh);
+		}
+
+		//records every staged copy into one command buffer, submits it and waits on its fence
+		//pool is the pool being written, defaults to the one the queued meshes are in
+		inline bool Submit(MeshPool* pool = nullptr)
+		{
+			if (!SubmitAsync(pool))
+				return false;
+			return FinishSubmit(true);
+		}
+
+		//records every staged copy into one command buffer and submits it without waiting, FinishSubmit checks on it
+		inline bool SubmitAsync(MeshPool* pool = nullptr)
+		{
+			if (!pool)
+				pool = pendingPool;
+			if (!pool || (vertexCopies.empty() && indexCopies.empty()))
+				return true;
+			PONG3D_PROFILE_ZONE("Submit Mesh Uploads");
+			if (submitIsInFlight)
+				FinishSubmit(true);
+
+			VK_CHECK(vkResetCommandBuffer(cmd, 0));
+			VkCommandBufferBeginInfo beginInfo = {};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+			if (!vertexCopies.empty())
+				vkCmdCopyBuffer(cmd, stagingBuffer.buffer, pool->vertexBuffer.buffer, (uint32_t)vertexCopies.size(), vertexCopies.data());
+			if (!indexCopies.empty())
+				vkCmdCopyBuffer(cmd, stagingBuffer.buffer, pool->indexBuffer.buffer, (uint32_t)indexCopies.size(), indexCopies.data());
+
+			//the copies have to land before any draw reads them
+			VkMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			VK_CHECK(vkEndCommandBuffer(cmd));
+
+			VkSubmitInfo submit = {};
+			submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submit.commandBufferCount = 1;
+			submit.pCommandBuffers = &cmd;
+			VK_CHECK(vkQueueSubmit(GPU->graphicsQueue, 1, &submit, fence));
+			submitIsInFlight = true;
+
+			stats.copyRegions += vertexCopies.size() + indexCopies.size();
+			stats.submissions++;
+			vertexCopies.clear();
+			indexCopies.clear();
+
+			//a mesh split across submissions is only resident after the last one, which is this one if it's still pending
+			inFlightMeshes.insert(inFlightMeshes.end(), pendingMeshes.begin(), pendingMeshes.end());
+			pendingMeshes.clear();
+			if (pool == pendingPool)
+				pendingPool = nullptr;
+
+			return true;
+		}
+
+		//finishes the submission in flight, marking its meshes resident and freeing the staging buffer
+		//returns false if the GPU isn't done with it yet and wait is false
+		inline bool FinishSubmit(bool wait)
+		{
+			if (!submitIsInFlight)
+				return true;
+
+			if (wait)
+			{
+				PONG3D_PROFILE_ZONE("Mesh Upload Wait");
+				VK_CHECK(vkWaitForFences(GPU->device, 1, &fence, true, UINT64_MAX));
+			}
+			else if (vkGetFenceStatus(GPU->device, fence) != VK_SUCCESS)
+				return false;
+			VK_CHECK(vkResetFences(GPU->device, 1, &fence));
+
+			for (size_t i = 0; i < inFlightMeshes.size(); ++i)
+				inFlightMeshes[i]->isResident = true;
+			inFlightMeshes.clear();
+			stagingHead = 0;
+			submitIsInFlight = false;
+			return true;
+		}
+	};
+}
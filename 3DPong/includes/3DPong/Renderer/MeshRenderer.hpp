@@ -2,13 +2,22 @@
 
 //defines a mesh renderer
 
+#include <3DPong/Renderer/FrameConstants.hpp>
+#include <3DPong/Renderer/FrustumCulling.hpp>
+#include <3DPong/Renderer/GPUCulling.hpp>
+#include <3DPong/Renderer/InstanceBuffer.hpp>
+#include <3DPong/Renderer/MeshPool.hpp>
+#include <3DPong/Renderer/RenderSortKey.hpp>
+#include <3DPong/Memory/FrameArena.hpp>
+
 #include <BTDSTD/Wireframe/Pipeline/GraphicsPipeline.hpp>
 
-#include <Smok/Assets/Mesh.hpp>
 #include <Smok/Components/Camera.hpp>
 #include <Smok/Components/Transform.hpp>
 
+#include <algorithm>
 #include <deque>
+#include <unordered_map>
 
 namespace Pong3D::Renderer
 {
@@ -18,6 +27,39 @@ namespace Pong3D::Renderer
 		alignas(16) glm::vec4 color = glm::vec4(200.0f, 0.0f, 215.0f, 255.0f);
 	};
 
+	//defines the per instance data streamed to the GPU
+	struct MeshInstanceData
+	{
+		glm::mat4 modelMatrix = glm::mat4(1.0f);
+	};
+
+	//the vertex binding the instance data is read from, binding 0 is the mesh vertices
+	static constexpr uint32_t MESH_INSTANCE_BINDING = 1;
+
+	//the first shader location of the instance data, must match mesh.vert
+	static constexpr uint32_t MESH_INSTANCE_FIRST_LOCATION = 4;
+
+	//adds the per instance binding and attributes to a vertex description
+	inline void AddMeshInstanceInputDescription(Wireframe::Pipeline::VertexInputDescription& description)
+	{
+		VkVertexInputBindingDescription binding = {};
+		binding.binding = MESH_INSTANCE_BINDING;
+		binding.stride = sizeof(MeshInstanceData);
+		binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+		description.bindings.emplace_back(binding);
+
+		//a mat4 is passed as 4 vec4 columns
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			VkVertexInputAttributeDescription attribute = {};
+			attribute.binding = MESH_INSTANCE_BINDING;
+			attribute.location = MESH_INSTANCE_FIRST_LOCATION + i;
+			attribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attribute.offset = offsetof(MeshInstanceData, modelMatrix) + sizeof(glm::vec4) * i;
+			description.attributes.emplace_back(attribute);
+		}
+	}
+
 	//defines a draw call
 	struct DrawCallOp
 	{
@@ -27,91 +69,661 @@ namespace Pong3D::Renderer
 	//defines a static mesh render operation
 	struct RenderOperation_StaticMesh
 	{
-		uint64_t meshPipelineLayoutIndex = 0, meshPipelineIndex, meshIndex;
+		uint32_t meshPipelineLayoutIndex = 0, meshPipelineIndex = 0, meshIndex = 0;
+		uint64_t stateSortKey = 0; //the pipeline | layout | mesh part of the sort key, the depth is added when the draw list is compiled
+
+		uint64_t entityID = 0; //the entity this draw belongs to
+		uint32_t instanceIndex = 0; //where the draw's instance data lives in the instance buffers
 
-		std::vector<DrawCallOp> ops;
+		DrawCallOp op;
+	};
+
+	//defines what needs to be written into a frame's instance buffer the next time that frame is recorded
+	struct InstanceUploadState
+	{
+		bool needsFullUpload = true; //the draw list was recompiled, every instance moves
+		std::vector<uint32_t> pendingInstances; //the instances that changed since this frame was last recorded
+	};
+
+	//defines the stats of the last render
+	struct RenderOperationBatchStats
+	{
+		uint64_t drawCalls = 0; //how many draw commands were recorded
+		uint64_t instances = 0; //how many instances were drawn
+		uint64_t instancesWritten = 0; //how many instances were written into the instance buffer
+
+		//how many times state was bound
+		uint64_t pipelineBinds = 0;
+		uint64_t vertexBufferBinds = 0;
+		uint64_t indexBufferBinds = 0;
+
+		//CPU culling, how many instances survived and were culled this frame
+		uint64_t visibleInstances = 0;
+		uint64_t culledInstances = 0;
+
+		//GPU driven rendering, how many instances survived the GPU cull. Read back a few frames late
+		uint64_t gpuVisibleInstances = 0;
+		bool gpuVisibleInstancesIsValid = false;
+
+		//adds the recording counts of another set of stats, used to merge the stats of several threads
+		inline void AddRecordCounts(const RenderOperationBatchStats& other)
+		{
+			drawCalls += other.drawCalls;
+			pipelineBinds += other.pipelineBinds;
+			vertexBufferBinds += other.vertexBufferBinds;
+			indexBufferBinds += other.indexBufferBinds;
+		}
+	};
+
+	//defines a run of draws that share the same state, recorded as one instanced draw of the whole mesh
+	struct DrawRun
+	{
+		uint64_t state = 0; //the sort key without the depth
+		uint32_t firstInstance = 0, instanceCount = 0;
+		uint32_t command = 0; //the indirect command of the run
+
+		//the instances of the run that survived the CPU cull this frame, packed together in the frame's instance buffer
+		uint32_t firstVisibleInstance = 0, visibleInstanceCount = 0;
 	};
 
 	//defines a batch
 	struct RenderOperationBatch
 	{
-		//asstes
-		std::deque<Wireframe::Pipeline::PipelineLayout*> pipelineLayouts;
-		std::deque<Wireframe::Pipeline::GraphicsPipeline*> pipelines;
-		std::deque<Smok::Asset::Mesh::StaticMesh*> staticMeshes;
+		//interned asstes, each asset is stored once and referenced by index in the sort keys
+		std::vector<Wireframe::Pipeline::PipelineLayout*> pipelineLayouts;
+		std::vector<Wireframe::Pipeline::GraphicsPipeline*> pipelines;
+		std::vector<PooledMesh*> staticMeshes;
+
+		std::unordered_map<Wireframe::Pipeline::PipelineLayout*, uint32_t> pipelineLayoutLookup;
+		std::unordered_map<Wireframe::Pipeline::GraphicsPipeline*, uint32_t> pipelineLookup;
+		std::unordered_map<PooledMesh*, uint32_t> staticMeshLookup;
+
+		//meshes still streaming in are drawn as the placeholder, or skipped if there isn't a resident one
+		PooledMesh* placeholderMesh = nullptr;
+		uint32_t nonResidentMeshCount = 0; //as of the last compile, the draw list is compiled again when one becomes resident
 
 		//render operations
 		std::deque<RenderOperation_StaticMesh> renderOperations_staticMesh;
+		std::unordered_map<uint64_t, uint32_t> entityLookup; //maps a entity ID to its render operation
 
-		//adds a static mesh
-		inline RenderOperation_StaticMesh* AddStaticMesh(Wireframe::Pipeline::PipelineLayout* layout, Wireframe::Pipeline::GraphicsPipeline* pipeline, Smok::Asset::Mesh::StaticMesh* mesh,
-			Smok::ECS::Comp::Transform& entityTransform)
+		//the compiled draw list, rebuilt and sorted when operations are added. Kept around so the memory is reused
+		//the sort's scratch only lives for the compile, it comes from the frame's arena
+		bool drawListIsDirty = true;
+		std::vector<SortedDrawItem> drawList;
+		std::vector<DrawRun> drawRuns;
+		uint32_t drawCommandCount = 0; //one per run
+
+		//the instance data for each frame in flight, a slot is only written once the GPU is done with it
+		//instances stay at the same index between compiles so changed transforms are written in place
+		VmaAllocator allocator = VK_NULL_HANDLE;
+		std::vector<InstanceBuffer> instanceBuffers;
+		std::vector<InstanceUploadState> instanceUploadStates;
+
+		RenderOperationBatchStats stats;
+		bool isReadyToRecord = false; //set by PrepareRender, false if the batch has nothing to record this frame
+
+		//GPU driven rendering, optional. The GPU culls the instances and the draws are indirect
+		GPUCullingPass* gpuCulling = nullptr;
+		std::vector<GPUCullingFrameData> gpuCullingFrames;
+
+		//CPU culling, optional. Only the visible instances are written into the frame's instance buffer, packed run by run so each run is still one draw
+		//ignored when the GPU driven path is enabled since it culls on its own
+		bool CPUCullingIsEnabled = false;
+		float maxDrawDistance = 0.0f; //0 or less disables distance culling
+		std::vector<glm::vec4> instanceLocalSpheres; //the local sphere of each instance, in draw list order
+		BoundingSphereSoA instanceWorldSpheres; //the world sphere of each instance, in draw list order
+
+		//creates the per frame instance buffers
+		inline void InitInstanceBuffers(VmaAllocator _allocator, uint32_t framesInFlight)
 		{
-			RenderOperation_StaticMesh* op = &renderOperations_staticMesh.emplace_back(RenderOperation_StaticMesh());
+			allocator = _allocator;
+			instanceBuffers.resize(framesInFlight);
+			instanceUploadStates.resize(framesInFlight);
+		}
+
+		//enables CPU frustum and distance culling, call after InitInstanceBuffers
+		inline void EnableCPUCulling(float _maxDrawDistance = 0.0f)
+		{
+			CPUCullingIsEnabled = true;
+			maxDrawDistance = _maxDrawDistance;
+			drawListIsDirty = true; //builds the spheres
+		}
+
+		//enables the GPU driven path, call after InitInstanceBuffers
+		inline bool EnableGPUCulling(GPUCullingPass* pass)
+		{
+			if (!pass || !pass->isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDERER WARNING: Render Operation Batch || EnableGPUCulling || The GPU culling pass was not created, staying on the CPU path.\n");
+				return false;
+			}
 
-			//checks if batches already exist containing the desired assets
-			pipelineLayouts.emplace_back(layout);
-			op->meshPipelineLayoutIndex = pipelineLayouts.size() - 1;
+			if (!pass->AllocateFrameData(gpuCullingFrames, (uint32_t)instanceBuffers.size()))
+				return false;
 
-			pipelines.emplace_back(pipeline);
-			op->meshPipelineIndex = pipelines.size() - 1;
+			//the cull reads the instances as a storage buffer
+			for (size_t i = 0; i < instanceBuffers.size(); ++i)
+			{
+				instanceBuffers[i].Destroy(allocator);
+				instanceBuffers[i].usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+				instanceUploadStates[i].needsFullUpload = true;
+				instanceUploadStates[i].pendingInstances.clear();
+			}
 
-			staticMeshes.emplace_back(mesh);
-			op->meshIndex = staticMeshes.size() - 1;
+			gpuCulling = pass;
+			return true;
+		}
+
+		//is the GPU driven path being used
+		inline bool IsGPUCullingEnabled() const { return gpuCulling != nullptr; }
+
+		//is the CPU cull being used
+		inline bool IsCPUCullingActive() const { return CPUCullingIsEnabled && !IsGPUCullingEnabled(); }
+
+		//destroys the per frame instance buffers
+		inline void DestroyInstanceBuffers()
+		{
+			for (size_t i = 0; i < gpuCullingFrames.size(); ++i)
+				gpuCullingFrames[i].Destroy(allocator);
+			gpuCullingFrames.clear();
+			gpuCulling = nullptr;
+
+			for (size_t i = 0; i < instanceBuffers.size(); ++i)
+				instanceBuffers[i].Destroy(allocator);
+			instanceBuffers.clear();
+			instanceUploadStates.clear();
+		}
+
+		//updates the world sphere of a instance from its model matrix, the radius grows with the largest scale
+		inline void UpdateInstanceWorldSphere(uint32_t instanceIndex, const glm::mat4& modelMatrix)
+		{
+			const glm::vec4& localSphere = instanceLocalSpheres[instanceIndex];
+			const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(glm::vec3(localSphere), 1.0f));
+			const float scale = glm::max(glm::length(glm::vec3(modelMatrix[0])), glm::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+			instanceWorldSpheres.Set(instanceIndex, center, (localSphere.w < 0.0f ? -1.0f : localSphere.w * scale));
+		}
+
+		//interns a asset, returning the index it's stored at
+		template<typename T>
+		static inline uint32_t InternAsset(T* asset, std::vector<T*>& assets, std::unordered_map<T*, uint32_t>& lookup)
+		{
+			auto it = lookup.find(asset);
+			if (it != lookup.end())
+				return it->second;
+
+			const uint32_t index = (uint32_t)assets.size();
+			assets.emplace_back(asset);
+			lookup[asset] = index;
+			return index;
+		}
+
+		//adds a static mesh
+		inline RenderOperation_StaticMesh* AddStaticMesh(Wireframe::Pipeline::PipelineLayout* layout, Wireframe::Pipeline::GraphicsPipeline* pipeline, PooledMesh* mesh,
+			uint64_t entityID, Smok::ECS::Comp::Transform& entityTransform)
+		{
+			return AddStaticMesh(layout, pipeline, mesh, entityID, entityTransform.ModelMatrix());
+		}
+
+		//adds a static mesh from its model matrix
+		inline RenderOperation_StaticMesh* AddStaticMesh(Wireframe::Pipeline::PipelineLayout* layout, Wireframe::Pipeline::GraphicsPipeline* pipeline, PooledMesh* mesh,
+			uint64_t entityID, const glm::mat4& modelMatrix)
+		{
+			//checks if the assets are already interned, the key can only index so many of each
+			if ((pipelineLookup.find(pipeline) == pipelineLookup.end() && pipelines.size() >= SORT_KEY_MAX_PIPELINES) ||
+				(pipelineLayoutLookup.find(layout) == pipelineLayoutLookup.end() && pipelineLayouts.size() >= SORT_KEY_MAX_LAYOUTS) ||
+				(staticMeshLookup.find(mesh) == staticMeshLookup.end() && staticMeshes.size() >= SORT_KEY_MAX_MESHES))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Render Operation Batch || AddStaticMesh || The batch is out of asset slots, use another batch!\n");
+				return nullptr;
+			}
+
+			RenderOperation_StaticMesh* op = &renderOperations_staticMesh.emplace_back(RenderOperation_StaticMesh());
+			op->meshPipelineLayoutIndex = InternAsset(layout, pipelineLayouts, pipelineLayoutLookup);
+			op->meshPipelineIndex = InternAsset(pipeline, pipelines, pipelineLookup);
+			op->meshIndex = InternAsset(mesh, staticMeshes, staticMeshLookup);
+			op->stateSortKey = SortKey_GenerateState(op->meshPipelineIndex, op->meshPipelineLayoutIndex, op->meshIndex);
 
 			//adds a draw call
-			DrawCallOp dc;
-			dc.modelMatrix = entityTransform.ModelMatrix();
-			op->ops.emplace_back(dc);
+			op->entityID = entityID;
+			op->op.modelMatrix = modelMatrix;
+			entityLookup[entityID] = (uint32_t)(renderOperations_staticMesh.size() - 1);
 
+			drawListIsDirty = true;
 			return op;
 		}
 
-		//perform operations
-		inline void PerformRender(VkCommandBuffer& cmd, Smok::ECS::Comp::Transform* cameraTransform, Smok::ECS::Comp::Camera* cameraSettings)
+		//removes a entity's draw, the last draw is moved into its place and the draw list is compiled again
+		//returns false if the entity isn't in this batch
+		inline bool RemoveStaticMesh(uint64_t entityID)
 		{
-			Wireframe::Pipeline::GraphicsPipeline* lastPipeline = nullptr;
-			Smok::Asset::Mesh::StaticMesh* lastStaticMesh = nullptr;
-			for (size_t i = 0; i < renderOperations_staticMesh.size(); ++i)
+			auto it = entityLookup.find(entityID);
+			if (it == entityLookup.end())
+				return false;
+
+			const uint32_t opIndex = it->second;
+			entityLookup.erase(it);
+
+			const uint32_t lastIndex = (uint32_t)(renderOperations_staticMesh.size() - 1);
+			if (opIndex != lastIndex)
+			{
+				renderOperations_staticMesh[opIndex] = renderOperations_staticMesh[lastIndex];
+				entityLookup[renderOperations_staticMesh[opIndex].entityID] = opIndex;
+			}
+			renderOperations_staticMesh.pop_back();
+
+			drawListIsDirty = true;
+			return true;
+		}
+
+		//updates the model matrix of a entity's draw, the instance is written in place the next time each frame is recorded
+		//returns false if the entity isn't in this batch
+		inline bool UpdateTransform(uint64_t entityID, const glm::mat4& modelMatrix)
+		{
+			auto it = entityLookup.find(entityID);
+			if (it == entityLookup.end())
+				return false;
+
+			RenderOperation_StaticMesh* op = &renderOperations_staticMesh[it->second];
+			op->op.modelMatrix = modelMatrix;
+
+			//a full upload will write it anyway
+			if (drawListIsDirty)
+				return true;
+
+			if (CPUCullingIsEnabled)
+				UpdateInstanceWorldSphere(op->instanceIndex, modelMatrix);
+
+			for (size_t i = 0; i < instanceUploadStates.size(); ++i)
 			{
-				//binds the pipeline if it isn't already
-				if (lastPipeline != pipelines[renderOperations_staticMesh[i].meshPipelineIndex])
+				InstanceUploadState* uploadState = &instanceUploadStates[i];
+				if (uploadState->needsFullUpload)
+					continue;
+
+				//a frame that hasn't been recorded in a while (minimized) would keep growing the list, writing everything is cheaper by then
+				if (uploadState->pendingInstances.size() >= drawList.size())
 				{
-					lastPipeline = pipelines[renderOperations_staticMesh[i].meshPipelineIndex];
-					lastPipeline->Bind(cmd);
+					uploadState->needsFullUpload = true;
+					uploadState->pendingInstances.clear();
+					continue;
 				}
 
-				//updates any pipelines bound to the window size
-				VkViewport v = {};
-				v.width = cameraSettings->renderSize.x;
-				v.height = cameraSettings->renderSize.y;
-				VkRect2D s = {};
-				s.extent = { (uint32_t)v.width, (uint32_t)v.height };
-				lastPipeline->SetViewport(cmd, v);
-				lastPipeline->SetScissor(cmd, s);
-
-				//binds the mesh if it's not
-				if (lastStaticMesh != staticMeshes[renderOperations_staticMesh[i].meshIndex])
+				uploadState->pendingInstances.emplace_back(op->instanceIndex);
+			}
+			return true;
+		}
+
+		//gets the mesh to draw in place of a mesh, nullptr if nothing can be drawn for it yet
+		inline const PooledMesh* ResolveMesh(const PooledMesh* mesh) const
+		{
+			if (mesh->isResident)
+				return mesh;
+			return (placeholderMesh && placeholderMesh->isResident ? placeholderMesh : nullptr);
+		}
+
+		//counts the meshes that aren't resident yet
+		inline uint32_t CountNonResidentMeshes() const
+		{
+			uint32_t count = 0;
+			for (size_t i = 0; i < staticMeshes.size(); ++i)
+				count += (staticMeshes[i]->isResident ? 0 : 1);
+			return count;
+		}
+
+		//builds the draw list and sorts it by state then front to back, every frame's instances are uploaded again
+		inline void CompileDrawList(const glm::vec3& cameraPosition, Memory::FrameArena* frameArena)
+		{
+			const size_t opCount = renderOperations_staticMesh.size();
+			drawList.resize(opCount);
+			for (size_t i = 0; i < opCount; ++i)
+			{
+				const RenderOperation_StaticMesh& op = renderOperations_staticMesh[i];
+				const float depth = glm::length(glm::vec3(op.op.modelMatrix[3]) - cameraPosition);
+				drawList[i].key = op.stateSortKey | (SortKey_QuantizeDepth(depth) << SORT_KEY_DEPTH_SHIFT);
+				drawList[i].drawIndex = (uint32_t)i;
+			}
+
+			RadixSort_DrawItems(drawList, frameArena->AllocateArray<SortedDrawItem>(opCount));
+			nonResidentMeshCount = CountNonResidentMeshes();
+
+			for (size_t i = 0; i < opCount; ++i)
+				renderOperations_staticMesh[drawList[i].drawIndex].instanceIndex = (uint32_t)i;
+
+			//the bounds of every instance for the CPU cull
+			if (CPUCullingIsEnabled)
+			{
+				instanceLocalSpheres.resize(opCount);
+				instanceWorldSpheres.Resize(opCount);
+				for (size_t i = 0; i < opCount; ++i)
+				{
+					const RenderOperation_StaticMesh& op = renderOperations_staticMesh[drawList[i].drawIndex];
+					const PooledMesh* mesh = ResolveMesh(staticMeshes[op.meshIndex]);
+					instanceLocalSpheres[i] = (mesh ? mesh : staticMeshes[op.meshIndex])->boundingSphere;
+					UpdateInstanceWorldSphere((uint32_t)i, op.op.modelMatrix);
+				}
+			}
+
+			//every draw sharing the state of the first one in the run becomes a instance of it
+			drawRuns.clear();
+			drawCommandCount = 0;
+			size_t runStart = 0;
+			while (runStart < opCount)
+			{
+				const uint64_t state = SortKey_GetState(drawList[runStart].key);
+				size_t runEnd = runStart + 1;
+				while (runEnd < opCount && SortKey_GetState(drawList[runEnd].key) == state)
+					runEnd++;
+
+				DrawRun run;
+				run.state = state;
+				run.firstInstance = (uint32_t)runStart;
+				run.instanceCount = (uint32_t)(runEnd - runStart);
+				run.command = drawCommandCount++;
+				drawRuns.emplace_back(run);
+
+				runStart = runEnd;
+			}
+
+			for (size_t i = 0; i < instanceUploadStates.size(); ++i)
+			{
+				instanceUploadStates[i].needsFullUpload = true;
+				instanceUploadStates[i].pendingInstances.clear();
+			}
+			drawListIsDirty = false;
+		}
+
+		//writes the instance data the frame's instance buffer is missing
+		//after a compile every instance is written in draw list order, otherwise only the changed ones are written in place
+		inline bool UploadInstances(uint32_t frameSlotIndex)
+		{
+			const uint64_t instanceCount = drawList.size();
+			stats.instances = instanceCount;
+			if (instanceCount == 0)
+				return true;
+
+			InstanceBuffer* buffer = &instanceBuffers[frameSlotIndex];
+			InstanceUploadState* uploadState = &instanceUploadStates[frameSlotIndex];
+
+			//full upload
+			if (uploadState->needsFullUpload)
+			{
+				const VkDeviceSize size = instanceCount * sizeof(MeshInstanceData);
+				if (!buffer->Reserve(allocator, size))
+					return false;
+
+				MeshInstanceData* instances = (MeshInstanceData*)buffer->mappedData;
+				for (size_t i = 0; i < instanceCount; ++i)
+					instances[i].modelMatrix = renderOperations_staticMesh[drawList[i].drawIndex].op.modelMatrix;
+
+				buffer->Flush(allocator, 0, size);
+				if (IsGPUCullingEnabled() && !UploadGPUCullingData(frameSlotIndex))
+					return false;
+
+				uploadState->needsFullUpload = false;
+				uploadState->pendingInstances.clear();
+				stats.instancesWritten = instanceCount;
+				return true;
+			}
+
+			//writes the changed instances in place, flushing the range that covers them
+			const size_t pendingCount = uploadState->pendingInstances.size();
+			if (pendingCount == 0)
+				return true;
+
+			MeshInstanceData* instances = (MeshInstanceData*)buffer->mappedData;
+			uint32_t minInstance = UINT32_MAX, maxInstance = 0;
+			for (size_t i = 0; i < pendingCount; ++i)
+			{
+				const uint32_t instance = uploadState->pendingInstances[i];
+				instances[instance].modelMatrix = renderOperations_staticMesh[drawList[instance].drawIndex].op.modelMatrix;
+
+				if (instance < minInstance) minInstance = instance;
+				if (instance > maxInstance) maxInstance = instance;
+			}
+
+			buffer->Flush(allocator, (VkDeviceSize)minInstance * sizeof(MeshInstanceData), (VkDeviceSize)(maxInstance - minInstance + 1) * sizeof(MeshInstanceData));
+			uploadState->pendingInstances.clear();
+			stats.instancesWritten = pendingCount;
+			return true;
+		}
+
+		//writes the bounds and indirect commands of the frame, they only change when the draw list is compiled
+		inline bool UploadGPUCullingData(uint32_t frameSlotIndex)
+		{
+			GPUCullingFrameData* frame = &gpuCullingFrames[frameSlotIndex];
+			const uint32_t instanceCount = (uint32_t)drawList.size();
+			if (!frame->bounds.Reserve(allocator, (VkDeviceSize)instanceCount * sizeof(GPUCullInstanceBounds)) ||
+				!frame->commands.Reserve(allocator, (VkDeviceSize)drawCommandCount * sizeof(GPUIndirectCommand)) ||
+				!gpuCulling->ReserveFrame(*frame, instanceCount, (uint32_t)drawRuns.size()))
+				return false;
+
+			GPUCullInstanceBounds* bounds = (GPUCullInstanceBounds*)frame->bounds.mappedData;
+			GPUIndirectCommand* commands = (GPUIndirectCommand*)frame->commands.mappedData;
+			for (uint32_t r = 0; r < (uint32_t)drawRuns.size(); ++r)
+			{
+				const DrawRun& run = drawRuns[r];
+				const PooledMesh* mesh = ResolveMesh(staticMeshes[SortKey_GetMesh(run.state)]);
+
+				//the bounds of every instance in the run
+				GPUCullInstanceBounds instanceBounds;
+				instanceBounds.sphere = (mesh ? mesh : staticMeshes[SortKey_GetMesh(run.state)])->boundingSphere;
+				instanceBounds.runIndex = r;
+				instanceBounds.runFirstInstance = run.firstInstance;
+				for (uint32_t i = 0; i < run.instanceCount; ++i)
+					bounds[run.firstInstance + i] = instanceBounds;
+
+				//the whole mesh in one command, the instance count is filled in by the cull
+				//a mesh that can't be drawn yet keeps its command with no indices
+				GPUIndirectCommand* command = &commands[run.command];
+				*command = GPUIndirectCommand();
+				command->command.firstInstance = run.firstInstance;
+				command->runIndex = r;
+				if (!mesh)
+					continue;
+				command->command.indexCount = mesh->indexCount;
+				command->command.firstIndex = mesh->firstIndex;
+				command->command.vertexOffset = mesh->vertexOffset;
+			}
+
+			frame->bounds.Flush(allocator, 0, (VkDeviceSize)instanceCount * sizeof(GPUCullInstanceBounds));
+			frame->commands.Flush(allocator, 0, (VkDeviceSize)drawCommandCount * sizeof(GPUIndirectCommand));
+			return true;
+		}
+
+		//culls the instances on the CPU and packs the visible ones of each run into the frame's instance buffer, in sorted order
+		//the buffer isn't written by UploadInstances when culling on the CPU, so each visible instance is written once. The visibility only lives for the cull, it comes from the frame's arena
+		inline bool CullInstances(uint32_t frameSlotIndex, const ViewFrameConstants& view, Memory::FrameArena* frameArena)
+		{
+			CullSettings settings;
+			settings.frustumPlanes = view.frustumPlanes;
+			settings.cameraPosition = view.cameraPosition;
+			settings.maxDistance = maxDrawDistance;
+			uint8_t* instanceVisibility = frameArena->AllocateArray<uint8_t>(drawList.size());
+			const size_t visibleCount = CullSpheres(settings, instanceWorldSpheres, instanceVisibility);
+
+			stats.visibleInstances = visibleCount;
+			stats.culledInstances = drawList.size() - visibleCount;
+			if (visibleCount == 0)
+			{
+				for (size_t r = 0; r < drawRuns.size(); ++r)
+					drawRuns[r].visibleInstanceCount = 0;
+				return true;
+			}
+
+			InstanceBuffer* buffer = &instanceBuffers[frameSlotIndex];
+			const VkDeviceSize size = visibleCount * sizeof(MeshInstanceData);
+			if (!buffer->Reserve(allocator, size))
+				return false;
+
+			MeshInstanceData* instances = (MeshInstanceData*)buffer->mappedData;
+			uint32_t written = 0;
+			for (size_t r = 0; r < drawRuns.size(); ++r)
+			{
+				DrawRun& run = drawRuns[r];
+				run.firstVisibleInstance = written;
+				for (uint32_t i = run.firstInstance; i < run.firstInstance + run.instanceCount; ++i)
 				{
-					lastStaticMesh = staticMeshes[renderOperations_staticMesh[i].meshIndex];
-					lastStaticMesh->vertexBuffer.Bind(cmd);
+					if (instanceVisibility[i])
+						instances[written++].modelMatrix = renderOperations_staticMesh[drawList[i].drawIndex].op.modelMatrix;
 				}
+				run.visibleInstanceCount = written - run.firstVisibleInstance;
+			}
+
+			buffer->Flush(allocator, 0, size);
+			stats.instancesWritten = written;
+			return true;
+		}
+
+		//records the GPU cull for the frame, must be after PrepareRender and outside of the render pass
+		inline void RecordGPUCulling(VkCommandBuffer& cmd, uint32_t frameSlotIndex, const ViewFrameConstants& view)
+		{
+			if (!IsGPUCullingEnabled())
+				return;
+
+			GPUCullingFrameData* frame = &gpuCullingFrames[frameSlotIndex];
+			if (!isReadyToRecord)
+			{
+				frame->hasReadback = false;
+				return;
+			}
+
+			gpuCulling->RecordCull(cmd, *frame, instanceBuffers[frameSlotIndex], view, (uint32_t)drawList.size(), drawCommandCount, (uint32_t)drawRuns.size());
+		}
+
+		//compiles the draw list if needed and uploads the frame's instances, must happen before any runs are recorded
+		//the scratch data of the compile and cull is allocated from the frame's arena. Returns false if there is nothing to record
+		inline bool PrepareRender(uint32_t frameSlotIndex, const ViewFrameConstants& view, Memory::FrameArena* frameArena)
+		{
+			stats = RenderOperationBatchStats();
+			isReadyToRecord = false;
+
+			//the fence for this frame has signaled, so what it culled last time can be read without waiting
+			if (IsGPUCullingEnabled())
+				stats.gpuVisibleInstancesIsValid = gpuCulling->ReadVisibleCount(gpuCullingFrames[frameSlotIndex], stats.gpuVisibleInstances);
+
+			//a mesh that finished streaming in swaps in for its placeholder
+			if (nonResidentMeshCount > 0 && CountNonResidentMeshes() < nonResidentMeshCount)
+				drawListIsDirty = true;
+
+			if (drawListIsDirty)
+				CompileDrawList(view.cameraPosition, frameArena);
+
+			//the CPU cull writes the visible instances itself, the frame's buffer is rewritten every frame so nothing is pending for it
+			bool uploaded = true;
+			if (IsCPUCullingActive())
+			{
+				stats.instances = drawList.size();
+				instanceUploadStates[frameSlotIndex].needsFullUpload = true;
+				instanceUploadStates[frameSlotIndex].pendingInstances.clear();
+				uploaded = (stats.instances == 0 || CullInstances(frameSlotIndex, view, frameArena));
+			}
+			else
+				uploaded = UploadInstances(frameSlotIndex);
+
+			if (!uploaded)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Render Operation Batch || PrepareRender || Failed to upload the instance data, skipping the batch!\n");
+				return false;
+			}
+
+			isReadyToRecord = (stats.instances > 0);
+			return isReadyToRecord;
+		}
+
+		//gets how many instances the recorded runs draw, the visible ones when culling on the CPU. The instance slices of RecordRuns index these
+		inline uint64_t GetDrawnInstanceCount() const { return (IsCPUCullingActive() ? stats.visibleInstances : drawList.size()); }
+
+		//records a range of the draw runs, the batch must have been prepared for the frame
+		//only the instances in the slice are drawn, so one big run can be split across threads. The slice is ignored by the GPU driven path since the cull picks the counts
+		//safe to call from several threads at once as long as each has its own command buffer, state and stats
+		inline void RecordRuns(VkCommandBuffer& cmd, uint32_t frameSlotIndex, const ViewFrameConstants& view, RecordedRenderState& recordedState,
+			RenderOperationBatchStats& recordStats, size_t firstRun, size_t runCount, uint64_t firstSliceInstance = 0, uint64_t sliceInstanceCount = UINT64_MAX)
+		{
+			const size_t lastRun = (firstRun + runCount < drawRuns.size() ? firstRun + runCount : drawRuns.size());
+			if (!isReadyToRecord || firstRun >= lastRun)
+				return;
+
+			//the instance binding stays bound across pipeline binds, runs select their range with the first instance
+			//the GPU driven path reads the instances its cull compacted, the CPU culled path reads the ones its cull packed into the instance buffer
+			const bool isIndirect = IsGPUCullingEnabled();
+			const bool isCPUCulled = IsCPUCullingActive();
+			if (isCPUCulled && stats.visibleInstances == 0)
+				return;
+
+			const uint64_t drawnInstanceCount = GetDrawnInstanceCount();
+			const uint64_t lastSliceInstance = (sliceInstanceCount >= drawnInstanceCount ? drawnInstanceCount : std::min(firstSliceInstance + sliceInstanceCount, drawnInstanceCount));
+			if (!isIndirect && firstSliceInstance >= lastSliceInstance)
+				return;
+
+			const VkDeviceSize instanceBufferOffset = 0;
+			VkBuffer instanceBuffer = (isIndirect ? gpuCullingFrames[frameSlotIndex].visibleInstances.buffer : instanceBuffers[frameSlotIndex].buffer);
+			vkCmdBindVertexBuffers(cmd, MESH_INSTANCE_BINDING, 1, &instanceBuffer, &instanceBufferOffset);
+			recordStats.vertexBufferBinds++;
+
+			//the PV is the same for every draw, it's only pushed when the layout changes
+			MeshPushConstants data;
+			data.render_matrix = view.projectionView;
+
+			Wireframe::Pipeline::PipelineLayout* lastPipelineLayout = nullptr;
+			const MeshPool* lastMeshPool = nullptr;
+			for (size_t r = firstRun; r < lastRun; ++r)
+			{
+				const DrawRun& run = drawRuns[r];
+
+				//the part of the run inside the slice
+				const uint64_t runFirstInstance = (isCPUCulled ? run.firstVisibleInstance : run.firstInstance);
+				const uint64_t runLastInstance = runFirstInstance + (isCPUCulled ? run.visibleInstanceCount : run.instanceCount);
+				const uint32_t firstInstance = (uint32_t)std::max(runFirstInstance, firstSliceInstance);
+				const uint32_t lastInstance = (uint32_t)std::min(runLastInstance, lastSliceInstance);
+				if (!isIndirect && firstInstance >= lastInstance)
+					continue;
+
+				//the mesh is still streaming in and there's no placeholder to draw
+				const PooledMesh* mesh = ResolveMesh(staticMeshes[SortKey_GetMesh(run.state)]);
+				if (!mesh)
+					continue;
 
-				//calculate the PV
-				const glm::mat4 PV = cameraSettings->GeneratePerspective() * cameraSettings->GenerateView(cameraTransform->position);
+				//binds the pipeline if it isn't already, updating the viewport and scissor with it
+				const bool pipelineChanged = recordedState.BindPipeline(cmd, pipelines[SortKey_GetPipeline(run.state)], view);
+				if (pipelineChanged)
+					recordStats.pipelineBinds++;
 
-				//pushes data
-				MeshPushConstants data;
-				data.render_matrix = PV * renderOperations_staticMesh[i].ops[0].modelMatrix;
-				pipelineLayouts[renderOperations_staticMesh[i].meshPipelineLayoutIndex]->UpdatePushConstant_Vertex(cmd, "Mesh Data", &data);
+				//binds the mesh's pool if it's not, every mesh in it is drawn by offset
+				if (lastMeshPool != mesh->pool)
+				{
+					lastMeshPool = mesh->pool;
+					lastMeshPool->Bind(cmd);
+					recordStats.vertexBufferBinds++;
+					recordStats.indexBufferBinds++;
+				}
+
+				//pushes data, the model matrix comes from the instance buffer
+				if (pipelineChanged || lastPipelineLayout != pipelineLayouts[SortKey_GetLayout(run.state)])
+				{
+					lastPipelineLayout = pipelineLayouts[SortKey_GetLayout(run.state)];
+					lastPipelineLayout->UpdatePushConstant_Vertex(cmd, "Mesh Data", &data);
+				}
 
-				//draws meshes
-				for (size_t m = 0; m < lastStaticMesh->meshes.size(); ++m)
+				//draws every instance of the whole mesh at once, its sub meshes are next to each other in the pool
+				if (isIndirect)
+				{
+					vkCmdDrawIndexedIndirect(cmd, gpuCullingFrames[frameSlotIndex].commands.buffer, (VkDeviceSize)run.command * sizeof(GPUIndirectCommand), 1, sizeof(GPUIndirectCommand));
+					recordStats.drawCalls++;
+				}
+				else
 				{
-					lastStaticMesh->meshes[m].indexBuffer.Bind(cmd);
-					lastStaticMesh->meshes[m].indexBuffer.Draw(cmd, 1, 0);
+					vkCmdDrawIndexed(cmd, mesh->indexCount, lastInstance - firstInstance, mesh->firstIndex, mesh->vertexOffset, firstInstance);
+					recordStats.drawCalls++;
 				}
 			}
 		}
+
+		//perform operations
+		inline void PerformRender(VkCommandBuffer& cmd, uint32_t frameSlotIndex, const ViewFrameConstants& view, RecordedRenderState& recordedState, Memory::FrameArena* frameArena)
+		{
+			if (!PrepareRender(frameSlotIndex, view, frameArena))
+				return;
+
+			RecordRuns(cmd, frameSlotIndex, view, recordedState, stats, 0, drawRuns.size());
+		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+//defines a VkPipelineCache that is kept on disk between runs, so the driver only compiles a pipeline the first time it's seen
+//the saved data is thrown away if it was written by a different GPU or driver
+
+#include <BTDSTD/Wireframe/Core/GPU.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Pong3D::Renderer
+{
+	//defines the stats of the cache
+	struct PipelineCacheStats
+	{
+		size_t loadedBytes = 0; //how much was loaded from disk, 0 if it was missing or thrown away
+		size_t savedBytes = 0;
+		bool wasRejected = false; //the data on disk was for another device or driver
+	};
+
+	//defines a pipeline cache
+	struct PipelineCache
+	{
+		Wireframe::Device::GPU* GPU = nullptr;
+		VkPipelineCache cache = VK_NULL_HANDLE;
+		std::string filepath;
+
+		PipelineCacheStats stats;
+
+		//checks if the saved data was written by this device, the header is laid out by the Vulkan spec
+		static inline bool IsDataValidForDevice(const std::vector<uint8_t>& data, const VkPhysicalDeviceProperties& properties)
+		{
+			//header size, header version, vendor ID, device ID, cache UUID
+			const size_t headerSize = sizeof(uint32_t) * 4 + VK_UUID_SIZE;
+			if (data.size() < headerSize)
+				return false;
+
+			uint32_t header[4];
+			memcpy(header, data.data(), sizeof(header));
+			return header[0] >= headerSize && header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+				header[2] == properties.vendorID && header[3] == properties.deviceID &&
+				memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+		}
+
+		//creates the cache, loading what was saved at the filepath if it's valid for this device
+		inline bool Create(Wireframe::Device::GPU* _GPU, const std::string& _filepath)
+		{
+			GPU = _GPU;
+			filepath = _filepath;
+			stats = PipelineCacheStats();
+
+			std::vector<uint8_t> data;
+			std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+			if (file.is_open())
+			{
+				data.resize((size_t)file.tellg());
+				file.seekg(0);
+				file.read((char*)data.data(), (std::streamsize)data.size());
+				file.close();
+
+				VkPhysicalDeviceProperties properties;
+				vkGetPhysicalDeviceProperties(GPU->chosenGPU, &properties);
+				if (!IsDataValidForDevice(data, properties))
+				{
+					fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDERER WARNING: Pipeline Cache || Create || \"{}\" was saved by a different GPU or driver, starting a new cache.\n", filepath);
+					data.clear();
+					stats.wasRejected = true;
+				}
+			}
+
+			VkPipelineCacheCreateInfo cacheInfo = {};
+			cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+			cacheInfo.initialDataSize = data.size();
+			cacheInfo.pInitialData = (data.empty() ? nullptr : data.data());
+			if (vkCreatePipelineCache(GPU->device, &cacheInfo, nullptr, &cache) != VK_SUCCESS)
+			{
+				//the driver can still reject data that passed the header check
+				cacheInfo.initialDataSize = 0;
+				cacheInfo.pInitialData = nullptr;
+				stats.wasRejected = !data.empty();
+				data.clear();
+				if (vkCreatePipelineCache(GPU->device, &cacheInfo, nullptr, &cache) != VK_SUCCESS)
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Pipeline Cache || Create || Failed to create a pipeline cache!\n");
+					cache = VK_NULL_HANDLE;
+					return false;
+				}
+			}
+
+			stats.loadedBytes = data.size();
+			return true;
+		}
+
+		//writes the cache to disk, written to a temp file first so a crash never leaves a half written cache
+		inline bool Save()
+		{
+			if (cache == VK_NULL_HANDLE)
+				return false;
+
+			size_t size = 0;
+			if (vkGetPipelineCacheData(GPU->device, cache, &size, nullptr) != VK_SUCCESS || size == 0)
+				return false;
+			std::vector<uint8_t> data(size);
+			if (vkGetPipelineCacheData(GPU->device, cache, &size, data.data()) != VK_SUCCESS)
+				return false;
+
+			const std::string tempFilepath = filepath + ".tmp";
+			{
+				std::ofstream file(tempFilepath, std::ios::binary | std::ios::trunc);
+				if (!file.is_open())
+				{
+					fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Pipeline Cache || Save || Failed to open \"{}\" for writing!\n", tempFilepath);
+					return false;
+				}
+				file.write((const char*)data.data(), (std::streamsize)size);
+				if (!file.good())
+					return false;
+			}
+
+			std::error_code error;
+			std::filesystem::rename(tempFilepath, filepath, error);
+			if (error)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Pipeline Cache || Save || Failed to replace \"{}\": {}\n", filepath, error.message());
+				return false;
+			}
+
+			stats.savedBytes = size;
+			return true;
+		}
+
+		//destroys the cache, save it first to keep it
+		inline void Destroy()
+		{
+			if (cache != VK_NULL_HANDLE)
+				vkDestroyPipelineCache(GPU->device, cache, nullptr);
+			cache = VK_NULL_HANDLE;
+		}
+	};
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+//defines a registry of the pipeline states that have been created, keyed by a hash of everything that goes into them
+//pipelines registered under different names with the same settings, shaders and layout share one VkPipeline
+
+#include <BTDSTD/Wireframe/Pipeline/GraphicsPipeline.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Pong3D::Renderer
+{
+	//the seed of a pipeline state hash
+	static constexpr uint64_t PIPELINE_STATE_HASH_SEED = 14695981039346656037ull;
+
+	//hashes bytes into a running 64 bit FNV-1a hash
+	inline uint64_t PipelineState_HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	//hashes a value into a running hash
+	template<typename T>
+	inline uint64_t PipelineState_HashValue(uint64_t hash, const T& value) { return PipelineState_HashBytes(hash, &value, sizeof(T)); }
+
+	//hashes the contents of a file into a running hash, returns false if it can't be read
+	inline bool PipelineState_HashFile(uint64_t& hash, const std::string& filepath)
+	{
+		std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+		{
+			fmt::print(fmt::fg(fmt::color::red), "PS ENGINE RENDERER ERROR: Pipeline Registry || PipelineState_HashFile || Failed to open \"{}\"!\n", filepath);
+			return false;
+		}
+
+		std::string contents((size_t)file.tellg(), '\0');
+		file.seekg(0);
+		file.read(contents.data(), (std::streamsize)contents.size());
+		hash = PipelineState_HashValue(hash, contents.size());
+		hash = PipelineState_HashBytes(hash, contents.data(), contents.size());
+		return true;
+	}
+
+	//defines a pipeline state, the layout and pipeline a draw uses
+	struct PipelineState
+	{
+		Wireframe::Pipeline::PipelineLayout* layout = nullptr;
+		Wireframe::Pipeline::GraphicsPipeline* pipeline = nullptr;
+	};
+
+	//defines the stats of the registry
+	struct PipelineRegistryStats
+	{
+		uint64_t layoutsCreated = 0, layoutsShared = 0;
+		uint64_t pipelinesCreated = 0, pipelinesShared = 0;
+	};
+
+	//defines the registry
+	struct PipelineRegistry
+	{
+		std::unordered_map<uint64_t, Wireframe::Pipeline::PipelineLayout*> layouts;
+		std::unordered_map<uint64_t, PipelineState> pipelines;
+
+		PipelineRegistryStats stats;
+
+		//pipelines can be built on loader threads, every find and register takes the lock
+		std::mutex mutex;
+
+		//gets a layout that was already created, nullptr if there isn't one
+		inline Wireframe::Pipeline::PipelineLayout* FindLayout(uint64_t layoutHash)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = layouts.find(layoutHash);
+			if (it == layouts.end())
+				return nullptr;
+
+			stats.layoutsShared++;
+			return it->second;
+		}
+
+		//registers a layout that was created
+		inline void RegisterLayout(uint64_t layoutHash, Wireframe::Pipeline::PipelineLayout* layout)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			layouts[layoutHash] = layout;
+			stats.layoutsCreated++;
+		}
+
+		//gets a pipeline state that was already created, the pipeline is nullptr if there isn't one
+		inline PipelineState FindPipeline(uint64_t pipelineHash)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = pipelines.find(pipelineHash);
+			if (it == pipelines.end())
+				return PipelineState();
+
+			stats.pipelinesShared++;
+			return it->second;
+		}
+
+		//registers a pipeline state that was created
+		inline void RegisterPipeline(uint64_t pipelineHash, const PipelineState& state)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pipelines[pipelineHash] = state;
+			stats.pipelinesCreated++;
+		}
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+//defines the profiler overlay, a TyGUI window with the frame pacing, the GPU scopes and the pipeline statistics
+//call between the widget renderer's StartFrame and the render manager's SubmitFrame
+
+#include <3DPong/Profiling/CPUProfiler.hpp>
+#include <3DPong/Renderer/FrameManager.hpp>
+
+namespace Pong3D::Renderer
+{
+	//draws the overlay
+	inline void ProfilerOverlay_Draw(const FrameRenderManager& renderManager)
+	{
+		const FramePacingStats& pacing = renderManager.pacingStats;
+		const GPUProfileFrameResults& gpu = renderManager.gpuProfiler.lastResults;
+
+		ImGui::Begin("Profiler");
+
+		//CPU, the fence wait is time the CPU had nothing to do
+		const float CPUBusyMS = (pacing.averageFrameMS > pacing.averageFenceWaitMS ? pacing.averageFrameMS - pacing.averageFenceWaitMS : 0.0f);
+		ImGui::Text("Frame: %.3f ms (avg %.3f ms, %.1f FPS)", pacing.lastFrameMS, pacing.averageFrameMS,
+			(pacing.averageFrameMS > 0.0f ? 1000.0f / pacing.averageFrameMS : 0.0f));
+		ImGui::Text("CPU Busy: %.3f ms avg", CPUBusyMS);
+		ImGui::Text("Fence Wait: %.3f ms (avg %.3f ms, max %.3f ms)", pacing.lastFenceWaitMS, pacing.averageFenceWaitMS, pacing.maxFenceWaitMS);
+		ImGui::Text("Frames In Flight: %u (%u max queued)", renderManager.framesInFlightCount,
+			(renderManager.maxQueuedFrames > 0 ? renderManager.maxQueuedFrames : renderManager.framesInFlightCount));
+		if (!renderManager.engine->isHeadless)
+		{
+			const Platform::WindowSwapchain& swapchain = renderManager.engine->swapchain;
+			ImGui::Text("Present Mode: %s, %zu images at %ux%u", Platform::PresentMode_GetName(swapchain.presentMode), swapchain._swapchainImages.size(),
+				swapchain.extent.width, swapchain.extent.height);
+			ImGui::Text("Swapchain: %llu recreations (last %.3f ms, %llu kept the depth image), %llu out of date", (unsigned long long)swapchain.stats.recreations,
+				swapchain.stats.lastRecreateMS, (unsigned long long)swapchain.stats.depthImageReuses, (unsigned long long)renderManager.swapchainOutOfDateCount);
+		}
+		ImGui::Text("Recording Workers: %u", renderManager.workerPool.GetWorkerCount());
+#if PONG3D_PROFILING
+		ImGui::Text("CPU Zone Overhead: %.1f ns", Profiling::CPUProfiler_Get().zoneOverheadNS);
+#endif
+
+		if (!renderManager.gpuProfiler.isCreated)
+		{
+			ImGui::Text("GPU profiling is off");
+			ImGui::End();
+			return;
+		}
+
+		if (!gpu.isValid)
+		{
+			ImGui::Text("Waiting on the first GPU results");
+			ImGui::End();
+			return;
+		}
+
+		//the GPU is the bottleneck when its frame takes longer than the CPU's work on one
+		ImGui::Separator();
+		ImGui::Text("GPU Frame: %.3f ms (frame %llu)", gpu.frameMS, (unsigned long long)gpu.frameNumber);
+		ImGui::Text("Bound By: %s", (gpu.frameMS > CPUBusyMS ? "GPU" : "CPU"));
+
+		for (size_t i = 0; i < gpu.scopes.size(); ++i)
+		{
+			const GPUProfileScopeResult& scope = gpu.scopes[i];
+			ImGui::Text("%*s%s: %.3f ms", (int)(scope.depth * 2), "", scope.name.c_str(), scope.durationMS);
+		}
+
+		if (gpu.hasPipelineStatistics)
+		{
+			const GPUPipelineStatistics& statistics = gpu.pipelineStatistics;
+			ImGui::Separator();
+			ImGui::Text("Input Assembly Vertices: %llu", (unsigned long long)statistics.inputAssemblyVertices);
+			ImGui::Text("Vertex Shader Invocations: %llu", (unsigned long long)statistics.vertexShaderInvocations);
+			ImGui::Text("Clipped Primitives Out: %llu", (unsigned long long)statistics.clippingPrimitives);
+			ImGui::Text("Fragment Shader Invocations: %llu", (unsigned long long)statistics.fragmentShaderInvocations);
+		}
+
+		ImGui::End();
+	}
+}
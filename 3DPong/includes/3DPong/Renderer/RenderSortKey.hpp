@@ -0,0 +1,102 @@
+#pragma once
+
+//defines the sort keys used to order draws so state changes are minimal
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Pong3D::Renderer
+{
+	//the bit layout of a sort key, from most to least significant
+	//pipeline | layout | mesh | depth
+	static constexpr uint32_t SORT_KEY_PIPELINE_BITS = 16;
+	static constexpr uint32_t SORT_KEY_LAYOUT_BITS = 12;
+	static constexpr uint32_t SORT_KEY_MESH_BITS = 16;
+	static constexpr uint32_t SORT_KEY_DEPTH_BITS = 20;
+
+	static constexpr uint32_t SORT_KEY_DEPTH_SHIFT = 0;
+	static constexpr uint32_t SORT_KEY_MESH_SHIFT = SORT_KEY_DEPTH_SHIFT + SORT_KEY_DEPTH_BITS;
+	static constexpr uint32_t SORT_KEY_LAYOUT_SHIFT = SORT_KEY_MESH_SHIFT + SORT_KEY_MESH_BITS;
+	static constexpr uint32_t SORT_KEY_PIPELINE_SHIFT = SORT_KEY_LAYOUT_SHIFT + SORT_KEY_LAYOUT_BITS;
+
+	static_assert(SORT_KEY_PIPELINE_SHIFT + SORT_KEY_PIPELINE_BITS == 64, "the sort key must use all 64 bits");
+
+	//the max number of interned assets of each kind a key can hold
+	static constexpr uint32_t SORT_KEY_MAX_PIPELINES = 1u << SORT_KEY_PIPELINE_BITS;
+	static constexpr uint32_t SORT_KEY_MAX_LAYOUTS = 1u << SORT_KEY_LAYOUT_BITS;
+	static constexpr uint32_t SORT_KEY_MAX_MESHES = 1u << SORT_KEY_MESH_BITS;
+
+	//generates the state part of a key, draws with the same state can be merged into one instanced draw
+	inline uint64_t SortKey_GenerateState(uint32_t pipelineIndex, uint32_t layoutIndex, uint32_t meshIndex)
+	{
+		return ((uint64_t)pipelineIndex << SORT_KEY_PIPELINE_SHIFT) | ((uint64_t)layoutIndex << SORT_KEY_LAYOUT_SHIFT) |
+			((uint64_t)meshIndex << SORT_KEY_MESH_SHIFT);
+	}
+
+	//quantizes a non negative depth into the key's depth bits
+	//the bits of a positive float grow with its value, so the top bits keep the order without needing a depth range
+	inline uint64_t SortKey_QuantizeDepth(float depth)
+	{
+		if (!(depth > 0.0f)) //also catches NaN
+			return 0;
+
+		uint32_t bits = 0;
+		memcpy(&bits, &depth, sizeof(float));
+		return (uint64_t)(bits >> (32 - SORT_KEY_DEPTH_BITS));
+	}
+
+	//strips the depth from a key leaving only the state
+	inline uint64_t SortKey_GetState(uint64_t key) { return key & ~((((uint64_t)1) << SORT_KEY_MESH_SHIFT) - 1); }
+
+	//gets the parts of a key
+	inline uint32_t SortKey_GetPipeline(uint64_t key) { return (uint32_t)((key >> SORT_KEY_PIPELINE_SHIFT) & (SORT_KEY_MAX_PIPELINES - 1)); }
+	inline uint32_t SortKey_GetLayout(uint64_t key) { return (uint32_t)((key >> SORT_KEY_LAYOUT_SHIFT) & (SORT_KEY_MAX_LAYOUTS - 1)); }
+	inline uint32_t SortKey_GetMesh(uint64_t key) { return (uint32_t)((key >> SORT_KEY_MESH_SHIFT) & (SORT_KEY_MAX_MESHES - 1)); }
+
+	//defines a item in the draw list
+	struct SortedDrawItem
+	{
+		uint64_t key = 0;
+		uint32_t drawIndex = 0; //the index of the draw this item came from
+	};
+
+	//LSD radix sorts the items by key, 8 bits a pass. Scratch must hold as many items as the list, it can be frame memory
+	//passes where every key has the same byte are skipped, so a list that only uses a few bits of the key only pays for those
+	inline void RadixSort_DrawItems(std::vector<SortedDrawItem>& items, SortedDrawItem* scratch)
+	{
+		const size_t count = items.size();
+		if (count < 2)
+			return;
+
+		SortedDrawItem* src = items.data();
+		SortedDrawItem* dst = scratch;
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			size_t offsets[256] = {};
+			for (size_t i = 0; i < count; ++i)
+				offsets[(src[i].key >> shift) & 0xFF]++;
+
+			//all keys share this byte, nothing to move
+			if (offsets[(src[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			size_t total = 0;
+			for (size_t b = 0; b < 256; ++b)
+			{
+				const size_t bucketSize = offsets[b];
+				offsets[b] = total;
+				total += bucketSize;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+				dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+			SortedDrawItem* temp = src; src = dst; dst = temp;
+		}
+
+		//the result ended up in the scratch
+		if (src != items.data())
+			memcpy(items.data(), src, count * sizeof(SortedDrawItem));
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+//defines the transform sync stage, pushing changed entity transforms into the render batches each frame
+
+#include <3DPong/ECS/Scene.hpp>
+#include <3DPong/Renderer/MeshRenderer.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+namespace Pong3D::Renderer
+{
+	//syncs the transforms the scene marked dirty into the batches and clears their flags, both the ECS's and the renderables'
+	//only the changed entities are touched, returns how many were synced
+	inline uint64_t SyncDirtyTransforms(Scene::Scene& scene, std::deque<RenderOperationBatch>& batches)
+	{
+		PONG3D_PROFILE_ZONE("Transform Sync");
+		uint64_t syncedCount = 0;
+		for (size_t i = 0; i < scene.dirtyTransforms.size(); ++i)
+		{
+			Smok::ECS::Comp::Transform* transform = BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(scene.dirtyTransforms[i]);
+			if (!transform || !transform->isDirty)
+				continue;
+
+			const glm::mat4 modelMatrix = transform->ModelMatrix();
+			for (size_t b = 0; b < batches.size(); ++b)
+				batches[b].UpdateTransform(scene.dirtyTransforms[i], modelMatrix);
+
+			transform->isDirty = false;
+			syncedCount++;
+		}
+
+		scene.dirtyTransforms.clear();
+
+		//the renderables, walked a chunk at a time and skipping the chunks where nothing moved
+		for (size_t c = 0; c < scene.renderables.chunksInUse; ++c)
+		{
+			ECS::RenderableChunk* chunk = scene.renderables.chunks[c].get();
+			if (chunk->dirtyCount == 0)
+				continue;
+
+			for (uint32_t i = 0; i < chunk->count; ++i)
+			{
+				if (!chunk->isDirty[i])
+					continue;
+
+				const glm::mat4 modelMatrix = chunk->ModelMatrix(i);
+				for (size_t b = 0; b < batches.size(); ++b)
+					batches[b].UpdateTransform(chunk->entityIDs[i], modelMatrix);
+
+				chunk->isDirty[i] = 0;
+				syncedCount++;
+			}
+			chunk->dirtyCount = 0;
+		}
+
+		return syncedCount;
+	}
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+//defines a match on the dedicated server, a scene and its physics stepped at the fixed time step with the replication snapshots sent to its two players
+//nothing here needs a GPU, it's built with PONG3D_SERVER so the scene leaves the engine out
+
+#include <3DPong/ECS/Scene.hpp>
+#include <3DPong/Physics/PongPhysics.hpp>
+#include <3DPong/Physics/PhysicsSceneSync.hpp>
+#include <3DPong/Network/RollbackSession.hpp>
+#include <3DPong/Network/SceneReplication.hpp>
+#include <3DPong/Network/SnapshotReplication.hpp>
+#include <3DPong/Network/UDPSocket.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <fmt/color.h>
+
+#include <array>
+#include <chrono>
+#include <random>
+
+namespace Pong3D::Server
+{
+	//how many players a match has, one for each paddle
+	static constexpr uint32_t MATCH_PLAYER_COUNT = 2;
+
+	//a player who hasn't sent anything for this long is dropped and their slot opened up again
+	static constexpr double MATCH_PLAYER_TIMEOUT_MS = 5000.0;
+
+	//the packet layout of what a client sends the server, the latest whole snapshot it has and its paddle's input
+	//magic (16) | type (8) | acked sequence (32) | input (2)
+	static constexpr uint8_t REPLICATION_PACKET_TYPE_CLIENT = 3;
+
+	//writes a client's packet, returns its size
+	inline size_t ClientPacket_Write(uint8_t* data, size_t capacity, uint32_t ackedSequence, Network::RollbackInput input)
+	{
+		Network::BitWriter writer;
+		writer.Start(data, capacity);
+		writer.Write(Network::REPLICATION_PACKET_MAGIC, 16);
+		writer.Write(REPLICATION_PACKET_TYPE_CLIENT, 8);
+		writer.Write(ackedSequence, 32);
+		writer.Write((uint32_t)input, 2);
+		return (writer.hasOverflowed ? 0 : writer.GetByteCount());
+	}
+
+	//reads a client's packet, returns false if it isn't one
+	inline bool ClientPacket_Read(const uint8_t* data, size_t size, uint32_t& ackedSequence, Network::RollbackInput& input)
+	{
+		Network::BitReader reader;
+		reader.Start(data, size);
+		if (reader.Read(16) != Network::REPLICATION_PACKET_MAGIC || reader.Read(8) != REPLICATION_PACKET_TYPE_CLIENT)
+			return false;
+
+		ackedSequence = reader.Read(32);
+		input = (Network::RollbackInput)reader.Read(2);
+		return !reader.hasOverflowed && input < Network::RollbackInput::Count;
+	}
+
+	//defines a client in the same process as the match, it's handed the packets directly instead of through a socket
+	//used as a bot to load test the server, it plays the same scripted input every run
+	struct LocalClient
+	{
+		Network::SnapshotDecoder decoder;
+		std::vector<Network::ReplicationPacket> inbox; //the packets the match sent this tick, reused
+		size_t inboxCount = 0;
+
+		uint32_t player = 0;
+		uint64_t tick = 0;
+
+		//reads what the match sent, then writes the packet back with its ack and input. Returns the packet's size
+		inline size_t Update(uint8_t* data, size_t capacity)
+		{
+			for (size_t i = 0; i < inboxCount; ++i)
+				decoder.ReadPacket(inbox[i].data.data(), inbox[i].size);
+			inboxCount = 0;
+
+			//holds a direction for a while then changes, like a person would
+			const float direction = (float)((tick++ / (23 + player * 14) + player) % 3) - 1.0f;
+			return ClientPacket_Write(data, capacity, decoder.latestSequence, Network::RollbackInput_FromDirection(direction));
+		}
+	};
+
+	//defines a player's slot in a match
+	struct MatchPlayer
+	{
+		bool isConnected = false;
+		Network::ReplicationClient client;
+		float direction = 0.0f; //the paddle input they last sent
+		double lastHeardMS = 0.0;
+
+		LocalClient* localClient = nullptr; //set if the player is in the same process
+	};
+
+	//defines the settings of a match
+	struct Match_CreateInfo
+	{
+		float fixedDeltaTime = 1.0f / 60.0f;
+		float paddleSpeed = 10.0f;
+		glm::vec3 paddleHalfExtents = glm::vec3(1.0f, 1.0f, 0.25f);
+		float ballRadius = 0.5f;
+		uint32_t ballCount = 1;
+		uint32_t seed = 42; //where the balls start and which way they go
+
+		Physics::PhysicsWorld_CreateInfo physics;
+
+		//the players connect to the match's own port, 0 lets the OS pick one. Off for a match only played by local clients
+		bool isNetworked = true;
+		uint16_t port = 0;
+	};
+
+	//defines the stats of a match
+	struct MatchStats
+	{
+		uint64_t ticks = 0;
+		double lastTickMS = 0.0, maxTickMS = 0.0, totalTickMS = 0.0; //the CPU time of a tick, what the match costs
+
+		uint64_t bytesSent = 0, packetsSent = 0, packetsReceived = 0, packetsRejected = 0;
+
+		//gets the average tick time
+		inline double GetAverageTickMS() const { return (ticks > 0 ? totalTickMS / (double)ticks : 0.0); }
+	};
+
+	//defines a match
+	struct Match
+	{
+		uint32_t matchIndex = 0;
+		float fixedDeltaTime = 1.0f / 60.0f;
+		float paddleSpeed = 10.0f;
+
+		Scene::Scene scene;
+		Physics::PhysicsWorld world;
+		Network::SnapshotEncoder encoder;
+
+		std::array<MatchPlayer, MATCH_PLAYER_COUNT> players;
+		Network::UDPSocket socket;
+
+		MatchStats stats;
+		bool isCreated = false;
+
+		//creates the match, the paddles and balls go in the scene and the physics world
+		inline bool Create(uint32_t _matchIndex, const Match_CreateInfo& info = Match_CreateInfo())
+		{
+			if (isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE SERVER WARNING: Match || Create || Match {} is already created!\n", matchIndex);
+				return true;
+			}
+
+			matchIndex = _matchIndex;
+			fixedDeltaTime = info.fixedDeltaTime;
+			paddleSpeed = info.paddleSpeed;
+			world.Create(info.physics);
+
+			//the server draws nothing, so the meshes are left empty
+			ECS::TransformComponent transform;
+			ECS::MeshRenderComponent meshRender;
+
+			const glm::vec3 arenaCenter = (info.physics.arenaMin + info.physics.arenaMax) * 0.5f;
+			for (uint32_t p = 0; p < MATCH_PLAYER_COUNT; ++p)
+			{
+				transform.position = glm::vec3(arenaCenter.x, arenaCenter.y, (p == 0 ? info.physics.arenaMin.z + 1.0f : info.physics.arenaMax.z - 1.0f));
+				const Scene::Entity paddle = scene.CreateEntity_Paddle("Paddle " + std::to_string(p + 1), transform, meshRender, nullptr);
+				world.paddles.Add(paddle.ID, transform.position, info.paddleHalfExtents);
+			}
+
+			std::mt19937 random(info.seed);
+			std::uniform_real_distribution<float> x(info.physics.arenaMin.x + info.ballRadius, info.physics.arenaMax.x - info.ballRadius),
+				y(info.physics.arenaMin.y + info.ballRadius, info.physics.arenaMax.y - info.ballRadius),
+				z(info.physics.arenaMin.z + 2.0f, info.physics.arenaMax.z - 2.0f), velocity(-6.0f, 6.0f);
+			world.balls.Reserve(info.ballCount);
+			for (uint32_t i = 0; i < info.ballCount; ++i)
+			{
+				transform.position = glm::vec3(x(random), y(random), z(random));
+				const Scene::Entity ball = scene.CreateEntity_Ball(transform, meshRender);
+				world.balls.Add(ball.ID, transform.position, glm::vec3(velocity(random), velocity(random), velocity(random)), info.ballRadius);
+			}
+
+			if (info.isNetworked && !socket.Open(info.port))
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE SERVER ERROR: Match || Create || Match {} failed to open its socket!\n", matchIndex);
+				return false;
+			}
+
+			isCreated = true;
+			return true;
+		}
+
+		//destroys the match
+		inline void Destroy()
+		{
+			if (!isCreated)
+				return;
+
+			socket.Close();
+			isCreated = false;
+		}
+
+		//gives a player's slot to a client in the same process
+		inline void SetLocalClient(uint32_t player, LocalClient* localClient)
+		{
+			players[player] = MatchPlayer();
+			players[player].isConnected = true;
+			players[player].localClient = localClient;
+			localClient->player = player;
+		}
+
+		//applies a player's ack and input from a packet that was already read
+		inline void ApplyClientPacket(uint32_t player, uint32_t ackedSequence, Network::RollbackInput input, double nowMS)
+		{
+			stats.packetsReceived++;
+			players[player].client.Ack(ackedSequence);
+			players[player].direction = Network::RollbackInput_ToDirection(input);
+			players[player].lastHeardMS = nowMS;
+		}
+
+		//reads a player's packet, their ack and input
+		inline void ReadClientPacket(uint32_t player, const uint8_t* data, size_t size, double nowMS)
+		{
+			uint32_t ackedSequence = Network::REPLICATION_NO_BASELINE;
+			Network::RollbackInput input = Network::RollbackInput::None;
+			if (!ClientPacket_Read(data, size, ackedSequence, input))
+			{
+				stats.packetsRejected++;
+				return;
+			}
+
+			ApplyClientPacket(player, ackedSequence, input, nowMS);
+		}
+
+		//reads the packets waiting on the socket, a new address takes the first open slot
+		//the packet is read before a slot is given out so stray traffic can't take the match's slots
+		inline void ReceivePackets(double nowMS)
+		{
+			uint8_t data[Network::MAX_PACKET_SIZE];
+			Network::NetAddress from;
+			size_t size = 0;
+			while ((size = socket.Receive(data, sizeof(data), from)) > 0)
+			{
+				uint32_t ackedSequence = Network::REPLICATION_NO_BASELINE;
+				Network::RollbackInput input = Network::RollbackInput::None;
+				if (!ClientPacket_Read(data, size, ackedSequence, input))
+				{
+					stats.packetsRejected++;
+					continue;
+				}
+
+				uint32_t player = MATCH_PLAYER_COUNT;
+				for (uint32_t p = 0; p < MATCH_PLAYER_COUNT && player == MATCH_PLAYER_COUNT; ++p)
+				{
+					if (players[p].isConnected && !players[p].localClient && players[p].client.address == from)
+						player = p;
+				}
+				for (uint32_t p = 0; p < MATCH_PLAYER_COUNT && player == MATCH_PLAYER_COUNT; ++p)
+				{
+					if (!players[p].isConnected)
+					{
+						player = p;
+						players[p] = MatchPlayer();
+						players[p].isConnected = true;
+						players[p].client.address = from;
+						fmt::print("Match {}: {} joined as player {}\n", matchIndex, from.ToString(), p + 1);
+					}
+				}
+
+				if (player == MATCH_PLAYER_COUNT)
+				{
+					stats.packetsRejected++;
+					continue;
+				}
+				ApplyClientPacket(player, ackedSequence, input, nowMS);
+			}
+
+			//drops the players who went quiet
+			for (uint32_t p = 0; p < MATCH_PLAYER_COUNT; ++p)
+			{
+				if (players[p].isConnected && !players[p].localClient && nowMS - players[p].lastHeardMS > MATCH_PLAYER_TIMEOUT_MS)
+				{
+					fmt::print("Match {}: player {} timed out\n", matchIndex, p + 1);
+					players[p] = MatchPlayer();
+				}
+			}
+		}
+
+		//sends a player the latest snapshot, as the changes since the one they acked
+		inline void SendSnapshot(MatchPlayer& player)
+		{
+			const size_t packetCount = encoder.EncodeForClient(player.client);
+			for (size_t i = 0; i < packetCount; ++i)
+			{
+				const Network::ReplicationPacket* packet = &encoder.packets[i];
+				if (player.localClient)
+				{
+					LocalClient* localClient = player.localClient;
+					if (localClient->inbox.size() <= localClient->inboxCount)
+						localClient->inbox.emplace_back();
+					Network::ReplicationPacket* copy = &localClient->inbox[localClient->inboxCount++];
+					copy->size = packet->size;
+					memcpy(copy->data.data(), packet->data.data(), packet->size);
+				}
+				else
+					socket.Send(player.client.address, packet->data.data(), packet->size);
+
+				stats.bytesSent += packet->size;
+			}
+			stats.packetsSent += packetCount;
+		}
+
+		//runs a tick, reads the players' packets, steps the physics, writes it into the scene and sends the snapshot
+		inline void Tick(double nowMS)
+		{
+			PONG3D_PROFILE_ZONE("Match Tick");
+			const auto start = std::chrono::steady_clock::now();
+
+			if (socket.IsOpen())
+				ReceivePackets(nowMS);
+
+			for (uint32_t p = 0; p < MATCH_PLAYER_COUNT; ++p)
+				world.paddles.SetVelocity(p, glm::vec3(0.0f, players[p].direction * paddleSpeed, 0.0f));
+			world.Step(fixedDeltaTime);
+			Physics::Physics_WriteToScene(world, scene);
+
+			Network::Replication_CaptureScene(scene, encoder);
+			for (uint32_t p = 0; p < MATCH_PLAYER_COUNT; ++p)
+			{
+				if (players[p].isConnected)
+					SendSnapshot(players[p]);
+			}
+
+			stats.lastTickMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			stats.maxTickMS = std::max(stats.maxTickMS, stats.lastTickMS);
+			stats.totalTickMS += stats.lastTickMS;
+			stats.ticks++;
+
+			//the local clients are the players' machines, they run outside the tick's time
+			for (uint32_t p = 0; p < MATCH_PLAYER_COUNT; ++p)
+			{
+				if (!players[p].localClient)
+					continue;
+
+				uint8_t data[Network::MAX_PACKET_SIZE];
+				const size_t size = players[p].localClient->Update(data, sizeof(data));
+				ReadClientPacket(p, data, size, nowMS);
+			}
+		}
+	};
+}
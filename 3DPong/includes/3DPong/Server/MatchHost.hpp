@@ -0,0 +1,189 @@
+#pragma once
+
+//defines hosting many matches in one server process, every match is ticked at the fixed time step across a worker pool
+//each match's tick is timed so the cost of a match, and how many fit on a core, can be read off a running server
+
+#include <3DPong/Server/Match.hpp>
+#include <3DPong/Threading/WorkerPool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace Pong3D::Server
+{
+	//defines the settings of the host
+	struct MatchHost_CreateInfo
+	{
+		uint32_t matchCount = 1;
+		uint32_t workerCount = 0; //0 uses every hardware thread, the host's own thread only waits on them
+		uint32_t maxTicksPerUpdate = 5; //ticks past this are dropped after a long stall so it doesn't spiral
+
+		Match_CreateInfo match;
+		uint16_t firstPort = 27100; //match i listens on firstPort + i, 0 lets the OS pick each one
+
+		uint32_t localClientsPerMatch = 0; //bots played in process, for load testing without real clients
+		bool isUnthrottled = false; //ticks as fast as it can instead of at the fixed time step, for measuring the cost
+	};
+
+	//defines the stats of the host
+	struct MatchHostStats
+	{
+		uint64_t ticks = 0;
+		uint64_t droppedTicks = 0;
+		double lastTickMS = 0.0, maxTickMS = 0.0, totalTickMS = 0.0; //the wall time to tick every match
+
+		//gets the average wall time to tick every match
+		inline double GetAverageTickMS() const { return (ticks > 0 ? totalTickMS / (double)ticks : 0.0); }
+	};
+
+	//defines the match host
+	struct MatchHost
+	{
+		std::vector<std::unique_ptr<Match>> matches;
+		std::vector<std::unique_ptr<LocalClient>> localClients;
+
+		Threading::WorkerPool workers;
+		std::atomic<uint32_t> nextMatch{ 0 }; //the workers take the matches off this in turn, so a slow match doesn't hold up the rest
+
+		float fixedDeltaTime = 1.0f / 60.0f;
+		uint32_t maxTicksPerUpdate = 5;
+		bool isUnthrottled = false;
+
+		std::chrono::steady_clock::time_point startTime, nextTickTime;
+		MatchHostStats stats;
+		bool isCreated = false;
+
+		//creates the matches and starts the workers
+		inline bool Create(const MatchHost_CreateInfo& info = MatchHost_CreateInfo())
+		{
+			if (isCreated)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE SERVER WARNING: Match Host || Create || The host is already created!\n");
+				return true;
+			}
+
+			if (info.matchCount == 0 || info.match.fixedDeltaTime <= 0.0f || info.localClientsPerMatch > MATCH_PLAYER_COUNT)
+			{
+				fmt::print(fmt::fg(fmt::color::red), "PS ENGINE SERVER ERROR: Match Host || Create || A match, a fixed time step above 0 and at most {} local clients a match are needed!\n",
+					MATCH_PLAYER_COUNT);
+				return false;
+			}
+
+			fixedDeltaTime = info.match.fixedDeltaTime;
+			maxTicksPerUpdate = (info.maxTicksPerUpdate > 0 ? info.maxTicksPerUpdate : 1);
+			isUnthrottled = info.isUnthrottled;
+
+			matches.reserve(info.matchCount);
+			for (uint32_t m = 0; m < info.matchCount; ++m)
+			{
+				Match_CreateInfo matchInfo = info.match;
+				matchInfo.seed = info.match.seed + m;
+				matchInfo.port = (info.firstPort > 0 ? (uint16_t)(info.firstPort + m) : 0);
+
+				Match* match = matches.emplace_back(std::make_unique<Match>()).get();
+				if (!match->Create(m, matchInfo))
+				{
+					Destroy();
+					return false;
+				}
+
+				for (uint32_t p = 0; p < info.localClientsPerMatch; ++p)
+					match->SetLocalClient(p, localClients.emplace_back(std::make_unique<LocalClient>()).get());
+			}
+
+			workers.Init(info.workerCount > 0 ? info.workerCount : std::max(1u, std::thread::hardware_concurrency()));
+
+			startTime = std::chrono::steady_clock::now();
+			nextTickTime = startTime;
+			isCreated = true;
+			return true;
+		}
+
+		//stops the workers and destroys the matches
+		inline void Destroy()
+		{
+			workers.Shutdown();
+			for (size_t m = 0; m < matches.size(); ++m)
+				matches[m]->Destroy();
+			matches.clear();
+			localClients.clear();
+			isCreated = false;
+		}
+
+		//ticks every match once on the workers and waits for them
+		inline void TickAll()
+		{
+			PONG3D_PROFILE_ZONE("Match Host Tick");
+			const auto start = std::chrono::steady_clock::now();
+			const double nowMS = std::chrono::duration<double, std::milli>(start - startTime).count();
+
+			nextMatch.store(0, std::memory_order_relaxed);
+			workers.Run([this, nowMS](uint32_t workerIndex) {
+				uint32_t m = 0;
+				while ((m = nextMatch.fetch_add(1, std::memory_order_relaxed)) < (uint32_t)matches.size())
+					matches[m]->Tick(nowMS);
+				});
+
+			stats.lastTickMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			stats.maxTickMS = std::max(stats.maxTickMS, stats.lastTickMS);
+			stats.totalTickMS += stats.lastTickMS;
+			stats.ticks++;
+		}
+
+		//waits for the next tick to be due then runs every tick that is, returns how many ran
+		inline uint32_t Update()
+		{
+			if (isUnthrottled)
+			{
+				TickAll();
+				return 1;
+			}
+
+			using Clock = std::chrono::steady_clock;
+			const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(fixedDeltaTime));
+			const Clock::time_point now = Clock::now();
+			if (now < nextTickTime)
+				std::this_thread::sleep_for(nextTickTime - now);
+
+			uint32_t tickCount = 0;
+			while (nextTickTime <= Clock::now())
+			{
+				//a long stall would take more ticks than can be caught up on, the time is dropped instead
+				if (tickCount == maxTicksPerUpdate)
+				{
+					const uint64_t dropped = (uint64_t)((Clock::now() - nextTickTime) / tickDuration) + 1;
+					stats.droppedTicks += dropped;
+					nextTickTime += tickDuration * dropped;
+					break;
+				}
+
+				TickAll();
+				nextTickTime += tickDuration;
+				tickCount++;
+			}
+
+			return tickCount;
+		}
+
+		//gets the average CPU time of a match's tick across every match
+		inline double GetAverageMatchTickMS() const
+		{
+			double totalMS = 0.0;
+			uint64_t ticks = 0;
+			for (size_t m = 0; m < matches.size(); ++m)
+			{
+				totalMS += matches[m]->stats.totalTickMS;
+				ticks += matches[m]->stats.ticks;
+			}
+			return (ticks > 0 ? totalMS / (double)ticks : 0.0);
+		}
+
+		//gets how many matches a core can tick at the fixed time step, from the average cost of a match
+		inline double GetMatchesPerCore() const
+		{
+			const double averageMS = GetAverageMatchTickMS();
+			return (averageMS > 0.0 ? fixedDeltaTime * 1000.0 / averageMS : 0.0);
+		}
+	};
+}
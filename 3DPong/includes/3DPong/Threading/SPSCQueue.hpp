@@ -0,0 +1,60 @@
+#pragma once
+
+//defines a lock free queue for one thread pushing and one thread popping, neither ever waits
+//a fixed ring, a push onto a full queue fails rather than growing it
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pong3D::Threading
+{
+	//defines a single producer single consumer queue, the capacity must be a power of two
+	template<typename T, size_t CAPACITY>
+	struct SPSCQueue
+	{
+		static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity of a SPSC queue must be a power of two");
+
+		T items[CAPACITY];
+
+		//each end on its own cache line so the threads don't fight over it
+		alignas(64) std::atomic<uint64_t> head{ 0 }; //the next to pop, only the consumer writes it
+		alignas(64) std::atomic<uint64_t> tail{ 0 }; //the next to push, only the producer writes it
+
+		//pushes a item, returns false if the queue is full. Producer only
+		inline bool Push(const T& item)
+		{
+			const uint64_t currentTail = tail.load(std::memory_order_relaxed);
+			if (currentTail - head.load(std::memory_order_acquire) >= CAPACITY)
+				return false;
+
+			items[currentTail & (CAPACITY - 1)] = item;
+			tail.store(currentTail + 1, std::memory_order_release);
+			return true;
+		}
+
+		//gets the next item without popping it, nullptr if the queue is empty. Consumer only
+		inline const T* Peek() const
+		{
+			const uint64_t currentHead = head.load(std::memory_order_relaxed);
+			if (currentHead == tail.load(std::memory_order_acquire))
+				return nullptr;
+			return &items[currentHead & (CAPACITY - 1)];
+		}
+
+		//pops the next item, returns false if the queue is empty. Consumer only
+		inline bool Pop(T& item)
+		{
+			const T* next = Peek();
+			if (!next)
+				return false;
+
+			item = *next;
+			head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			return true;
+		}
+
+		//gets about how many items are waiting, exact only from the producer or consumer when the other is idle
+		inline size_t Size() const { return (size_t)(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)); }
+	};
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+//defines a pool of background threads that each take the next task off a shared queue, used for work that spans frames like loading assets
+
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <fmt/color.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Pong3D::Threading
+{
+	//defines a queued task, the drop function is called instead of it if the queue shuts down before it runs
+	struct QueuedTask
+	{
+		std::function<void()> task;
+		std::function<void()> drop;
+	};
+
+	//defines a task queue
+	struct TaskQueue
+	{
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable wakeCondition;
+
+		std::deque<QueuedTask> tasks;
+		bool isRunning = false;
+
+		//starts the threads
+		inline bool Init(uint32_t threadCount = 2)
+		{
+			if (isRunning)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE THREADING WARNING: Task Queue || Init || The queue is already running!\n");
+				return true;
+			}
+
+			if (threadCount == 0)
+				threadCount = 1;
+
+			isRunning = true;
+			threads.reserve(threadCount);
+			for (uint32_t i = 0; i < threadCount; ++i)
+				threads.emplace_back([this, i]() { WorkerLoop(i); });
+
+			return true;
+		}
+
+		//stops the threads, the tasks being run are finished and the ones still queued are dropped
+		//the drop functions run on the calling thread once the threads have stopped, so anything waiting on a dropped task is released
+		inline void Shutdown()
+		{
+			if (!isRunning)
+				return;
+
+			std::deque<QueuedTask> droppedTasks;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isRunning = false;
+				droppedTasks.swap(tasks);
+			}
+			wakeCondition.notify_all();
+
+			for (size_t i = 0; i < threads.size(); ++i)
+				threads[i].join();
+			threads.clear();
+
+			for (size_t i = 0; i < droppedTasks.size(); ++i)
+			{
+				if (droppedTasks[i].drop)
+					droppedTasks[i].drop();
+			}
+		}
+
+		//gets the number of threads
+		inline uint32_t GetThreadCount() const { return (uint32_t)threads.size(); }
+
+		//queues a task, it runs on the next free thread. If the queue isn't running the task is dropped right away
+		inline void Push(std::function<void()> task, std::function<void()> drop = nullptr)
+		{
+			bool isQueued = false;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (isRunning)
+				{
+					tasks.emplace_back(QueuedTask{ std::move(task), drop });
+					isQueued = true;
+				}
+			}
+
+			if (!isQueued)
+			{
+				if (drop)
+					drop();
+				return;
+			}
+			wakeCondition.notify_one();
+		}
+
+		//gets how many tasks haven't been started
+		inline size_t GetQueuedCount()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return tasks.size();
+		}
+
+		//the loop each thread runs until the queue shuts down
+		inline void WorkerLoop(uint32_t threadIndex)
+		{
+			PONG3D_PROFILE_THREAD("Task Queue " + std::to_string(threadIndex));
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wakeCondition.wait(lock, [this]() { return !isRunning || !tasks.empty(); });
+					if (!isRunning)
+						return;
+
+					task = std::move(tasks.front().task);
+					tasks.pop_front();
+				}
+
+				task();
+			}
+		}
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+//defines a lock free triple buffer, one thread writes while another reads and neither ever waits
+//the writer fills its buffer and swaps it with the middle one, the reader swaps the middle one out when there's a new one
+
+#include <atomic>
+#include <cstdint>
+
+namespace Pong3D::Threading
+{
+	//defines a triple buffer, the buffers are kept so their memory is reused
+	template<typename T>
+	struct TripleBuffer
+	{
+		//the middle buffer's index and whether the writer has put a new one there since the reader last took it
+		static constexpr uint32_t FRESH_BIT = 0x4;
+		static constexpr uint32_t INDEX_MASK = 0x3;
+
+		T buffers[3];
+		std::atomic<uint32_t> middle{ 1 };
+		uint32_t writeIndex = 0; //only the writer touches it
+		uint32_t readIndex = 2; //only the reader touches it
+
+		//gets the buffer to fill, writer only
+		inline T& GetWriteBuffer() { return buffers[writeIndex]; }
+
+		//hands the filled buffer to the reader, the writer gets the old middle buffer to fill next
+		inline void Publish()
+		{
+			const uint32_t old = middle.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+			writeIndex = old & INDEX_MASK;
+		}
+
+		//takes the newest buffer if there is one, returns false if nothing was published since the last call. Reader only
+		inline bool Acquire()
+		{
+			if (!(middle.load(std::memory_order_relaxed) & FRESH_BIT))
+				return false;
+
+			const uint32_t old = middle.exchange(readIndex, std::memory_order_acq_rel);
+			readIndex = old & INDEX_MASK;
+			return true;
+		}
+
+		//gets the buffer the reader took last, reader only
+		inline const T& GetReadBuffer() const { return buffers[readIndex]; }
+	};
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+//defines a pool of worker threads that all run the same job, used for splitting per frame work across cores
+
+#include <3DPong/Profiling/CPUProfiler.hpp>
+
+#include <fmt/color.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Pong3D::Threading
+{
+	//defines a worker pool
+	struct WorkerPool
+	{
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable wakeCondition, doneCondition;
+
+		std::function<void(uint32_t)> job; //the job every worker runs, gets the worker's index
+		uint64_t jobGeneration = 0; //increased every dispatch so sleeping workers know there is new work
+		uint32_t workersRemaining = 0; //how many workers haven't finished the current job
+		bool isRunning = false;
+
+		//the number of workers to use when none is given, leaves the calling thread a core
+		static inline uint32_t GetDefaultWorkerCount()
+		{
+			const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			return (hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+		}
+
+		//starts the workers
+		inline bool Init(uint32_t workerCount = 0)
+		{
+			if (isRunning)
+			{
+				fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE THREADING WARNING: Worker Pool || Init || The pool is already running!\n");
+				return true;
+			}
+
+			if (workerCount == 0)
+				workerCount = GetDefaultWorkerCount();
+
+			isRunning = true;
+			threads.reserve(workerCount);
+			for (uint32_t i = 0; i < workerCount; ++i)
+				threads.emplace_back([this, i]() { WorkerLoop(i); });
+
+			return true;
+		}
+
+		//stops the workers, waits for the current job to finish
+		inline void Shutdown()
+		{
+			if (!isRunning)
+				return;
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isRunning = false;
+			}
+			wakeCondition.notify_all();
+
+			for (size_t i = 0; i < threads.size(); ++i)
+				threads[i].join();
+			threads.clear();
+		}
+
+		//gets the number of workers
+		inline uint32_t GetWorkerCount() const { return (uint32_t)threads.size(); }
+
+		//starts the job on every worker, does not wait. Call Wait before dispatching again
+		inline void Dispatch(const std::function<void(uint32_t workerIndex)>& _job)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = _job;
+				workersRemaining = (uint32_t)threads.size();
+				jobGeneration++;
+			}
+			wakeCondition.notify_all();
+		}
+
+		//waits until every worker has finished the dispatched job
+		inline void Wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			doneCondition.wait(lock, [this]() { return workersRemaining == 0; });
+		}
+
+		//runs the job on every worker and waits for them
+		//the job only has to live until the workers are done, so it's held by reference and its captures never heap allocate
+		template<typename Job>
+		inline void Run(const Job& _job)
+		{
+			Dispatch(std::cref(_job));
+			Wait();
+		}
+
+		//the loop each worker runs until the pool shuts down
+		inline void WorkerLoop(uint32_t workerIndex)
+		{
+			PONG3D_PROFILE_THREAD("Worker " + std::to_string(workerIndex));
+			uint64_t lastGeneration = 0;
+			while (true)
+			{
+				std::function<void(uint32_t)>* currentJob = nullptr;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wakeCondition.wait(lock, [&]() { return !isRunning || jobGeneration != lastGeneration; });
+					if (!isRunning)
+						return;
+
+					lastGeneration = jobGeneration;
+					currentJob = &job;
+				}
+
+				{
+					PONG3D_PROFILE_ZONE("Worker Job");
+					(*currentJob)(workerIndex);
+				}
+
+				bool isLast = false;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					isLast = (--workersRemaining == 0);
+				}
+				if (isLast)
+					doneCondition.notify_all();
+			}
+		}
+	};
+}
@@ -0,0 +1,97 @@
+//the dedicated server, hosts many matches with no window or GPU and reports what each costs
+//usage: 3DPongServer [--matches N] [--balls N] [--port N] [--workers N] [--bots N] [--offline] [--unthrottled] [--ticks N]
+
+#include <3DPong/Server/MatchHost.hpp>
+
+#include <csignal>
+#include <string>
+
+//how often the report is printed
+static constexpr uint64_t REPORT_INTERVAL_TICKS = 60 * 5;
+
+//set by Ctrl+C, the server finishes the tick and shuts down
+static std::atomic<bool> isRunning{ true };
+
+//prints what the matches cost
+static void PrintReport(const Pong3D::Server::MatchHost& host)
+{
+	double worstAverageMS = 0.0, worstTickMS = 0.0;
+	uint64_t bytesSent = 0, connectedPlayers = 0;
+	for (size_t m = 0; m < host.matches.size(); ++m)
+	{
+		const Pong3D::Server::Match* match = host.matches[m].get();
+		worstAverageMS = std::max(worstAverageMS, match->stats.GetAverageTickMS());
+		worstTickMS = std::max(worstTickMS, match->stats.maxTickMS);
+		bytesSent += match->stats.bytesSent;
+		for (uint32_t p = 0; p < Pong3D::Server::MATCH_PLAYER_COUNT; ++p)
+			connectedPlayers += (match->players[p].isConnected ? 1 : 0);
+	}
+
+	const double seconds = (double)host.stats.ticks * host.fixedDeltaTime;
+	fmt::print("{} ticks: {} matches, {} players, host tick {:.3f} ms avg {:.3f} ms max, {} dropped\n", host.stats.ticks, host.matches.size(), connectedPlayers,
+		host.stats.GetAverageTickMS(), host.stats.maxTickMS, host.stats.droppedTicks);
+	fmt::print("    match tick {:.4f} ms avg, worst match {:.4f} ms avg {:.3f} ms max, {:.1f} matches per core, {:.1f} KB/s sent a match\n",
+		host.GetAverageMatchTickMS(), worstAverageMS, worstTickMS, host.GetMatchesPerCore(),
+		(seconds > 0.0 ? (double)bytesSent / 1024.0 / seconds / (double)host.matches.size() : 0.0));
+}
+
+//entry point
+int main(int argc, char** argv)
+{
+	Pong3D::Server::MatchHost_CreateInfo info;
+	uint64_t tickLimit = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		const bool hasValue = (i + 1 < argc);
+		if (option == "--matches" && hasValue)
+			info.matchCount = (uint32_t)std::stoul(argv[++i]);
+		else if (option == "--balls" && hasValue)
+			info.match.ballCount = (uint32_t)std::stoul(argv[++i]);
+		else if (option == "--port" && hasValue)
+			info.firstPort = (uint16_t)std::stoul(argv[++i]);
+		else if (option == "--workers" && hasValue)
+			info.workerCount = (uint32_t)std::stoul(argv[++i]);
+		else if (option == "--bots" && hasValue)
+			info.localClientsPerMatch = (uint32_t)std::stoul(argv[++i]);
+		else if (option == "--ticks" && hasValue)
+			tickLimit = std::stoull(argv[++i]);
+		else if (option == "--offline")
+			info.match.isNetworked = false;
+		else if (option == "--unthrottled")
+			info.isUnthrottled = true;
+		else
+		{
+			fmt::print(fmt::fg(fmt::color::red), "Unknown option \"{}\"!\n", option);
+			fmt::print("usage: 3DPongServer [--matches N] [--balls N] [--port N] [--workers N] [--bots N] [--offline] [--unthrottled] [--ticks N]\n");
+			return -1;
+		}
+	}
+
+	Pong3D::Server::MatchHost host;
+	if (!host.Create(info))
+		return -1;
+
+	fmt::print("Hosting {} matches of {} balls on {} workers", info.matchCount, info.match.ballCount, host.workers.GetWorkerCount());
+	if (info.match.isNetworked)
+		fmt::print(", ports {} to {}", host.matches.front()->socket.port, host.matches.back()->socket.port);
+	fmt::print("\n");
+
+	std::signal(SIGINT, [](int) { isRunning = false; });
+
+	uint64_t lastReportTick = 0;
+	while (isRunning && (tickLimit == 0 || host.stats.ticks < tickLimit))
+	{
+		host.Update();
+		if (host.stats.ticks - lastReportTick >= REPORT_INTERVAL_TICKS)
+		{
+			PrintReport(host);
+			lastReportTick = host.stats.ticks;
+		}
+	}
+
+	if (host.stats.ticks != lastReportTick)
+		PrintReport(host);
+	host.Destroy();
+	return 0;
+}
@@ -4,17 +4,20 @@ layout (location = 1) in vec3 vNormal;
 layout (location = 2) in vec3 vColor;
 layout (location = 3) in vec2 textureCords;
 
+//per instance data, a mat4 takes up 4 locations
+layout (location = 4) in mat4 instanceModelMatrix;
+
 layout (location = 0) out vec3 outColor;
 
 //push constants block
 layout( push_constant ) uniform constants
 {
-	mat4 render_matrix;
+	mat4 render_matrix; //the projection * view, the model comes from the instance
  	vec4 color;
 } PushConstants;
 
 void main() 
 {	
-	gl_Position = PushConstants.render_matrix * vec4(vPosition, 1.0f);
+	gl_Position = PushConstants.render_matrix * instanceModelMatrix * vec4(vPosition, 1.0f);
 	outColor = vColor * PushConstants.color.xyz;
 }
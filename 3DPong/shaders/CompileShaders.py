@@ -2,10 +2,21 @@
 
 import sys
 import os
+import shutil
 import subprocess
 
-#the tool for compiling shaders
+#the tool for compiling shaders, the GLSLC environment variable or the Vulkan SDK's glslc are used if they're there
 SPRV_COMPILING_TOOL_DIR = "C:/VulkanSDK/1.3.283.0/Bin/glslc.exe"
+if(os.environ.get("GLSLC")):
+    SPRV_COMPILING_TOOL_DIR = os.environ["GLSLC"]
+elif(os.environ.get("VULKAN_SDK")):
+    for binDir in ["Bin", "bin"]:
+        for toolName in ["glslc.exe", "glslc"]:
+            toolPath = os.path.join(os.environ["VULKAN_SDK"], binDir, toolName)
+            if(os.path.isfile(toolPath)):
+                SPRV_COMPILING_TOOL_DIR = toolPath
+elif(shutil.which("glslc")):
+    SPRV_COMPILING_TOOL_DIR = shutil.which("glslc")
 
 #gets the path passed in for the code dir and the compiled code dir, or sets to default
 codeDir = "Code"
@@ -21,7 +32,20 @@ if(os.path.isdir(outputDir) == False):
 #gets the files in the code directory
 shaders = os.listdir(codeDir)
 
-#goes through the code dir and compile them
+#goes through the code dir and compile them, a shader that fails stops the build so a stale binary is never shipped
+failed = False
 for shader in shaders:
-    subprocess.call([SPRV_COMPILING_TOOL_DIR, codeDir + "/" + shader, "-o", outputDir + "/" + shader + ".spv"])
-    print(shader + " compiled...")
\ No newline at end of file
+    try:
+        result = subprocess.call([SPRV_COMPILING_TOOL_DIR, codeDir + "/" + shader, "-o", outputDir + "/" + shader + ".spv"])
+    except OSError:
+        print("Failed to run " + SPRV_COMPILING_TOOL_DIR + ", set GLSLC or VULKAN_SDK to where glslc is")
+        sys.exit(1)
+
+    if(result != 0):
+        print(shader + " failed to compile!")
+        failed = True
+    else:
+        print(shader + " compiled...")
+
+if(failed):
+    sys.exit(1)
@@ -10,13 +10,27 @@ Test rendering project Pong remade in 3D with the new Bytes The Dust Standard Li
 #include <3DPong/Engine.hpp>
 #include <3DPong/Renderer/FrameManager.hpp>
 #include <3DPong/Renderer/MeshRenderer.hpp>
+#include <3DPong/Renderer/TransformSync.hpp>
+#include <3DPong/Renderer/BatchRecorder.hpp>
+#include <3DPong/Renderer/ProfilerOverlay.hpp>
+#include <3DPong/Renderer/FrameLimiter.hpp>
+#include <3DPong/Renderer/MeshPool.hpp>
+#include <3DPong/Renderer/PipelineCache.hpp>
+#include <3DPong/Renderer/PipelineRegistry.hpp>
+#include <3DPong/Renderer/MeshPipeline.hpp>
 #include <3DPong/ECS/Scene.hpp>
+#include <3DPong/Assets/AssetStreamer.hpp>
+#include <3DPong/Physics/PongPhysics.hpp>
+#include <3DPong/Physics/PhysicsSceneSync.hpp>
+#include <3DPong/Physics/SimulationThread.hpp>
+#include <3DPong/Network/RollbackSession.hpp>
+#include <3DPong/Input/InputSampler.hpp>
+#include <3DPong/Profiling/CPUProfiler.hpp>
+#include <3DPong/Memory/AllocationCounter.hpp>
 
 #include <BTDSTD/Time.hpp>
-#include <BTDSTD/Input/KeyInput.hpp>
 
 #include <BTDSTD/Wireframe/Core/GPU.hpp>
-#include <BTDSTD/Wireframe/Core/DesktopSwapchain.hpp>
 #include <BTDSTD/Wireframe/Core/DesktopWindow.hpp>
 		 
 #include <BTDSTD/Wireframe/Renderpass.hpp>
@@ -41,80 +55,118 @@ Test rendering project Pong remade in 3D with the new Bytes The Dust Standard Li
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
-void init_pipelines(
-	Smok::Asset::AssetManager::Asset_PipelineLayout& pipelineLayout, Smok::Asset::AssetManager::Asset_GraphicsPipeline& pipeline,
-	Wireframe::Renderpass::Renderpass& renderpass,
-	Pong3D::Core::Engine* engine)
-{
-	Wireframe::Device::GPU* GPU = &engine->GPU;
-
-	//loads a pipeline settings
-	Wireframe::Pipeline::PipelineSettings pipelineSettings;
-	Wireframe::Pipeline::Serilize::LoadPipelineSettingsDataFromFile(pipeline.pipelineDataSettingFile, pipelineSettings);
-
-	//sets the vertex layout
-	Wireframe::Pipeline::VertexInputDescription vertexDescription = Smok::Asset::Mesh::Vertex::GenerateVertexInputDescription();
-	pipelineSettings._vertexInputInfo.pVertexAttributeDescriptions = vertexDescription.attributes.data();
-	pipelineSettings._vertexInputInfo.vertexAttributeDescriptionCount = vertexDescription.attributes.size();
-	pipelineSettings._vertexInputInfo.pVertexBindingDescriptions = vertexDescription.bindings.data();
-	pipelineSettings._vertexInputInfo.vertexBindingDescriptionCount = vertexDescription.bindings.size();
-
-	//loads the shaders
-	Wireframe::Shader::ShaderModule meshVertShader;
-	Wireframe::Shader::Serilize::ShaderSerilizeData vertex;
-	Wireframe::Shader::Serilize::LoadShaderDataFromFile(pipeline.vertexShaderDataSettingFile,
-		vertex, false);
-	if (!meshVertShader.Create(vertex.binaryFilepath.c_str(), GPU)) {}
-	
-	Wireframe::Shader::ShaderModule meshFragShader;
-	Wireframe::Shader::Serilize::ShaderSerilizeData fragment;
-	Wireframe::Shader::Serilize::LoadShaderDataFromFile(pipeline.fragmentShaderDataSettingFile,
-		fragment, false);
-	if (!meshFragShader.Create(fragment.binaryFilepath.c_str(), GPU)) {}
-	
-	pipelineSettings._shaderStages = { Wireframe::Shader::GenerateShaderStageInfoForPipeline(meshVertShader, Wireframe::Shader::Util::ShaderStage::Vertex),
-		Wireframe::Shader::GenerateShaderStageInfoForPipeline(meshFragShader, Wireframe::Shader::Util::ShaderStage::Fragment) };
-
-	//generates a layout and the push constants
-	Wireframe::Pipeline::PipelineLayout_CreateInfo pipelineLayoutInfo;
-	Wireframe::Pipeline::PushConstant p;
-	Wireframe::Pipeline::Serilize::LoadPipelineLayoutPushConstantDataFromFile(pipelineLayout.pushConstantDataSettingFile,
-		p);
-	p.size = sizeof(Pong3D::Renderer::MeshPushConstants);
-	pipelineLayoutInfo.pushConstants.emplace_back(p);
-
-	pipelineLayout.asset.Create(pipelineLayoutInfo, GPU);
-	pipelineLayout.assetIsCreated = true;
-	pipeline.asset.Create(pipelineSettings, pipelineLayout.asset, renderpass._renderPass, GPU);
-	pipeline.assetIsCreated = true;
-
-	meshFragShader.Destroy(GPU);
-	meshVertShader.Destroy(GPU);
-}
-
 //defines a input compoent for Pong Bars
 struct PlayerInputComponent : public BTD::ECS::Comp::IComponent
 {
 	//the up and down key
 	SDL_Scancode upKey = SDL_SCANCODE_W, downKey = SDL_SCANCODE_S;
+
+	uint32_t paddleIndex = 0; //the paddle in the physics world it moves
+	int32_t controller = -1; //the game controller that also moves it, -1 for none
 };
 
 //defines a editor camera input component, used in debug
 
-//defines a network component
+//how many extra Guitars to spawn for stress testing the instanced renderer, 0 disables the benchmark scene
+static constexpr uint32_t BENCHMARK_GUITAR_INSTANCE_COUNT = 0;
+
+//uses the GPU driven path, a compute pass culls the instances and the draws are indirect
+static constexpr bool GPU_DRIVEN_RENDERING = false;
+
+//culls the instances outside the camera or past the draw distance on the CPU, 0 disables the distance cull
+static constexpr bool CPU_CULLING = true;
+static constexpr float MAX_DRAW_DISTANCE = 500.0f;
+
+//how the window presents, FIFO waits for vblank. Mailbox, or immediate with tearing, don't wait and pair with MAX_FPS
+//low latency only lets the CPU queue one frame ahead of the GPU, so the input it latches is older by at most a frame
+static constexpr Pong3D::Platform::PresentMode PRESENT_MODE = Pong3D::Platform::PresentMode::Fifo;
+static constexpr bool LOW_LATENCY_MODE = false;
+
+//caps the frame rate, 0 leaves it to the present mode. A minimized window only samples input and takes snapshots, so it's held much lower
+static constexpr float MAX_FPS = 0.0f;
+static constexpr float MINIMIZED_FPS = 20.0f;
+
+//where the pipeline cache is kept between runs
+static const char* PIPELINE_CACHE_FILEPATH = "PipelineCache.bin";
+
+//the size of the static mesh pool, every static mesh's geometry is sub allocated out of it
+static constexpr uint32_t STATIC_MESH_POOL_MAX_VERTICES = 1024 * 1024;
+static constexpr uint32_t STATIC_MESH_POOL_MAX_INDICES = 4 * 1024 * 1024;
+
+//times the frame's GPU work with timestamp queries, the results show in the profiler overlay
+//pipeline statistics also need the pipelineStatisticsQuery device feature
+static constexpr bool GPU_PROFILING = true;
+static constexpr bool GPU_PIPELINE_STATISTICS = false;
+
+//how many threads load and decode assets in the background
+static constexpr uint32_t ASSET_LOADER_THREAD_COUNT = 2;
+
+//where the CPU profiler's trace is written, on F9 and at shutdown. Open it in chrome://tracing or Perfetto
+static const char* CPU_TRACE_FILEPATH = "CPUTrace.json";
+
+//how fast the camera flies, in units a second
+static constexpr float CAMERA_SPEED = 15.0f;
+
+//the physics of the paddles and balls, stepped at the fixed time step on the simulation thread
+static constexpr float PADDLE_SPEED = 10.0f;
+static const glm::vec3 PADDLE_HALF_EXTENTS = glm::vec3(1.0f, 1.0f, 0.25f);
+static constexpr float BALL_RADIUS = 0.5f;
+
+//how many extra balls to spawn for stress testing the physics, 0 disables it
+static constexpr uint32_t PHYSICS_STRESS_BALL_COUNT = 0;
+
+//how the frame is recorded, big scenes split the recording across the cores
+static constexpr Pong3D::Renderer::FrameRecordMode RENDER_RECORD_MODE = (BENCHMARK_GUITAR_INSTANCE_COUNT > 0 ?
+	Pong3D::Renderer::FrameRecordMode::ParallelSecondary : Pong3D::Renderer::FrameRecordMode::Inline);
+
+//counts the heap allocations so the Scene window can show how many a frame makes, the steady state frames should make none
+PONG3D_DEFINE_ALLOCATION_COUNTER()
+
+//moves the camera with WASD or the first controller's right stick, the speed is kept the same whatever the frame rate
+static void Camera_Move(Smok::ECS::Comp::Transform* camTrans, const Pong3D::Input::InputState& input, float deltaTime)
+{
+	const float forward = (input.IsKeyHeld(SDL_SCANCODE_W) ? 1.0f : 0.0f) - (input.IsKeyHeld(SDL_SCANCODE_S) ? 1.0f : 0.0f) -
+		input.GetAxis(0, SDL_CONTROLLER_AXIS_RIGHTY, 0.25f);
+	const float left = (input.IsKeyHeld(SDL_SCANCODE_A) ? 1.0f : 0.0f) - (input.IsKeyHeld(SDL_SCANCODE_D) ? 1.0f : 0.0f) -
+		input.GetAxis(0, SDL_CONTROLLER_AXIS_RIGHTX, 0.25f);
+	if (forward == 0.0f && left == 0.0f)
+		return;
+
+	camTrans->isDirty = true;
+	camTrans->position += camTrans->Forward() * (-CAMERA_SPEED * forward * deltaTime);
+	camTrans->position += camTrans->Left() * (CAMERA_SPEED * left * deltaTime);
+}
+
+//netplay, each player runs the game pointed at the other with the rollback netcode. Off plays both paddles on this machine
+static constexpr bool NETWORK_PLAY = false;
+static constexpr uint32_t NETWORK_LOCAL_PLAYER = 0; //0 moves paddle 1, 1 moves paddle 2. The other machine uses the other one
+static constexpr uint16_t NETWORK_LOCAL_PORT = 27015;
+static const char* NETWORK_REMOTE_ADDRESS = "127.0.0.1";
+static constexpr uint16_t NETWORK_REMOTE_PORT = 27016;
+static constexpr uint32_t NETWORK_INPUT_DELAY_TICKS = 2;
 
 //entry point
 int main()
 {
 	//--init
 
+	PONG3D_PROFILE_THREAD("Main");
+#if PONG3D_PROFILING
+	Pong3D::Profiling::CPUProfiler_MeasureZoneOverhead(); //shown in the profiler overlay and saved with the trace
+#endif
+
 	//initalize the engine and create a window
 	Pong3D::Core::Engine engine;
-	if (!engine.Init())
+	Pong3D::Core::Engine_CreateInfo engineInfo;
+	engineInfo.swapchain.presentMode = PRESENT_MODE;
+	if (!engine.Init(engineInfo))
 	{
 		engine.Shutdown();
 		getchar();
@@ -124,29 +176,58 @@ int main()
 
 	//initalize render stuff
 	Pong3D::Renderer::FrameRenderManager renderManager;
-	renderManager.Init(&engine);
+	renderManager.Init(&engine, 2, RENDER_RECORD_MODE);
 	renderManager.TyGUI_Init();
+	renderManager.SetMaxQueuedFrames(LOW_LATENCY_MODE ? 1 : 0);
+	if (GPU_PROFILING)
+		renderManager.EnableGPUProfiling(32, GPU_PIPELINE_STATISTICS);
+
+	//the pipeline cache, saved between runs so pipelines the driver has seen before aren't compiled again
+	Pong3D::Renderer::PipelineCache pipelineCache;
+	if (!pipelineCache.Create(&engine.GPU, PIPELINE_CACHE_FILEPATH))
+		fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE RENDERER WARNING: main || Failed to create the pipeline cache, pipelines are compiled without one this run.\n");
+	Pong3D::Renderer::PipelineRegistry pipelineRegistry;
 
 	//registers assets
+	Pong3D::Renderer::PipelineSourceFiles meshPipelineFiles;
+	meshPipelineFiles.settings = "Pipelines/meshSettings." + Wireframe::Pipeline::Serilize::GetPipelineSettingExtentionStr();
+	meshPipelineFiles.pushConstant = "Pipelines/meshPushConstant." + Wireframe::Pipeline::PushConstant::GetExtentionStr();
+	meshPipelineFiles.vertexShader = "shaders/mesh_vertex." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr();
+	meshPipelineFiles.fragmentShader = "shaders/mesh_fragment." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr();
+
 	Smok::Asset::AssetManager::AssetManager AM;
 	uint64_t meshPipelineAssetID = AM.RegisterAsset_GraphicsPipeline("meshPipeline_Default",
-		BTD::IO::FileInfo("Pipelines/meshSettings." + Wireframe::Pipeline::Serilize::GetPipelineSettingExtentionStr()),
-		BTD::IO::FileInfo("shaders/mesh_vertex." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr()),
-		BTD::IO::FileInfo("shaders/mesh_fragment." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr())),
+		BTD::IO::FileInfo(meshPipelineFiles.settings),
+		BTD::IO::FileInfo(meshPipelineFiles.vertexShader),
+		BTD::IO::FileInfo(meshPipelineFiles.fragmentShader)),
 		
 		meshPipelineLayoutAssetID = AM.RegisterAsset_PipelineLayout("meshPipelineLayout_Default",
-			BTD::IO::FileInfo("Pipelines/meshPushConstant." + Wireframe::Pipeline::PushConstant::GetExtentionStr())),
+			BTD::IO::FileInfo(meshPipelineFiles.pushConstant)),
 		
 		staticMeshAssetID = AM.RegisterAsset_StaticMesh("staticMesh_Default",
 			BTD::IO::FileInfo("assets/Guitar." + Smok::Asset::Mesh::Serilize::GetSmeshDeclFileExtensionStr()),
 			BTD::IO::FileInfo("assets/Guitar." + Smok::Asset::Mesh::Serilize::GetSmeshBinaryFileExtensionStr()));
 
-	//loads the basic pipeline
-	init_pipelines(AM.pipelineLayouts[meshPipelineLayoutAssetID], AM.pipelines[meshPipelineAssetID], renderManager.renderpass, &engine);
+	//the static mesh geometry, every mesh shares one vertex and one index buffer and is drawn by offset
+	Pong3D::Renderer::MeshPool meshPool;
+	meshPool.Create(engine._allocator, (uint32_t)Pong3D::Asset::SMESH_VERTEX_STRIDE, STATIC_MESH_POOL_MAX_VERTICES, STATIC_MESH_POOL_MAX_INDICES, VK_INDEX_TYPE_UINT16);
+	Pong3D::Renderer::MeshUploadBatcher meshUploadBatcher;
+	meshUploadBatcher.Init(&engine.GPU, engine._allocator);
+
+	//streams assets in on the loader threads, the frame loop uploads them as they're ready
+	Pong3D::Asset::AssetStreamer assetStreamer;
+	assetStreamer.Init(&meshPool, &meshUploadBatcher, ASSET_LOADER_THREAD_COUNT);
 
-	//load static mesh
-	AM.staticMeshes[staticMeshAssetID].LoadMesh();
-	AM.staticMeshes[staticMeshAssetID].InitalizeMesh(engine._allocator);
+	//builds the basic pipeline on a loader thread while the scene is set up, the mesh components reference it by asset ID
+	Pong3D::Asset::PipelineHandle meshPipelineHandle = assetStreamer.RequestPipeline([&]() {
+		return Pong3D::Renderer::InitMeshPipeline(AM.pipelineLayouts[meshPipelineLayoutAssetID], AM.pipelines[meshPipelineAssetID], meshPipelineFiles,
+			pipelineRegistry, renderManager.renderpass, &engine, pipelineCache.cache);
+		});
+
+	//requests static meshes from their binary files, the asset manager keeps the IDs the mesh components use
+	//the meshes can be batched right away, they're drawn once they've streamed in
+	std::unordered_map<uint64_t, Pong3D::Renderer::PooledMesh*> pooledStaticMeshes;
+	pooledStaticMeshes[staticMeshAssetID] = assetStreamer.RequestMesh("assets/Guitar." + Pong3D::Asset::BinaryMesh_GetExtensionStr())->mesh;
 
 	//----scene
 	Pong3D::Scene::Scene scene;
@@ -164,7 +245,19 @@ int main()
 
 	transform.position = { 0.0f, 0.0f, 7.0f };
 
-	scene.CreateEntity_Paddle("Paddle 1", transform, entity_meshRenderComp, &engine);
+	Pong3D::Scene::Entity paddle1 = scene.CreateEntity_Paddle("Paddle 1", transform, entity_meshRenderComp, &engine);
+
+	//the physics world, the paddles and balls are simulated in it and written back into the scene each frame
+	Pong3D::Physics::PhysicsWorld physicsWorld;
+	physicsWorld.Create();
+
+	PlayerInputComponent paddle1Input;
+	paddle1Input.upKey = SDL_SCANCODE_UP; paddle1Input.downKey = SDL_SCANCODE_DOWN; //WASD moves the camera
+	paddle1Input.controller = 0;
+	paddle1Input.paddleIndex = (uint32_t)physicsWorld.paddles.Add(paddle1.ID, transform.position, PADDLE_HALF_EXTENTS);
+	if (NETWORK_PLAY)
+		paddle1Input.paddleIndex = NETWORK_LOCAL_PLAYER; //the arrow keys move this machine's paddle
+	BTD::ECS::addComponent(paddle1.ID, paddle1Input);
 
 	//entity paddle P2
 	entity_meshRenderComp = Smok::ECS::Comp::MeshRender();
@@ -174,147 +267,393 @@ int main()
 
 	transform.position = { 0.0f, 5.0f, 7.0f };
 
-	scene.CreateEntity_Paddle("Paddle 2", transform, entity_meshRenderComp, &engine);
+	Pong3D::Scene::Entity paddle2 = scene.CreateEntity_Paddle("Paddle 2", transform, entity_meshRenderComp, &engine);
+	const uint32_t paddle2Index = (uint32_t)physicsWorld.paddles.Add(paddle2.ID, transform.position, PADDLE_HALF_EXTENTS);
+
+	//a second controller moves paddle 2 when both players are on this machine
+	if (!NETWORK_PLAY)
+	{
+		PlayerInputComponent paddle2Input;
+		paddle2Input.upKey = SDL_SCANCODE_UNKNOWN; paddle2Input.downKey = SDL_SCANCODE_UNKNOWN;
+		paddle2Input.controller = 1;
+		paddle2Input.paddleIndex = paddle2Index;
+		BTD::ECS::addComponent(paddle2.ID, paddle2Input);
+	}
+
+	//the ball, and the stress test balls scattered around the arena
+	transform.position = { 0.0f, 2.5f, 3.0f };
+	Pong3D::Scene::Entity ball = scene.CreateEntity_Ball(transform, entity_meshRenderComp, "Ball");
+	physicsWorld.balls.Add(ball.ID, transform.position, glm::vec3(3.0f, 4.0f, 6.0f), BALL_RADIUS);
+
+	physicsWorld.balls.Reserve(PHYSICS_STRESS_BALL_COUNT + 1);
+	for (uint32_t i = 0; i < PHYSICS_STRESS_BALL_COUNT; ++i)
+	{
+		const float t = (float)i;
+		transform.position = { std::sin(t * 1.3f) * 8.0f, std::cos(t * 0.7f) * 6.0f, 7.0f + std::sin(t * 2.1f) * 6.0f };
+		Pong3D::Scene::Entity stressBall = scene.CreateEntity_Ball(transform, entity_meshRenderComp);
+		physicsWorld.balls.Add(stressBall.ID, transform.position, glm::vec3(std::cos(t) * 6.0f, std::sin(t * 1.7f) * 6.0f, std::cos(t * 0.3f) * 6.0f), BALL_RADIUS);
+	}
+
+	//benchmark scene, a grid of Guitars behind the paddles
+	for (uint32_t i = 0; i < BENCHMARK_GUITAR_INSTANCE_COUNT; ++i)
+	{
+		transform.position = { (float)(i % 100) * 3.0f - 150.0f, (float)((i / 100) % 100) * 3.0f - 150.0f, 20.0f + (float)(i / 10000) * 5.0f };
+		scene.CreateEntity_Paddle("Benchmark Guitar " + std::to_string(i), transform, entity_meshRenderComp, &engine);
+	}
 
 	//goes through the scene and generate the render operations
 	std::deque<Pong3D::Renderer::RenderOperationBatch> renderOperationBatchs;
 	Pong3D::Renderer::RenderOperationBatch* batch = &renderOperationBatchs.emplace_back(Pong3D::Renderer::RenderOperationBatch());
+	batch->InitInstanceBuffers(engine._allocator, renderManager.framesInFlightCount);
 
-	auto comps = BTD::ECS::queryEntities<Smok::ECS::Comp::Transform, Smok::ECS::Comp::MeshRender>();
-	for (size_t i = 0; i < comps.size(); ++i)
+	//the GPU driven path
+	Pong3D::Renderer::GPUCullingPass gpuCullingPass;
+	if (GPU_DRIVEN_RENDERING)
 	{
-		transform = *BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(comps[i]);
-		Smok::ECS::Comp::MeshRender mr = *BTD::ECS::getComponent<Smok::ECS::Comp::MeshRender>(comps[i]);
-		batch->AddStaticMesh(&AM.pipelineLayouts[mr.pipelineLayoutID].asset, &AM.pipelines[mr.pipelineID].asset,
-			&AM.staticMeshes[mr.staticMeshID].asset, transform);
+		Wireframe::Shader::Serilize::ShaderSerilizeData cullShader;
+		Wireframe::Shader::Serilize::LoadShaderDataFromFile(BTD::IO::FileInfo("shaders/cull_compute." + Wireframe::Shader::Serilize::ShaderSerilizeData::GetExtentionStr()),
+			cullShader, false);
+		if (gpuCullingPass.Create(&engine.GPU, engine._allocator, cullShader.binaryFilepath, 64, pipelineCache.cache))
+			batch->EnableGPUCulling(&gpuCullingPass);
+	}
+
+	//the CPU culling path
+	if (CPU_CULLING)
+		batch->EnableCPUCulling(MAX_DRAW_DISTANCE);
+
+	//the batches need the pipeline, it was built alongside the scene, the batch and the cull pipeline
+	std::unordered_map<uint64_t, Pong3D::Renderer::PipelineState> pipelineStates;
+	if (meshPipelineHandle->Wait())
+		pipelineStates[meshPipelineAssetID] = meshPipelineHandle->pipelineState;
+	fmt::print("Pipelines: {} created, {} shared. Pipeline cache: {} bytes loaded{}\n", pipelineRegistry.stats.pipelinesCreated, pipelineRegistry.stats.pipelinesShared,
+		pipelineCache.stats.loadedBytes, (pipelineCache.stats.wasRejected ? " (the saved cache was for another device)" : ""));
+
+	//walks the renderables a chunk at a time
+	for (size_t c = 0; c < scene.renderables.chunksInUse; ++c)
+	{
+		const Pong3D::ECS::RenderableChunk* chunk = scene.renderables.chunks[c].get();
+		for (uint32_t i = 0; i < chunk->count; ++i)
+		{
+			auto mesh = pooledStaticMeshes.find(chunk->staticMeshIDs[i]);
+			auto pipelineState = pipelineStates.find(chunk->pipelineIDs[i]);
+			if (mesh == pooledStaticMeshes.end() || pipelineState == pipelineStates.end())
+				continue;
+
+			batch->AddStaticMesh(pipelineState->second.layout, pipelineState->second.pipeline,
+				mesh->second, chunk->entityIDs[i], chunk->ModelMatrix(i));
+		}
 	}
 
 	//gets the main camera
-	Smok::ECS::Comp::Transform* camTrans = BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(scene.cameras[0].ID);
-	Smok::ECS::Comp::Camera* cam = BTD::ECS::getComponent<Smok::ECS::Comp::Camera>(scene.cameras[0].ID);
+	Smok::ECS::Comp::Transform* camTrans = BTD::ECS::getComponent<Smok::ECS::Comp::Transform>(scene.Camera_GetMain().ID);
+	Smok::ECS::Comp::Camera* cam = BTD::ECS::getComponent<Smok::ECS::Comp::Camera>(scene.Camera_GetMain().ID);
+
+	//the per frame view data and the recorder for the batches
+	Pong3D::Renderer::ViewFrameConstants viewConstants;
+	Pong3D::Renderer::BatchRecorder batchRecorder;
 
 	//--game loop
 	BTD::Time::Time time(60.0f);
-	SDL_Event e;
+
+	//the physics steps on its own thread from here on, the main thread only sends it input and draws its snapshots
+	Pong3D::Physics::SimulationThread_CreateInfo simulationInfo;
+	simulationInfo.fixedDeltaTime = time.GetFixedDeltaTime();
+	simulationInfo.paddleSpeed = PADDLE_SPEED;
+
+	//the keyboard and controllers are sampled into a queue the simulation thread applies by each tick's time, the bindings come from the input components
+	//the queue is kept on the heap, it's too big for the stack
+	std::unique_ptr<Pong3D::Input::InputQueue> simulationInputQueue = std::make_unique<Pong3D::Input::InputQueue>();
+	Pong3D::Input::InputSampler inputSampler;
+	inputSampler.Create(simulationInputQueue.get());
+	simulationInfo.inputQueue = simulationInputQueue.get();
+
+	//the input components don't change after the scene is built, so they're only queried once
+	const auto inputEntities = BTD::ECS::queryEntities<PlayerInputComponent>();
+	for (size_t i = 0; i < inputEntities.size(); ++i)
+	{
+		const PlayerInputComponent* input = BTD::ECS::getComponent<PlayerInputComponent>(inputEntities[i]);
+		Pong3D::Input::PaddleBinding binding;
+		binding.paddleIndex = input->paddleIndex;
+		binding.upKey = (uint16_t)input->upKey; binding.downKey = (uint16_t)input->downKey;
+		binding.controller = input->controller;
+		simulationInfo.inputBindings.emplace_back(binding);
+	}
+
+	//the netplay session, the simulation thread steps the world through it
+	Pong3D::Network::RollbackSession rollbackSession;
+	if (NETWORK_PLAY)
+	{
+		Pong3D::Network::RollbackSession_CreateInfo sessionInfo;
+		sessionInfo.localPlayer = NETWORK_LOCAL_PLAYER;
+		sessionInfo.localPort = NETWORK_LOCAL_PORT;
+		sessionInfo.remoteAddress = Pong3D::Network::NetAddress::FromString(NETWORK_REMOTE_ADDRESS, NETWORK_REMOTE_PORT);
+		sessionInfo.inputDelayTicks = NETWORK_INPUT_DELAY_TICKS;
+		sessionInfo.fixedDeltaTime = simulationInfo.fixedDeltaTime;
+		sessionInfo.paddleSpeed = PADDLE_SPEED;
+		if (rollbackSession.Create(sessionInfo))
+			simulationInfo.rollbackSession = &rollbackSession;
+		else
+			fmt::print(fmt::fg(fmt::color::yellow), "PS ENGINE NETWORK WARNING: main || Failed to start the netplay session, playing locally.\n");
+	}
+
+	Pong3D::Physics::SimulationThread simulationThread;
+	if (!simulationThread.Start(&physicsWorld, simulationInfo))
+	{
+		inputSampler.Destroy();
+		rollbackSession.Destroy();
+		engine.Shutdown();
+		getchar();
+		return -1;
+	}
+	uint64_t interpolatedTransformCount = 0;
+
 	bool bQuit = false;
 	bool stop_rendering = false;
-	BTD::Input::KeyInput keyInputData;
-	while (window->isRunning)
-	{
-		//--cal deltas
-		time.Update();
 
-		//--input
+	//handles the window's events, the sampler hands over every event after taking the input out of it
+	const auto handleEvent = [&](SDL_Event& e) {
+		//close the window when user alt-f4s or clicks the X button			
+		if (e.type == SDL_QUIT) bQuit = true;
 
-		//Handle events on queue
-		while (SDL_PollEvent(&e) != 0)
-		{
-			//close the window when user alt-f4s or clicks the X button			
-			if (e.type == SDL_QUIT) bQuit = true;
-
-			//window minimize or unminimize
-			if (e.type == SDL_WINDOWEVENT) {
-
-				if (e.window.event == SDL_WINDOWEVENT_MINIMIZED)
-				{
-					window->isMinimized = true;
-					stop_rendering = true;
-				}
-
-				if (e.window.event == SDL_WINDOWEVENT_RESTORED)
-				{
-					window->isMinimized = false;
-					stop_rendering = false;
-				}
+		//dumps the CPU profiler's trace
+		if (e.type == SDL_KEYDOWN && e.key.keysym.scancode == SDL_SCANCODE_F9)
+			PONG3D_PROFILE_WRITE_TRACE(CPU_TRACE_FILEPATH);
+
+		//window minimize or unminimize
+		if (e.type == SDL_WINDOWEVENT) {
+
+			if (e.window.event == SDL_WINDOWEVENT_MINIMIZED)
+			{
+				window->isMinimized = true;
+				stop_rendering = true;
 			}
 
-			//sends input to the widgets
-			if (renderManager.TyGUIIsInitalized && renderManager.TyGUIWidgetsShouldRender)
-				renderManager.widgetRenderer.SendInputData(&e);
+			if (e.window.event == SDL_WINDOWEVENT_RESTORED)
+			{
+				window->isMinimized = false;
+				stop_rendering = false;
+				renderManager.RequestSwapchainRecreate();
+			}
+
+			//the swapchain no longer matches the window
+			if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+				renderManager.RequestSwapchainRecreate();
 		}
 
-		if (bQuit) //quits app
+		//sends input to the widgets
+		if (renderManager.TyGUIIsInitalized && renderManager.TyGUIWidgetsShouldRender)
+			renderManager.widgetRenderer.SendInputData(&e);
+		};
+
+	//the input to photon estimate, a refresh is added for the present to reach the screen
+	SDL_DisplayMode displayMode;
+	const float displayRefreshMS = (SDL_GetCurrentDisplayMode(0, &displayMode) == 0 && displayMode.refresh_rate > 0 ?
+		1000.0f / (float)displayMode.refresh_rate : 1000.0f / 60.0f);
+	Pong3D::Input::InputLatencyStats inputLatency;
+	std::chrono::steady_clock::time_point latchedPressTime;
+	bool hasLatchedPress = false;
+
+	//the batches upload and cull before the render pass starts, made once so the frame doesn't allocate a callback
+	//the camera is late latched here, the input is sampled again once the frame's slot is free so the view is as fresh as it can be when it's recorded
+	std::chrono::steady_clock::time_point lastCameraLatchTime = std::chrono::steady_clock::now();
+	const std::function<void(Pong3D::Renderer::Frame&)> prepareBatches = [&](Pong3D::Renderer::Frame& startedFrame) {
 		{
-			window->isRunning = false;
-			break;
+			PONG3D_PROFILE_ZONE("Camera Late Latch");
+			inputSampler.Sample(handleEvent);
+			if (inputSampler.TakeNewestPress(latchedPressTime))
+				hasLatchedPress = true;
+
+			//a long stall, like being minimized, doesn't fling the camera
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			const float deltaTime = std::min(std::chrono::duration<float>(now - lastCameraLatchTime).count(), 0.1f);
+			lastCameraLatchTime = now;
+			Camera_Move(camTrans, inputSampler.state, deltaTime);
+
+			//updates the cameras if they're bound to the screen
+			cam->renderSize = { (float)engine.window._windowExtent.width, (float)engine.window._windowExtent.height };
+
+			//generates the view constants once for the frame, every batch shares them
+			viewConstants.Generate(camTrans, cam);
 		}
 
-		keyInputData.UpdateInputData();
+		batchRecorder.Prepare(startedFrame, renderOperationBatchs, viewConstants);
+		};
 
-		//gets all input components and their trans components
+	uint64_t lastFrameAllocationCount = 0, frameStartAllocationCount = Pong3D::Memory::AllocationCounter_Get();
+	Pong3D::Renderer::FrameLimiter frameLimiter;
+	float maxFPS = MAX_FPS;
+	while (window->isRunning)
+	{
+		PONG3D_PROFILE_ZONE("Frame");
 
-		//input for moving the camera
-		if (keyInputData.IsKeyHeld(SDL_SCANCODE_W))
+		//paces the loop, a minimized window has no swapchain to do it
 		{
-			camTrans->isDirty = true;
-			camTrans->position += camTrans->Forward() * (-15.0f * time.GetFixedDeltaTime());
+			PONG3D_PROFILE_ZONE("Frame Limiter");
+			frameLimiter.Wait(stop_rendering ? MINIMIZED_FPS : maxFPS);
 		}
 
-		else if (keyInputData.IsKeyHeld(SDL_SCANCODE_S))
-		{
-			camTrans->isDirty = true;
-			camTrans->position += camTrans->Forward() * (15.0f * time.GetFixedDeltaTime());
-		}
+		//the allocations the last frame made
+		const uint64_t allocationCount = Pong3D::Memory::AllocationCounter_Get();
+		lastFrameAllocationCount = allocationCount - frameStartAllocationCount;
+		frameStartAllocationCount = allocationCount;
 
-		else if (keyInputData.IsKeyHeld(SDL_SCANCODE_A))
-		{
-			camTrans->isDirty = true;
-			camTrans->position += camTrans->Left() * (15.0f * time.GetFixedDeltaTime());
-		}
+		//--input
+
+		//samples the input, the paddles' goes to the simulation thread and the camera's is latched when the frame starts
+		inputSampler.Sample(handleEvent);
 
-		else if (keyInputData.IsKeyHeld(SDL_SCANCODE_D))
+		if (bQuit) //quits app
 		{
-			camTrans->isDirty = true;
-			camTrans->position += camTrans->Left() * (-15.0f * time.GetFixedDeltaTime());
+			window->isRunning = false;
+			break;
 		}
 
 		//--update
 
-		while (time.ShouldUpdate()) {
-			// Perform fixed-timestep updates here (e.g., physics)
-			time.ConsumeAccumulator();
-		}
+		//takes the newest snapshot and blends its last two steps, so the balls move smoothly whatever the frame rate
+		simulationThread.snapshots.Acquire();
+		const Pong3D::Physics::SimulationSnapshot& simulationSnapshot = simulationThread.snapshots.GetReadBuffer();
+		if (simulationSnapshot.stepNumber > 0)
+			interpolatedTransformCount = Pong3D::Physics::Physics_WriteSnapshotToScene(simulationSnapshot,
+				simulationSnapshot.GetAlpha(std::chrono::steady_clock::now()), scene);
 
 		//--render
 
+		//moves the streaming assets along, a mesh that's finished uploading is drawn from this frame on
+		assetStreamer.Update();
+
+		//pushes the transforms that changed this frame into the batches
+		const uint64_t syncedTransformCount = Pong3D::Renderer::SyncDirtyTransforms(scene, renderOperationBatchs);
+
 		//do not draw if we are minimized
-		if (stop_rendering) {
-			//throttle the speed to avoid the endless spinning
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		if (stop_rendering)
 			continue;
-		}
 
 		//handles TyGUI widgets
 		if (renderManager.TyGUIIsInitalized && renderManager.TyGUIWidgetsShouldRender)
 		{
+			PONG3D_PROFILE_ZONE("TyGUI");
 			renderManager.widgetRenderer.StartFrame();
 
-			ImGui::Begin("OWO");
+			//frame pacing and GPU timing, tells if the frame is CPU or GPU bound
+			Pong3D::Renderer::ProfilerOverlay_Draw(renderManager);
+
+			ImGui::Begin("Scene");
+
+			ImGui::Text("Transforms Synced: %llu", (unsigned long long)syncedTransformCount);
+
+			//memory, the heap allocations of the last frame and how much of the frame arena it used
+			//the current slot's arena hasn't been filled yet this frame, the last frame used the slot before it
+			const uint32_t lastFrameSlot = (renderManager.currentFrameSlot + renderManager.framesInFlightCount - 1) % renderManager.framesInFlightCount;
+			const Pong3D::Memory::FrameArenaStats& arenaStats = renderManager.frameSlots[lastFrameSlot].arena.stats;
+			ImGui::Text("Heap Allocations: %llu last frame", (unsigned long long)lastFrameAllocationCount);
+			ImGui::Text("Frame Arena: %zu/%zu bytes (%zu most used, grown %llu times)", arenaStats.bytesUsed, arenaStats.capacity,
+				arenaStats.highWaterBytes, (unsigned long long)arenaStats.growCount);
+			ImGui::Text("Physics: %zu balls, %llu paddle hits and %llu wall bounces last step", simulationSnapshot.ballCount,
+				(unsigned long long)simulationSnapshot.stats.paddleHits, (unsigned long long)simulationSnapshot.stats.wallBounces);
+			ImGui::Text("Input: %llu events sampled (%llu dropped), %llu applied by the simulation", (unsigned long long)inputSampler.sampledEvents,
+				(unsigned long long)inputSampler.droppedEvents, (unsigned long long)simulationSnapshot.appliedInputEvents);
+			ImGui::Text("Input To Photon (worst case): %.2f ms last, %.2f ms avg, %.2f ms max", inputLatency.lastMS, inputLatency.averageMS, inputLatency.maxMS);
+
+			//presenting, the swapchain is recreated at the start of the next frame when the mode changes
+			int presentMode = (int)renderManager.swapchainSettings.presentMode;
+			for (int m = 0; m < (int)Pong3D::Platform::PresentMode::Count; ++m)
+			{
+				if (m > 0)
+					ImGui::SameLine();
+				ImGui::RadioButton(Pong3D::Platform::PresentMode_GetName((Pong3D::Platform::PresentMode)m), &presentMode, m);
+			}
+			if (presentMode != (int)renderManager.swapchainSettings.presentMode)
+				renderManager.SetPresentMode((Pong3D::Platform::PresentMode)presentMode);
+			bool isLowLatency = (renderManager.maxQueuedFrames == 1);
+			if (ImGui::Checkbox("Low Latency", &isLowLatency))
+				renderManager.SetMaxQueuedFrames(isLowLatency ? 1 : 0);
+			ImGui::SliderFloat("Max FPS (0 is uncapped)", &maxFPS, 0.0f, 500.0f, "%.0f");
+			ImGui::Text("Frame Limiter: %.3f ms held back, %llu late frames", frameLimiter.stats.lastWaitMS, (unsigned long long)frameLimiter.stats.lateFrames);
+			ImGui::Text("Simulation: step %llu, %llu dropped, %llu transforms interpolated", (unsigned long long)simulationSnapshot.stepNumber,
+				(unsigned long long)simulationThread.droppedSteps.load(std::memory_order_relaxed), (unsigned long long)interpolatedTransformCount);
+			if (simulationInfo.rollbackSession)
+			{
+				const Pong3D::Network::RollbackStats& rollbackStats = simulationSnapshot.rollbackStats;
+				ImGui::Text("Netplay: %llu rollbacks (%llu ticks, last %.3f ms), %llu stalls", (unsigned long long)rollbackStats.rollbacks,
+					(unsigned long long)rollbackStats.resimulatedTicks, rollbackStats.lastRollbackMS, (unsigned long long)rollbackStats.stalls);
+				ImGui::Text("    Packets: %llu sent, %llu received, %llu rejected", (unsigned long long)rollbackStats.packetsSent,
+					(unsigned long long)rollbackStats.packetsReceived, (unsigned long long)rollbackStats.packetsRejected);
+			}
+
+			//streaming, how many assets have loaded and how many are waiting on the staging buffer
+			ImGui::Text("Meshes Streamed: %llu/%llu (%llu failed, %llu waiting to stage)", (unsigned long long)assetStreamer.stats.meshesReady,
+				(unsigned long long)assetStreamer.stats.meshesRequested, (unsigned long long)assetStreamer.stats.meshesFailed,
+				(unsigned long long)assetStreamer.stats.meshesWaitingForStaging);
+			ImGui::Text("Mesh Uploads: %llu submissions, %llu bytes", (unsigned long long)meshUploadBatcher.stats.submissions,
+				(unsigned long long)meshUploadBatcher.stats.bytes);
+
+			//instancing, how many draws the batches recorded for how many instances
+			for (size_t i = 0; i < renderOperationBatchs.size(); ++i)
+			{
+				const Pong3D::Renderer::RenderOperationBatchStats& stats = renderOperationBatchs[i].stats;
+				ImGui::Text("Batch %zu: %llu draws, %llu instances", i, (unsigned long long)stats.drawCalls, (unsigned long long)stats.instances);
+				ImGui::Text("    Binds: %llu pipeline, %llu vertex buffer, %llu index buffer", (unsigned long long)stats.pipelineBinds,
+					(unsigned long long)stats.vertexBufferBinds, (unsigned long long)stats.indexBufferBinds);
+				ImGui::Text("    Instances Written: %llu", (unsigned long long)stats.instancesWritten);
+				if (renderOperationBatchs[i].IsCPUCullingActive())
+					ImGui::Text("    Visible Instances: %llu (%llu culled)", (unsigned long long)stats.visibleInstances, (unsigned long long)stats.culledInstances);
+				if (stats.gpuVisibleInstancesIsValid)
+					ImGui::Text("    GPU Visible Instances: %llu", (unsigned long long)stats.gpuVisibleInstances);
+			}
 
 			ImGui::End();
 		}
 
-		//updates the cameras if they're bound to the screen
-		cam->renderSize = { (float)engine.window._windowExtent.width, (float)engine.window._windowExtent.height };
+		//starts the frame, the camera is latched and the batches upload and cull before the render pass starts
+		Pong3D::Renderer::Frame frame = renderManager.StartFrame(prepareBatches);
 
-		//starts the frame
-		Pong3D::Renderer::Frame frame = renderManager.StartFrame();
+		//the swapchain couldn't give a image, it's recreated and the next frame tries again. The widgets' frame is closed unrendered
+		if (!frame.isValid)
+		{
+			if (renderManager.TyGUIIsInitalized && renderManager.TyGUIWidgetsShouldRender)
+				ImGui::EndFrame();
+			continue;
+		}
 
 		//performs renders
-		for (size_t i = 0; i < renderOperationBatchs.size(); ++i)
-			renderOperationBatchs[i].PerformRender(frame.cmd.handle, camTrans, cam);
+		batchRecorder.Record(renderManager, frame, renderOperationBatchs, viewConstants);
 
 		//submits the frame
 		renderManager.SubmitFrame(frame);
+
+		//the input to photon estimate of the newest press this frame latched, from the sample before it was pumped to the submit,
+		//then the GPU's time on the last frame it finished and a refresh for the present to be scanned out. A worst case, the press came in after that sample
+		if (hasLatchedPress)
+		{
+			const float submitMS = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - latchedPressTime).count();
+			const float gpuMS = (renderManager.gpuProfiler.lastResults.isValid ? (float)renderManager.gpuProfiler.lastResults.frameMS : 0.0f);
+			inputLatency.AddSample(submitMS + gpuMS + displayRefreshMS);
+			hasLatchedPress = false;
+		}
 	}
 	window = nullptr;
+	simulationThread.Stop();
+	inputSampler.Destroy();
+	rollbackSession.Destroy();
 	vkDeviceWaitIdle(engine.GPU.device); //make sure the gpu has stopped doing its things
 
 	//--clean up
+	for (size_t i = 0; i < renderOperationBatchs.size(); ++i)
+		renderOperationBatchs[i].DestroyInstanceBuffers();
+	if (gpuCullingPass.isCreated)
+		gpuCullingPass.Destroy();
+	assetStreamer.Shutdown();
+	meshUploadBatcher.Destroy();
+	meshPool.Destroy(engine._allocator);
+	pipelineCache.Save();
+	pipelineCache.Destroy();
 	AM.Destroy(engine._allocator, &engine.GPU);
 	renderManager.Shutdown();
 	engine.Shutdown();
 
+	PONG3D_PROFILE_WRITE_TRACE(CPU_TRACE_FILEPATH);
+
 	getchar();
 	return 0;
 }
\ No newline at end of file
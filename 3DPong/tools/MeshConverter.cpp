@@ -0,0 +1,150 @@
+//converts a .smeshdecl and .smesh pair into a single binary .pmesh
+//usage: MeshConverter <input.smeshdecl> <input.smesh> <output.pmesh> [--index32] [--no-checksum]
+
+#include <3DPong/Assets/BinaryMesh.hpp>
+#include <3DPong/Platform/MappedFile.hpp>
+
+#include <chrono>
+#include <sstream>
+
+//reads the index arrays out of the "meshes" field of a .smeshdecl, a array of arrays of integers
+//only the converter reads decls, the game gets everything it needs out of the .pmesh
+static bool ReadDeclIndices(const std::string& declText, std::vector<std::vector<uint32_t>>& subMeshIndices)
+{
+	subMeshIndices.clear();
+
+	size_t pos = declText.find("\"meshes\"");
+	if (pos == std::string::npos)
+		return false;
+	pos = declText.find('[', pos);
+	if (pos == std::string::npos)
+		return false;
+
+	//walks the nested arrays, depth 1 is the list of meshes and depth 2 is a mesh's indices
+	int depth = 0;
+	for (; pos < declText.size(); ++pos)
+	{
+		const char c = declText[pos];
+		if (c == '[')
+		{
+			depth++;
+			if (depth > 2)
+				return false;
+			if (depth == 2)
+				subMeshIndices.emplace_back();
+		}
+		else if (c == ']')
+		{
+			depth--;
+			if (depth == 0)
+				return true;
+		}
+		else if (depth == 2 && c >= '0' && c <= '9')
+		{
+			uint64_t value = 0;
+			while (pos < declText.size() && declText[pos] >= '0' && declText[pos] <= '9')
+			{
+				value = value * 10 + (uint64_t)(declText[pos++] - '0');
+				if (value > UINT32_MAX)
+					return false;
+			}
+			pos--;
+			subMeshIndices.back().emplace_back((uint32_t)value);
+		}
+		else if (c != ',' && c != ' ' && c != '\t' && c != '\r' && c != '\n')
+			return false;
+	}
+
+	return false;
+}
+
+//checks every index of a binary mesh is one of its vertices, the GPU would read past the mesh otherwise
+//the game doesn't walk the indices when it loads, so it's done here once when the file is written
+static bool ValidateIndices(const Pong3D::Asset::BinaryMeshView& view)
+{
+	const Pong3D::Asset::BinaryMeshHeader* header = view.header;
+	for (uint32_t i = 0; i < header->totalIndexCount; ++i)
+	{
+		const uint32_t index = (header->indexType == Pong3D::Asset::BinaryMeshIndexType::UInt16 ?
+			(uint32_t)((const uint16_t*)view.indexData)[i] : ((const uint32_t*)view.indexData)[i]);
+		if (index >= header->vertexCount)
+		{
+			fmt::print(fmt::fg(fmt::color::red), "Index {} is vertex {} but there are only {}!\n", i, index, header->vertexCount);
+			return false;
+		}
+	}
+	return true;
+}
+
+//entry point
+int main(int argc, char** argv)
+{
+	if (argc < 4)
+	{
+		fmt::print("usage: MeshConverter <input.smeshdecl> <input.smesh> <output.pmesh> [--index32] [--no-checksum]\n");
+		return -1;
+	}
+
+	const std::string declFilepath = argv[1], binaryFilepath = argv[2], outputFilepath = argv[3];
+	bool forceIndex32 = false, writeChecksum = true;
+	for (int i = 4; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (option == "--index32")
+			forceIndex32 = true;
+		else if (option == "--no-checksum")
+			writeChecksum = false;
+		else
+		{
+			fmt::print(fmt::fg(fmt::color::red), "Unknown option \"{}\"!\n", option);
+			return -1;
+		}
+	}
+
+	//reads the index arrays out of the decl
+	std::ifstream declFile(declFilepath);
+	if (!declFile.is_open())
+	{
+		fmt::print(fmt::fg(fmt::color::red), "Failed to open \"{}\"!\n", declFilepath);
+		return -1;
+	}
+	std::stringstream declText; declText << declFile.rdbuf();
+
+	std::vector<std::vector<uint32_t>> subMeshIndices;
+	if (!ReadDeclIndices(declText.str(), subMeshIndices))
+	{
+		fmt::print(fmt::fg(fmt::color::red), "\"{}\" has no readable \"meshes\" field!\n", declFilepath);
+		return -1;
+	}
+
+	//the vertices are written as is
+	Pong3D::Platform::MappedFile vertices;
+	if (!vertices.Open(binaryFilepath))
+		return -1;
+	if (vertices.size % Pong3D::Asset::SMESH_VERTEX_STRIDE != 0)
+	{
+		fmt::print(fmt::fg(fmt::color::red), "\"{}\" is {} bytes, which is not a whole number of {} byte vertices!\n", binaryFilepath, vertices.size, Pong3D::Asset::SMESH_VERTEX_STRIDE);
+		return -1;
+	}
+	const uint32_t vertexCount = (uint32_t)(vertices.size / Pong3D::Asset::SMESH_VERTEX_STRIDE);
+
+	if (!Pong3D::Asset::BinaryMesh_Write(outputFilepath, vertices.data, (uint32_t)Pong3D::Asset::SMESH_VERTEX_STRIDE, vertexCount, subMeshIndices, writeChecksum, forceIndex32))
+		return -1;
+
+	//reads it back the way the game does to make sure it loads and how long that takes, then checks the checksum and every index
+	Pong3D::Platform::MappedFile output;
+	const auto start = std::chrono::high_resolution_clock::now();
+	Pong3D::Asset::BinaryMeshView view;
+	if (!output.Open(outputFilepath) || !Pong3D::Asset::BinaryMesh_Read(output.data, output.size, view, false))
+		return -1;
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	Pong3D::Asset::BinaryMeshView checkedView;
+	if (!Pong3D::Asset::BinaryMesh_Read(output.data, output.size, checkedView, true) || !ValidateIndices(checkedView))
+		return -1;
+
+	fmt::print("Wrote \"{}\": {} vertices, {} sub meshes, {} {} bit indices, {} bytes\n", outputFilepath, view.header->vertexCount, view.header->subMeshCount,
+		view.header->totalIndexCount, view.IndexSize() * 8, output.size);
+	fmt::print("Mapped in {:.3f} ms\n", std::chrono::duration<double, std::milli>(end - start).count());
+	return 0;
+}
@@ -13,6 +13,10 @@ include "BTDSTD3"
 include "TyGUI"
 include "Smok"
 
+--rebuilds the SPIR-V in shaders/Compiled from the GLSL in shaders/Code, run from the 3DPong directory before the game and the render benchmark build
+--the compiled shaders always come from glslc, they're never written by hand
+SHADER_BUILD_COMMAND = (os.host() == "windows" and "python" or "python3") .. " shaders/CompileShaders.py shaders/Code shaders/Compiled"
+
 ---The game
 project "3DPong"
 location "3DPong"
@@ -60,6 +64,11 @@ links
 "Smok"
 }
 
+prebuildcommands
+{
+SHADER_BUILD_COMMAND,
+}
+
 
 defines
 {
@@ -146,4 +155,393 @@ defines
 flags
 {
 "LinkTimeOptimization",
-}
\ No newline at end of file
+}
+
+---a benchmark, a console app built from 3DPong/benchmarks/<name>.cpp with the headers, GLM and fmt
+---benchmarks that need more pass their extra include dirs and links
+function benchmarkProject(name, extraIncludeDirs, extraLinks)
+project (name)
+location "3DPong"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/" .. name)
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/" .. name)
+
+
+files 
+{
+"3DPong/benchmarks/" .. name .. ".cpp",
+}
+
+includedirs 
+{
+"3DPong/includes",
+
+"BTDSTD3/" .. GLM_INCLUDE,
+"BTDSTD3/" .. FMT_INCLUDE,
+}
+
+includedirs (extraIncludeDirs or {})
+links (extraLinks or {})
+
+
+defines
+{
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"FMT_HEADER_ONLY",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+
+--MSVC only
+filter "action:vs*"
+    buildoptions "/utf-8"
+
+
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+filter "system:mac"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+--configs
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"
+
+
+defines
+{
+"NDEBUG",
+}
+
+filter {}
+end
+
+---benchmarks the CPU frustum cull
+benchmarkProject("CullBenchmark")
+
+---converts .smesh and .smeshdecl pairs into binary .pmesh files
+project "MeshConverter"
+location "3DPong"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/MeshConverter")
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/MeshConverter")
+
+
+files 
+{
+"3DPong/tools/MeshConverter.cpp",
+}
+
+includedirs 
+{
+"3DPong/includes",
+
+BTD_INCLUDE,
+"BTDSTD3/" .. GLM_INCLUDE,
+"BTDSTD3/" .. FMT_INCLUDE,
+"BTDSTD3/" .. VK_BOOTSTRAP_INCLUDE,
+"BTDSTD3/" .. VOLK_INCLUDE,
+"BTDSTD3/" .. VMA_INCLUDE,
+VULKAN_SDK_MANUAL_OVERRIDE,
+
+"Smok/includes",
+}
+
+
+defines
+{
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"FMT_HEADER_ONLY",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+
+--MSVC only
+filter "action:vs*"
+    buildoptions "/utf-8"
+
+
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+filter "system:mac"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+--configs
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"
+
+---renders the Guitar benchmark scene headless and reports the frame times as JSON, for catching renderer regressions in CI
+project "RenderBenchmark"
+location "3DPong"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/RenderBenchmark")
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/RenderBenchmark")
+
+
+files 
+{
+"3DPong/benchmarks/RenderBenchmark.cpp",
+}
+
+includedirs 
+{
+"3DPong/includes",
+
+BTD_INCLUDE,
+"BTDSTD3/" .. GLM_INCLUDE,
+"BTDSTD3/" .. FMT_INCLUDE,
+"BTDSTD3/" .. SDL_INCLUDE,
+
+"BTDSTD3/" .. VK_BOOTSTRAP_INCLUDE,
+"BTDSTD3/" .. STB_INCLUDE,
+"BTDSTD3/" .. VOLK_INCLUDE,
+"BTDSTD3/" .. VMA_INCLUDE,
+VULKAN_SDK_MANUAL_OVERRIDE,
+
+"TyGUI/includes",
+"TyGUI/" .. IMGUI_INCLUDE,
+
+"Smok/includes",
+}
+
+links
+{
+"TyGUI",
+"Smok"
+}
+
+prebuildcommands
+{
+SHADER_BUILD_COMMAND,
+}
+
+
+defines
+{
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"GLM_ENABLE_EXPERIMENTAL",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+
+--MSVC only
+filter "action:vs*"
+    buildoptions "/utf-8"
+
+
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+
+defines
+{
+"Window_Build",
+"VK_USE_PLATFORM_WIN32_KHR",
+"Desktop_Build",
+}
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+
+defines
+{
+"Linux_Build",
+"VK_USE_PLATFORM_XLIB_KHR",
+"Desktop_Build",
+}
+
+filter "system:mac"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+
+defines
+{
+"MacOS_Build",
+"VK_USE_PLATFORM_MACOS_MVK",
+"Desktop_Build",
+}
+
+--configs
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"
+
+
+defines
+{
+"NDEBUG",
+}
+
+
+---benchmarks walking the renderable entities through the ECS query and through the renderable archetype
+benchmarkProject("ECSBenchmark",
+{
+BTD_INCLUDE,
+"BTDSTD3/" .. VK_BOOTSTRAP_INCLUDE,
+"BTDSTD3/" .. VOLK_INCLUDE,
+"BTDSTD3/" .. VMA_INCLUDE,
+VULKAN_SDK_MANUAL_OVERRIDE,
+
+"Smok/includes",
+},
+{
+"Smok"
+})
+
+---benchmarks the Pong physics with more and more balls
+benchmarkProject("PhysicsBenchmark")
+
+---benchmarks building the renderer's per frame scratch lists on the heap and in the frame arena
+benchmarkProject("FrameArenaBenchmark")
+
+---plays two rollback sessions against each other on loopback and times rolling back the physics
+benchmarkProject("NetcodeBenchmark")
+
+---replicates 10k entities to a client in process and reports the bytes each costs a tick and the encode speed
+benchmarkProject("ReplicationBenchmark")
+
+---the dedicated server, hosts many matches with the rendering compiled out so it needs no Vulkan, SDL or GPU
+project "3DPongServer"
+location "3DPong"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/Server")
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/Server")
+
+
+files 
+{
+"3DPong/server/**.cpp",
+}
+
+includedirs 
+{
+"3DPong/includes",
+
+"BTDSTD3/" .. GLM_INCLUDE,
+"BTDSTD3/" .. FMT_INCLUDE,
+}
+
+
+defines
+{
+"PONG3D_SERVER",
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"FMT_HEADER_ONLY",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+--MSVC only
+filter "action:vs*"
+    buildoptions "/utf-8"
+
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+filter "system:mac"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+--configs
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"